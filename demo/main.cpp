@@ -551,203 +551,2527 @@ void encodeIndex(const Mesh& mesh)
 		    (result[i + 2] == mesh.indices[i + 0] && result[i + 0] == mesh.indices[i + 1] && result[i + 1] == mesh.indices[i + 2]));
 	}
 
+	double decode16 = 0;
+
 	if (mesh.vertices.size() <= 65536)
 	{
-		std::vector<unsigned short> result2(mesh.indices.size());
-		int res2 = meshopt_decodeIndexBuffer(&result2[0], mesh.indices.size(), &buffer[0], buffer.size());
-		assert(res2 == 0);
-		(void)res2;
+		std::vector<unsigned short> result2(mesh.indices.size());
+
+		double start16 = timestamp();
+
+		int res2 = meshopt_decodeIndexBuffer(&result2[0], mesh.indices.size(), &buffer[0], buffer.size());
+		assert(res2 == 0);
+		(void)res2;
+
+		decode16 = timestamp() - start16;
+
+		for (size_t i = 0; i < mesh.indices.size(); i += 3)
+		{
+			assert(result[i + 0] == result2[i + 0] && result[i + 1] == result2[i + 1] && result[i + 2] == result2[i + 2]);
+		}
+	}
+
+	printf("IdxCodec : %.1f bits/triangle (post-deflate %.1f bits/triangle); encode %.2f msec, decode %.2f msec (%.2f GB/s), decode16 %.2f msec (%.2f GB/s)\n",
+	       double(buffer.size() * 8) / double(mesh.indices.size() / 3),
+	       double(csize * 8) / double(mesh.indices.size() / 3),
+	       (middle - start) * 1000,
+	       (end - middle) * 1000,
+	       (double(result.size() * 4) / (1 << 30)) / (end - middle),
+	       decode16 * 1000,
+	       decode16 > 0 ? (double(result.size() * 2) / (1 << 30)) / decode16 : 0.0);
+}
+
+void encodeIndexLevels(const Mesh& mesh)
+{
+	std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(mesh.indices.size(), mesh.vertices.size()));
+
+	printf("IdxLevels:");
+
+	for (int level = 0; level <= 1; ++level)
+	{
+		double start = timestamp();
+
+		size_t size = meshopt_encodeIndexBufferLevel(&buffer[0], buffer.size(), &mesh.indices[0], mesh.indices.size(), level);
+
+		double end = timestamp();
+
+		printf(" L%d %.2f bits/triangle (%.2f msec)%s", level,
+		       double(size * 8) / double(mesh.indices.size() / 3),
+		       (end - start) * 1000,
+		       level < 1 ? ";" : "\n");
+	}
+}
+
+void encodeIndexSequence(const std::vector<unsigned int>& data, size_t vertex_count, const char* name)
+{
+	// allocate result outside of the timing loop to exclude memset() from decode timing
+	std::vector<unsigned int> result(data.size());
+
+	double start = timestamp();
+
+	std::vector<unsigned char> buffer(meshopt_encodeIndexSequenceBound(data.size(), vertex_count));
+	buffer.resize(meshopt_encodeIndexSequence(&buffer[0], buffer.size(), &data[0], data.size()));
+
+	double middle = timestamp();
+
+	int res = meshopt_decodeIndexSequence(&result[0], data.size(), &buffer[0], buffer.size());
+	assert(res == 0);
+	(void)res;
+
+	double end = timestamp();
+
+	size_t csize = compress(buffer);
+
+	assert(result == data);
+
+	printf("IdxSeq%-3s: %.1f bits/index (post-deflate %.1f bits/index); encode %.2f msec, decode %.2f msec (%.2f GB/s)\n",
+	       name,
+	       double(buffer.size() * 8) / double(data.size()),
+	       double(csize * 8) / double(data.size()),
+	       (middle - start) * 1000,
+	       (end - middle) * 1000,
+	       (double(result.size() * 4) / (1 << 30)) / (end - middle));
+}
+
+void encodeIndexSequences(const Mesh& mesh)
+{
+	// note: input mesh is assumed to be optimized for vertex cache and vertex fetch
+	std::vector<unsigned int> strip(meshopt_stripifyBound(mesh.indices.size()));
+	strip.resize(meshopt_stripify(&strip[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size()));
+
+	std::vector<unsigned int> lines(mesh.indices.size() * 2);
+
+	for (size_t i = 0; i < mesh.indices.size(); i += 3)
+		for (int e = 0; e < 3; ++e)
+		{
+			lines[i * 2 + e * 2 + 0] = mesh.indices[i + e];
+			lines[i * 2 + e * 2 + 1] = mesh.indices[i + (e + 1) % 3];
+		}
+
+	encodeIndexSequence(strip, mesh.vertices.size(), "S");
+	encodeIndexSequence(lines, mesh.vertices.size(), "L");
+}
+
+void encodeIndexCoverage()
+{
+	// note: 4 6 5 triangle here is a combo-breaker:
+	// we encode it without rotating, a=next, c=next - this means we do *not* bump next to 6
+	// which means that the next triangle can't be encoded via next sequencing!
+	const unsigned int indices[] = {0, 1, 2, 2, 1, 3, 4, 6, 5, 7, 8, 9};
+	const size_t index_count = sizeof(indices) / sizeof(indices[0]);
+	const size_t vertex_count = 10;
+
+	std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(index_count, vertex_count));
+	buffer.resize(meshopt_encodeIndexBuffer(&buffer[0], buffer.size(), indices, index_count));
+
+	// check that encode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(i);
+		size_t result = meshopt_encodeIndexBuffer(i == 0 ? 0 : &shortbuffer[0], i, indices, index_count);
+		(void)result;
+
+		if (i == buffer.size())
+			assert(result == buffer.size());
+		else
+			assert(result == 0);
+	}
+
+	// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	unsigned int destination[index_count];
+	unsigned short destination16[index_count];
+
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+		int result = meshopt_decodeIndexBuffer(destination, index_count, i == 0 ? 0 : &shortbuffer[0], i);
+		int result16 = meshopt_decodeIndexBuffer(destination16, index_count, i == 0 ? 0 : &shortbuffer[0], i);
+		(void)result;
+		(void)result16;
+
+		if (i == buffer.size())
+			assert(result == 0 && result16 == 0);
+		else
+			assert(result < 0 && result16 < 0);
+	}
+
+	for (size_t i = 0; i < index_count; ++i)
+		assert(destination[i] == destination16[i]);
+
+	// check that decoder doesn't accept extra bytes after a valid stream
+	{
+		std::vector<unsigned char> largebuffer(buffer);
+		largebuffer.push_back(0);
+
+		int result = meshopt_decodeIndexBuffer(destination, index_count, &largebuffer[0], largebuffer.size());
+		(void)result;
+
+		assert(result < 0);
+	}
+
+	// check that decoder doesn't accept malformed headers
+	{
+		std::vector<unsigned char> brokenbuffer(buffer);
+		brokenbuffer[0] = 0;
+
+		int result = meshopt_decodeIndexBuffer(destination, index_count, &brokenbuffer[0], brokenbuffer.size());
+		(void)result;
+
+		assert(result < 0);
+	}
+}
+
+template <typename PV>
+void packVertex(const Mesh& mesh, const char* pvn)
+{
+	std::vector<PV> pv(mesh.vertices.size());
+	packMesh(pv, mesh.vertices);
+
+	size_t csize = compress(pv);
+
+	printf("VtxPack%s  : %.1f bits/vertex (post-deflate %.1f bits/vertex)\n", pvn,
+	       double(pv.size() * sizeof(PV) * 8) / double(mesh.vertices.size()),
+	       double(csize * 8) / double(mesh.vertices.size()));
+}
+
+template <typename PV>
+void encodeVertex(const Mesh& mesh, const char* pvn)
+{
+	std::vector<PV> pv(mesh.vertices.size());
+	packMesh(pv, mesh.vertices);
+
+	// allocate result outside of the timing loop to exclude memset() from decode timing
+	std::vector<PV> result(mesh.vertices.size());
+
+	double start = timestamp();
+
+	std::vector<unsigned char> vbuf(meshopt_encodeVertexBufferBound(mesh.vertices.size(), sizeof(PV)));
+	vbuf.resize(meshopt_encodeVertexBuffer(&vbuf[0], vbuf.size(), &pv[0], mesh.vertices.size(), sizeof(PV)));
+
+	double middle = timestamp();
+
+	int res = meshopt_decodeVertexBuffer(&result[0], mesh.vertices.size(), sizeof(PV), &vbuf[0], vbuf.size());
+	assert(res == 0);
+	(void)res;
+
+	double end = timestamp();
+
+	assert(memcmp(&pv[0], &result[0], pv.size() * sizeof(PV)) == 0);
+
+	size_t csize = compress(vbuf);
+
+	printf("VtxCodec%1s: %.1f bits/vertex (post-deflate %.1f bits/vertex); encode %.2f msec (%.0f MB/s), decode %.2f msec (%.2f GB/s, %s)\n", pvn,
+	       double(vbuf.size() * 8) / double(mesh.vertices.size()),
+	       double(csize * 8) / double(mesh.vertices.size()),
+	       (middle - start) * 1000,
+	       (double(result.size() * sizeof(PV)) / 1e6) / (middle - start),
+	       (end - middle) * 1000,
+	       (double(result.size() * sizeof(PV)) / (1 << 30)) / (end - middle),
+	       meshopt_decodeVertexBufferKernel());
+}
+
+void encodeVertexLevels(const Mesh& mesh)
+{
+	typedef PackedVertexOct PV;
+
+	std::vector<PV> pv(mesh.vertices.size());
+	packMesh(pv, mesh.vertices);
+
+	std::vector<unsigned char> vbuf(meshopt_encodeVertexBufferBound(mesh.vertices.size(), sizeof(PV)));
+
+	for (int version = 0; version <= 1; ++version)
+	{
+		meshopt_encodeVertexVersion(version);
+
+		printf("VtxLevels%d:", version);
+
+		for (int level = 0; level <= 3; ++level)
+		{
+			double start = timestamp();
+
+			size_t size = meshopt_encodeVertexBufferLevel(&vbuf[0], vbuf.size(), &pv[0], mesh.vertices.size(), sizeof(PV), level);
+
+			double end = timestamp();
+
+			printf(" L%d %.1f bits/vertex (%.0f MB/s)%s", level,
+			       double(size * 8) / double(mesh.vertices.size()),
+			       (double(pv.size() * sizeof(PV)) / 1e6) / (end - start),
+			       level < 3 ? ";" : "\n");
+		}
+	}
+
+	meshopt_encodeVertexVersion(0);
+}
+
+void splitVertex(const Mesh& mesh)
+{
+	typedef PackedVertexOct PV;
+
+	std::vector<PV> pv(mesh.vertices.size());
+	packMesh(pv, mesh.vertices);
+
+	std::vector<unsigned char> vbuf(meshopt_encodeVertexBufferBound(mesh.vertices.size(), sizeof(PV)));
+	vbuf.resize(meshopt_encodeVertexBuffer(&vbuf[0], vbuf.size(), &pv[0], mesh.vertices.size(), sizeof(PV)));
+
+	// positions and the remaining attributes go to separate streams, padded to 8 bytes per vertex
+	std::vector<unsigned char> positions(mesh.vertices.size() * 8);
+	std::vector<unsigned char> attributes(mesh.vertices.size() * 8);
+
+	const meshopt_VertexOutput outputs[] =
+	    {
+	        {offsetof(PV, px), 6, &positions[0], 8},
+	        {offsetof(PV, nu), 6, &attributes[0], 8},
+	    };
+
+	// allocate temporary buffer outside of the timing loop to exclude memset() from decode timing
+	std::vector<PV> temp(mesh.vertices.size());
+
+	double start = timestamp();
+
+	int res = meshopt_decodeVertexBuffer(&temp[0], mesh.vertices.size(), sizeof(PV), &vbuf[0], vbuf.size());
+	assert(res == 0);
+
+	for (size_t i = 0; i < mesh.vertices.size(); ++i)
+	{
+		memcpy(&positions[i * 8], &temp[i].px, 6);
+		memcpy(&attributes[i * 8], &temp[i].nu, 6);
+	}
+
+	double middle = timestamp();
+
+	res = meshopt_decodeVertexBufferSplit(outputs, sizeof(outputs) / sizeof(outputs[0]), mesh.vertices.size(), sizeof(PV), &vbuf[0], vbuf.size());
+	assert(res == 0);
+	(void)res;
+
+	double end = timestamp();
+
+	for (size_t i = 0; i < mesh.vertices.size(); ++i)
+	{
+		assert(memcmp(&positions[i * 8], &pv[i].px, 6) == 0);
+		assert(memcmp(&attributes[i * 8], &pv[i].nu, 6) == 0);
+	}
+
+	printf("VtxSplit: decode+copy %.2f msec, split %.2f msec (%.2f GB/s)\n",
+	       (middle - start) * 1000,
+	       (end - middle) * 1000,
+	       (double(pv.size() * sizeof(PV)) / (1 << 30)) / (end - middle));
+}
+
+static void sinkVertices(void* context, const void* vertices, size_t vertex_offset, size_t vertex_count)
+{
+	unsigned char* destination = static_cast<unsigned char*>(context);
+
+	memcpy(destination + vertex_offset * sizeof(PackedVertexOct), vertices, vertex_count * sizeof(PackedVertexOct));
+}
+
+static int sinkEntropy(void* context, const unsigned char* data, size_t size)
+{
+	return meshopt_vertexDecoderFeed(static_cast<meshopt_VertexDecoder*>(context), data, size);
+}
+
+void encodeEntropy(const Mesh& mesh)
+{
+	typedef PackedVertexOct PV;
+
+	std::vector<PV> pv(mesh.vertices.size());
+	packMesh(pv, mesh.vertices);
+
+	std::vector<unsigned char> vbuf(meshopt_encodeVertexBufferSeekableBound(mesh.vertices.size(), sizeof(PV)));
+	vbuf.resize(meshopt_encodeVertexBufferSeekable(&vbuf[0], vbuf.size(), &pv[0], mesh.vertices.size(), sizeof(PV)));
+
+	std::vector<unsigned char> ibuf(meshopt_encodeIndexBufferBound(mesh.indices.size(), mesh.vertices.size()));
+	ibuf.resize(meshopt_encodeIndexBuffer(&ibuf[0], ibuf.size(), &mesh.indices[0], mesh.indices.size()));
+
+	std::vector<unsigned char> vbufe(meshopt_encodeEntropyBound(vbuf.size()));
+	vbufe.resize(meshopt_encodeEntropy(&vbufe[0], vbufe.size(), &vbuf[0], vbuf.size()));
+
+	std::vector<unsigned char> ibufe(meshopt_encodeEntropyBound(ibuf.size()));
+	ibufe.resize(meshopt_encodeEntropy(&ibufe[0], ibufe.size(), &ibuf[0], ibuf.size()));
+
+	// allocate result outside of the timing loop to exclude memset() from decode timing
+	std::vector<PV> result(mesh.vertices.size());
+	std::vector<unsigned char> scratch(vbuf.size());
+
+	std::vector<void*> memory(meshopt_vertexDecoderSize(mesh.vertices.size(), sizeof(PV)) / sizeof(void*) + 1);
+
+	double start = timestamp();
+
+	int res = meshopt_decodeEntropy(&scratch[0], scratch.size(), &vbufe[0], vbufe.size());
+	assert(res == 0);
+	res = meshopt_decodeVertexBuffer(&result[0], mesh.vertices.size(), sizeof(PV), &scratch[0], scratch.size());
+	assert(res == 0);
+
+	double middle = timestamp();
+
+	// entropy decoding feeds blocks directly to the streaming vertex decoder so that the intermediate data stays in cache
+	meshopt_VertexDecoder* decoder = meshopt_vertexDecoderInit(&memory[0], memory.size() * sizeof(void*), mesh.vertices.size(), sizeof(PV), sinkVertices, &result[0]);
+
+	res = meshopt_decodeEntropyStream(vbuf.size(), &vbufe[0], vbufe.size(), sinkEntropy, decoder);
+	assert(res == 0);
+	res = meshopt_vertexDecoderFinish(decoder);
+	assert(res == 0);
+	(void)res;
+
+	double end = timestamp();
+
+	assert(memcmp(&pv[0], &result[0], pv.size() * sizeof(PV)) == 0);
+
+	printf("Entropy : vtx %.1f bits/vertex (post-deflate %.1f), idx %.1f bits/triangle (post-deflate %.1f); vtx decode separate %.2f msec, streamed %.2f msec (%.2f GB/s)\n",
+	       double(vbufe.size() * 8) / double(mesh.vertices.size()),
+	       double(compress(vbuf) * 8) / double(mesh.vertices.size()),
+	       double(ibufe.size() * 8) / double(mesh.indices.size() / 3),
+	       double(compress(ibuf) * 8) / double(mesh.indices.size() / 3),
+	       (middle - start) * 1000,
+	       (end - middle) * 1000,
+	       (double(pv.size() * sizeof(PV)) / (1 << 30)) / (end - middle));
+}
+
+void dequantizeVertex(const Mesh& mesh)
+{
+	typedef PackedVertexOct PV;
+
+	std::vector<PV> pv(mesh.vertices.size());
+	packMesh(pv, mesh.vertices);
+
+	std::vector<unsigned char> vbuf(meshopt_encodeVertexBufferBound(mesh.vertices.size(), sizeof(PV)));
+	vbuf.resize(meshopt_encodeVertexBuffer(&vbuf[0], vbuf.size(), &pv[0], mesh.vertices.size(), sizeof(PV)));
+
+	const meshopt_VertexAttribute attributes[] =
+	    {
+	        {meshopt_AttributeHalf, 3, offsetof(PV, px), offsetof(Vertex, px), {1, 1, 1, 1}, {0, 0, 0, 0}},
+	        {meshopt_AttributeOct8, 2, offsetof(PV, nu), offsetof(Vertex, nx), {1, 1, 1, 1}, {0, 0, 0, 0}},
+	        {meshopt_AttributeHalf, 2, offsetof(PV, tx), offsetof(Vertex, tx), {1, 1, 1, 1}, {0, 0, 0, 0}},
+	    };
+
+	// allocate result outside of the timing loop to exclude memset() from decode timing
+	std::vector<Vertex> result(mesh.vertices.size());
+
+	double start = timestamp();
+
+	int res = meshopt_decodeVertexBufferDequantize(&result[0], sizeof(Vertex), mesh.vertices.size(), sizeof(PV), attributes, sizeof(attributes) / sizeof(attributes[0]), &vbuf[0], vbuf.size());
+	assert(res == 0);
+	(void)res;
+
+	double end = timestamp();
+
+	float error = 0;
+
+	for (size_t i = 0; i < mesh.vertices.size(); ++i)
+	{
+		const Vertex& v = mesh.vertices[i];
+		const Vertex& r = result[i];
+
+		error = std::max(error, fabsf(v.nx - r.nx) + fabsf(v.ny - r.ny) + fabsf(v.nz - r.nz));
+	}
+
+	printf("VtxDequant: decode %.2f msec (%.2f GB/s), max normal error %.3f\n",
+	       (end - start) * 1000,
+	       (double(result.size() * sizeof(Vertex)) / (1 << 30)) / (end - start),
+	       error);
+}
+
+void encodeVertexCoverage()
+{
+	typedef PackedVertexOct PV;
+
+	const PV vertices[] =
+	    {
+	        {0, 0, 0, 0, 0, 0, 0},
+	        {300, 0, 0, 0, 0, 500, 0},
+	        {0, 300, 0, 0, 0, 0, 500},
+	        {300, 300, 0, 0, 0, 500, 500},
+	    };
+
+	const size_t vertex_count = 4;
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), vertices, vertex_count, sizeof(PV)));
+
+	// check that encode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(i);
+		size_t result = meshopt_encodeVertexBuffer(i == 0 ? 0 : &shortbuffer[0], i, vertices, vertex_count, sizeof(PV));
+		(void)result;
+
+		if (i == buffer.size())
+			assert(result == buffer.size());
+		else
+			assert(result == 0);
+	}
+
+	// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	PV destination[vertex_count];
+
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+		int result = meshopt_decodeVertexBuffer(destination, vertex_count, sizeof(PV), i == 0 ? 0 : &shortbuffer[0], i);
+		(void)result;
+
+		if (i == buffer.size())
+			assert(result == 0);
+		else
+			assert(result < 0);
+	}
+
+	// check that decoder doesn't accept extra bytes after a valid stream
+	{
+		std::vector<unsigned char> largebuffer(buffer);
+		largebuffer.push_back(0);
+
+		int result = meshopt_decodeVertexBuffer(destination, vertex_count, sizeof(PV), &largebuffer[0], largebuffer.size());
+		(void)result;
+
+		assert(result < 0);
+	}
+
+	// check that decoder doesn't accept malformed headers
+	{
+		std::vector<unsigned char> brokenbuffer(buffer);
+		brokenbuffer[0] = 0;
+
+		int result = meshopt_decodeVertexBuffer(destination, vertex_count, sizeof(PV), &brokenbuffer[0], brokenbuffer.size());
+		(void)result;
+
+		assert(result < 0);
+	}
+}
+
+static void dispatchReverse(void* context, void (*task)(void* task_context, size_t task_index), void* task_context, size_t task_count)
+{
+	// run tasks in reverse order to make sure decoding doesn't depend on the task order
+	for (size_t i = task_count; i > 0; --i)
+		task(task_context, i - 1);
+
+	++*static_cast<int*>(context);
+}
+
+static void fillCoverageVertices(std::vector<PackedVertexOct>& vertices)
+{
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		PackedVertexOct& v = vertices[i];
+		v.px = (unsigned short)(i * 7);
+		v.py = (unsigned short)(i * i);
+		v.pz = (unsigned short)(i / 3);
+		v.nu = (unsigned char)(i % 100);
+		v.nv = (unsigned char)(i % 37);
+		v.tx = (unsigned short)(i ^ 0x5555);
+		v.ty = (unsigned short)(i * 31);
+	}
+}
+
+void encodeVertexSeekableCoverage()
+{
+	typedef PackedVertexOct PV;
+
+	// enough vertices to get several decoding tasks with a partial block at the end
+	const size_t vertex_count = 5000;
+
+	std::vector<PV> vertices(vertex_count);
+	fillCoverageVertices(vertices);
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferSeekableBound(vertex_count, sizeof(PV)));
+	buffer.resize(meshopt_encodeVertexBufferSeekable(&buffer[0], buffer.size(), &vertices[0], vertex_count, sizeof(PV)));
+	assert(buffer.size() > 0);
+
+	std::vector<PV> destination(vertex_count);
+
+	// check that parallel decode handles seekable streams with and without a dispatcher
+	{
+		int dispatched = 0;
+
+		int result = meshopt_decodeVertexBufferParallel(&destination[0], vertex_count, sizeof(PV), &buffer[0], buffer.size(), dispatchReverse, &dispatched);
+		(void)result;
+
+		assert(result == 0);
+		assert(dispatched == 1);
+		assert(memcmp(&vertices[0], &destination[0], vertex_count * sizeof(PV)) == 0);
+
+		std::fill(destination.begin(), destination.end(), PV());
+
+		result = meshopt_decodeVertexBufferParallel(&destination[0], vertex_count, sizeof(PV), &buffer[0], buffer.size(), 0, 0);
+
+		assert(result == 0);
+		assert(memcmp(&vertices[0], &destination[0], vertex_count * sizeof(PV)) == 0);
+	}
+
+	// check that regular decode handles seekable streams
+	{
+		std::fill(destination.begin(), destination.end(), PV());
+
+		int result = meshopt_decodeVertexBuffer(&destination[0], vertex_count, sizeof(PV), &buffer[0], buffer.size());
+		(void)result;
+
+		assert(result == 0);
+		assert(memcmp(&vertices[0], &destination[0], vertex_count * sizeof(PV)) == 0);
+	}
+
+	// check that parallel decode falls back to serial decoding for regular streams
+	{
+		std::vector<unsigned char> regular(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+		regular.resize(meshopt_encodeVertexBuffer(&regular[0], regular.size(), &vertices[0], vertex_count, sizeof(PV)));
+
+		assert(regular.size() < buffer.size());
+
+		std::fill(destination.begin(), destination.end(), PV());
+
+		int dispatched = 0;
+
+		int result = meshopt_decodeVertexBufferParallel(&destination[0], vertex_count, sizeof(PV), &regular[0], regular.size(), dispatchReverse, &dispatched);
+		(void)result;
+
+		assert(result == 0);
+		assert(dispatched == 0);
+		assert(memcmp(&vertices[0], &destination[0], vertex_count * sizeof(PV)) == 0);
+	}
+
+	// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	for (size_t i = 0; i <= buffer.size(); i += (i < 64 || buffer.size() - i < 64) ? 1 : 61)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+
+		int dispatched = 0;
+
+		int result = meshopt_decodeVertexBufferParallel(&destination[0], vertex_count, sizeof(PV), i == 0 ? 0 : &shortbuffer[0], i, dispatchReverse, &dispatched);
+		(void)result;
+
+		if (i == buffer.size())
+			assert(result == 0);
+		else
+			assert(result < 0);
+	}
+
+	// check that decoder doesn't accept extra bytes after a valid stream
+	{
+		std::vector<unsigned char> largebuffer(buffer);
+		largebuffer.push_back(0);
+
+		int dispatched = 0;
+
+		int result = meshopt_decodeVertexBufferParallel(&destination[0], vertex_count, sizeof(PV), &largebuffer[0], largebuffer.size(), dispatchReverse, &dispatched);
+		(void)result;
+
+		assert(result < 0);
+	}
+
+	// check that decoder doesn't accept corrupted block offsets
+	for (size_t i = 0; i < 4; ++i)
+	{
+		std::vector<unsigned char> brokenbuffer(buffer);
+		brokenbuffer[1 + i * 4 + 1] ^= 1;
+
+		int dispatched = 0;
+
+		int result = meshopt_decodeVertexBufferParallel(&destination[0], vertex_count, sizeof(PV), &brokenbuffer[0], brokenbuffer.size(), dispatchReverse, &dispatched);
+		(void)result;
+
+		assert(result < 0);
+
+		result = meshopt_decodeVertexBuffer(&destination[0], vertex_count, sizeof(PV), &brokenbuffer[0], brokenbuffer.size());
+
+		assert(result < 0);
+	}
+}
+
+void encodeVertexParallelCoverage()
+{
+	typedef PackedVertexOct PV;
+
+	const size_t vertex_count = 5000;
+
+	std::vector<PV> vertices(vertex_count);
+	fillCoverageVertices(vertices);
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &vertices[0], vertex_count, sizeof(PV)));
+
+	// check that parallel encode produces the same output as serial encode with and without a dispatcher
+	for (int k = 0; k < 2; ++k)
+	{
+		int dispatched = 0;
+
+		std::vector<unsigned char> pbuffer(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+		pbuffer.resize(meshopt_encodeVertexBufferParallel(&pbuffer[0], pbuffer.size(), &vertices[0], vertex_count, sizeof(PV), k == 0 ? dispatchReverse : 0, &dispatched));
+
+		assert(pbuffer == buffer);
+		assert(dispatched == (k == 0));
+	}
+
+	// check that encode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	for (size_t i = 0; i <= buffer.size(); i += (i < 64 || buffer.size() - i < 64) ? 1 : 61)
+	{
+		std::vector<unsigned char> shortbuffer(i);
+
+		int dispatched = 0;
+
+		size_t result = meshopt_encodeVertexBufferParallel(i == 0 ? 0 : &shortbuffer[0], i, &vertices[0], vertex_count, sizeof(PV), dispatchReverse, &dispatched);
+		(void)result;
+
+		if (i == buffer.size())
+			assert(result == buffer.size());
+		else
+			assert(result == 0);
+	}
+}
+
+static float dequantizeHalfRef(unsigned short h)
+{
+	int exp = (h >> 10) & 31;
+	float mant = float(h & 1023);
+
+	if (exp == 31)
+	{
+		unsigned int bits = ((h & 0x8000) << 16) | 0x7f800000 | ((h & 1023) << 13);
+
+		float r;
+		memcpy(&r, &bits, 4);
+		return r;
+	}
+
+	float r = exp == 0 ? ldexpf(mant, -24) : ldexpf(mant + 1024, exp - 25);
+
+	return (h & 0x8000) ? -r : r;
+}
+
+static void dequantizeOctRef(float* result, float u, float v)
+{
+	float z = 1 - fabsf(u) - fabsf(v);
+	float x = z >= 0 ? u : (1 - fabsf(v)) * (u >= 0 ? 1 : -1);
+	float y = z >= 0 ? v : (1 - fabsf(u)) * (v >= 0 ? 1 : -1);
+	float l = sqrtf(x * x + y * y + z * z);
+
+	result[0] = x / l;
+	result[1] = y / l;
+	result[2] = z / l;
+}
+
+static bool closeEnough(float lhs, float rhs)
+{
+	return (lhs != lhs && rhs != rhs) || lhs == rhs || fabsf(lhs - rhs) <= 1e-5f * (1 + fabsf(rhs));
+}
+
+void encodeVertexDequantizeCoverage()
+{
+	typedef PackedVertex PV;
+
+	const size_t vertex_count = 1000;
+
+	std::vector<PV> vertices(vertex_count);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		PV& v = vertices[i];
+		v.px = (unsigned short)(i * 97);
+		v.py = (unsigned short)(65535 - i);
+		v.pz = (unsigned short)(i * i);
+		v.pw = 0;
+		v.nx = (unsigned char)(i * 3);
+		v.ny = (unsigned char)(128 + i);
+		v.nz = (unsigned char)(i / 7);
+		v.nw = (unsigned char)(255 - i);
+		v.tx = (unsigned short)(i * 65);
+		v.ty = (unsigned short)(i * 31 + 0x8000);
+	}
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &vertices[0], vertex_count, sizeof(PV)));
+
+	const meshopt_VertexAttribute attributes[] =
+	    {
+	        {meshopt_AttributeUnorm16, 3, 0, 0, {2, 3, 4, 1}, {1, 0, -1, 0}},
+	        {meshopt_AttributeSnorm8, 4, 8, 12, {1, 1, 1, 1}, {0, 0, 0, 0}},
+	        {meshopt_AttributeUnorm8, 1, 9, 28, {1, 1, 1, 1}, {0, 0, 0, 0}},
+	        {meshopt_AttributeSnorm16, 2, 12, 32, {1, 1, 1, 1}, {0, 0, 0, 0}},
+	        {meshopt_AttributeHalf, 2, 12, 40, {1, 1, 1, 1}, {0, 0, 0, 0}},
+	        {meshopt_AttributeOct8, 2, 8, 48, {1, 1, 1, 1}, {0, 0, 0, 0}},
+	        {meshopt_AttributeOct16, 2, 12, 60, {2, 2, 2, 1}, {1, 1, 1, 0}},
+	    };
+
+	const size_t stride = 72 / sizeof(float);
+
+	std::vector<float> result(vertex_count * stride);
+
+	int res = meshopt_decodeVertexBufferDequantize(&result[0], stride * sizeof(float), vertex_count, sizeof(PV), attributes, sizeof(attributes) / sizeof(attributes[0]), &buffer[0], buffer.size());
+	assert(res == 0);
+	(void)res;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const PV& v = vertices[i];
+		const float* r = &result[i * stride];
+
+		float expected[stride];
+
+		expected[0] = float(v.px) / 65535 * 2 + 1;
+		expected[1] = float(v.py) / 65535 * 3;
+		expected[2] = float(v.pz) / 65535 * 4 - 1;
+
+		const unsigned char* n = &v.nx;
+
+		for (int k = 0; k < 4; ++k)
+			expected[3 + k] = std::max(float((signed char)n[k]) / 127, -1.f);
+
+		expected[7] = float(v.ny) / 255;
+		expected[8] = std::max(float(short(v.tx)) / 32767, -1.f);
+		expected[9] = std::max(float(short(v.ty)) / 32767, -1.f);
+		expected[10] = dequantizeHalfRef(v.tx);
+		expected[11] = dequantizeHalfRef(v.ty);
+
+		dequantizeOctRef(&expected[12], expected[3], expected[4]);
+		dequantizeOctRef(&expected[15], expected[8], expected[9]);
+
+		for (int k = 15; k < 18; ++k)
+			expected[k] = expected[k] * 2 + 1;
+
+		for (size_t k = 0; k < stride; ++k)
+			assert(closeEnough(r[k], expected[k]));
+	}
+
+	// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	for (size_t i = 0; i <= buffer.size(); i += (i < 64 || buffer.size() - i < 64) ? 1 : 61)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+
+		int result2 = meshopt_decodeVertexBufferDequantize(&result[0], stride * sizeof(float), vertex_count, sizeof(PV), attributes, sizeof(attributes) / sizeof(attributes[0]), i == 0 ? 0 : &shortbuffer[0], i);
+		(void)result2;
+
+		if (i == buffer.size())
+			assert(result2 == 0);
+		else
+			assert(result2 < 0);
+	}
+}
+
+void encodeFilterCoverage()
+{
+	const size_t count = 1001; // exercises SIMD remainders
+
+	std::vector<float> normals(count * 4), quats(count * 4), floats(count * 3);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		float a = float(i) * 0.37f, b = float(i) * 1.91f;
+
+		float* n = &normals[i * 4];
+		n[0] = cosf(a) * sinf(b), n[1] = sinf(a) * sinf(b), n[2] = cosf(b), n[3] = (i & 1) ? 1.f : -1.f;
+
+		float* q = &quats[i * 4];
+		q[0] = cosf(a) * cosf(b), q[1] = sinf(a) * cosf(b), q[2] = cosf(a) * sinf(b), q[3] = sinf(a) * sinf(b);
+
+		float* f = &floats[i * 3];
+		f[0] = float(i) * 1000.f, f[1] = -float(i) / 7.f, f[2] = (i % 5 == 0) ? 0.f : 1e-3f;
+	}
+
+	// octahedral normals, 8-bit and 16-bit storage
+	for (int k = 0; k < 2; ++k)
+	{
+		size_t stride = k == 0 ? 4 : 8;
+		int bits = k == 0 ? 8 : 12;
+
+		std::vector<unsigned char> data(count * stride);
+		meshopt_encodeFilterOct(&data[0], count, stride, bits, &normals[0]);
+		meshopt_decodeFilterOct(&data[0], count, stride);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			float r[4];
+
+			for (int j = 0; j < 4; ++j)
+				r[j] = k == 0 ? float((signed char)data[i * 4 + j]) / 127 : float(reinterpret_cast<short*>(&data[0])[i * 4 + j]) / 32767;
+
+			const float* n = &normals[i * 4];
+
+			assert(fabsf(r[0] - n[0]) < 0.03f && fabsf(r[1] - n[1]) < 0.03f && fabsf(r[2] - n[2]) < 0.03f);
+			assert(r[3] == n[3]);
+			(void)n;
+		}
+	}
+
+	// quaternions; note that q and -q are equivalent
+	{
+		std::vector<short> data(count * 4);
+		meshopt_encodeFilterQuat(&data[0], count, 8, 12, &quats[0]);
+		meshopt_decodeFilterQuat(&data[0], count, 8);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float* q = &quats[i * 4];
+
+			float dot = 0;
+			for (int j = 0; j < 4; ++j)
+				dot += float(data[i * 4 + j]) / 32767 * q[j];
+
+			assert(fabsf(dot) > 0.999f);
+			(void)dot;
+		}
+	}
+
+	// shared exponent floats
+	{
+		std::vector<float> data(count * 3);
+		meshopt_encodeFilterExp(&data[0], count, 12, 15, &floats[0]);
+		meshopt_decodeFilterExp(&data[0], count, 12);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float* f = &floats[i * 3];
+			const float* r = &data[i * 3];
+
+			float maxf = std::max(fabsf(f[0]), std::max(fabsf(f[1]), fabsf(f[2])));
+
+			for (int j = 0; j < 3; ++j)
+				assert(fabsf(r[j] - f[j]) <= maxf / (1 << 13));
+
+			(void)r;
+		}
+	}
+}
+
+void encodeVertexRangeCoverage()
+{
+	typedef PackedVertexOct PV;
+
+	const size_t vertex_count = 3000;
+
+	std::vector<PV> vertices(vertex_count);
+	fillCoverageVertices(vertices);
+
+	std::vector<unsigned char> seekable(meshopt_encodeVertexBufferSeekableBound(vertex_count, sizeof(PV)));
+	seekable.resize(meshopt_encodeVertexBufferSeekable(&seekable[0], seekable.size(), &vertices[0], vertex_count, sizeof(PV)));
+
+	std::vector<unsigned char> regular(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	regular.resize(meshopt_encodeVertexBuffer(&regular[0], regular.size(), &vertices[0], vertex_count, sizeof(PV)));
+
+	// ranges that start and end inside blocks and at block boundaries (blocks have 256 vertices for 16-byte vertices)
+	const size_t ranges[][2] = {{0, 0}, {0, 1}, {0, 256}, {0, 3000}, {100, 50}, {200, 100}, {256, 512}, {255, 258}, {1000, 2000}, {2999, 1}, {2816, 184}};
+
+	for (size_t i = 0; i < sizeof(ranges) / sizeof(ranges[0]); ++i)
+	{
+		size_t first = ranges[i][0], count = ranges[i][1];
+
+		for (int k = 0; k < 2; ++k)
+		{
+			const std::vector<unsigned char>& buffer = k == 0 ? seekable : regular;
+
+			std::vector<PV> destination(count + 1);
+
+			int result = meshopt_decodeVertexBufferRange(&destination[0], first, count, vertex_count, sizeof(PV), &buffer[0], buffer.size());
+			(void)result;
+
+			assert(result == 0);
+			assert(count == 0 || memcmp(&vertices[first], &destination[0], count * sizeof(PV)) == 0);
+		}
+	}
+
+	// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	for (size_t i = 0; i <= seekable.size(); i += (i < 64 || seekable.size() - i < 64) ? 1 : 61)
+	{
+		std::vector<unsigned char> shortbuffer(seekable.begin(), seekable.begin() + i);
+		std::vector<PV> destination(vertex_count);
+
+		int result = meshopt_decodeVertexBufferRange(&destination[0], 0, vertex_count, vertex_count, sizeof(PV), i == 0 ? 0 : &shortbuffer[0], i);
+		(void)result;
+
+		if (i == seekable.size())
+			assert(result == 0);
+		else
+			assert(result < 0);
+	}
+
+	// check that decoder doesn't accept corrupted block offsets
+	for (size_t i = 0; i < 4; ++i)
+	{
+		std::vector<unsigned char> brokenbuffer(seekable);
+		brokenbuffer[1 + i * 4 + 1] ^= 1;
+
+		std::vector<PV> destination(vertex_count);
+
+		int result = meshopt_decodeVertexBufferRange(&destination[0], i * 256 + 10, 10, vertex_count, sizeof(PV), &brokenbuffer[0], brokenbuffer.size());
+		(void)result;
+
+		assert(result < 0);
+	}
+}
+
+static void sinkCopy(void* context, const void* vertices, size_t vertex_offset, size_t vertex_count)
+{
+	std::vector<PackedVertexOct>& destination = *static_cast<std::vector<PackedVertexOct>*>(context);
+
+	assert(vertex_offset + vertex_count <= destination.size());
+	memcpy(&destination[vertex_offset], vertices, vertex_count * sizeof(PackedVertexOct));
+}
+
+static int decodeVertexStream(std::vector<PackedVertexOct>& destination, const std::vector<unsigned char>& buffer, size_t chunk_size)
+{
+	typedef PackedVertexOct PV;
+
+	std::vector<void*> memory(meshopt_vertexDecoderSize(destination.size(), sizeof(PV)) / sizeof(void*) + 1);
+
+	meshopt_VertexDecoder* decoder = meshopt_vertexDecoderInit(&memory[0], memory.size() * sizeof(void*), destination.size(), sizeof(PV), sinkCopy, &destination);
+
+	for (size_t offset = 0; offset < buffer.size(); offset += chunk_size)
+	{
+		// copy each chunk to a separate allocation to make sure ASAN can verify buffer access
+		size_t size = buffer.size() - offset < chunk_size ? buffer.size() - offset : chunk_size;
+		std::vector<unsigned char> chunk(buffer.begin() + offset, buffer.begin() + offset + size);
+
+		int result = meshopt_vertexDecoderFeed(decoder, &chunk[0], size);
+		if (result != 0)
+			return result;
+	}
+
+	return meshopt_vertexDecoderFinish(decoder);
+}
+
+void encodeVertexStreamCoverage()
+{
+	typedef PackedVertexOct PV;
+
+	const size_t vertex_count = 3000;
+
+	std::vector<PV> vertices(vertex_count);
+	fillCoverageVertices(vertices);
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferSeekableBound(vertex_count, sizeof(PV)));
+	buffer.resize(meshopt_encodeVertexBufferSeekable(&buffer[0], buffer.size(), &vertices[0], vertex_count, sizeof(PV)));
+
+	// check that decoding works regardless of how the stream is split into chunks
+	const size_t chunk_sizes[] = {1, 3, 64, 1000, 4096, buffer.size()};
+
+	for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++i)
+	{
+		std::vector<PV> destination(vertex_count);
+
+		int result = decodeVertexStream(destination, buffer, chunk_sizes[i]);
+		(void)result;
+
+		assert(result == 0);
+		assert(memcmp(&vertices[0], &destination[0], vertex_count * sizeof(PV)) == 0);
+	}
+
+	// check that a block is decoded as soon as the stream reaches the next block plus the 32-byte bounds check padding
+	{
+		size_t next_offset = buffer[5] | (buffer[6] << 8) | (buffer[7] << 16) | (buffer[8] << 24);
+		assert(next_offset + 32 < buffer.size());
+
+		std::vector<PV> destination(vertex_count);
+		std::vector<void*> memory(meshopt_vertexDecoderSize(vertex_count, sizeof(PV)) / sizeof(void*) + 1);
+
+		meshopt_VertexDecoder* decoder = meshopt_vertexDecoderInit(&memory[0], memory.size() * sizeof(void*), vertex_count, sizeof(PV), sinkCopy, &destination);
+
+		int result = meshopt_vertexDecoderFeed(decoder, &buffer[0], next_offset + 31);
+		(void)result;
+
+		assert(result == 0);
+		assert(memcmp(&vertices[0], &destination[0], sizeof(PV)) != 0);
+
+		result = meshopt_vertexDecoderFeed(decoder, &buffer[next_offset + 31], 1);
+
+		assert(result == 0);
+		assert(memcmp(&vertices[0], &destination[0], 256 * sizeof(PV)) == 0);
+	}
+
+	// check that streaming decode is memory-safe and doesn't accept truncated streams
+	for (size_t i = 0; i < buffer.size(); i += (i < 64 || buffer.size() - i < 64) ? 1 : 61)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+		std::vector<PV> destination(vertex_count);
+
+		int result = decodeVertexStream(destination, shortbuffer, 100);
+		(void)result;
+
+		assert(result < 0);
+	}
+
+	// check that decoder doesn't accept extra bytes after a valid stream
+	{
+		std::vector<unsigned char> largebuffer(buffer);
+		largebuffer.push_back(0);
+
+		std::vector<PV> destination(vertex_count);
+
+		int result = decodeVertexStream(destination, largebuffer, 100);
+		(void)result;
+
+		assert(result < 0);
+	}
+
+	// check that decoder rejects regular streams since they can't be decoded incrementally
+	{
+		std::vector<unsigned char> regular(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+		regular.resize(meshopt_encodeVertexBuffer(&regular[0], regular.size(), &vertices[0], vertex_count, sizeof(PV)));
+
+		std::vector<PV> destination(vertex_count);
+
+		int result = decodeVertexStream(destination, regular, 100);
+		(void)result;
+
+		assert(result == -1);
+	}
+}
+
+void encodeVertexVersionCoverage()
+{
+	typedef PackedVertexOct PV;
+
+	const size_t vertex_count = 3000;
+
+	std::vector<PV> vertices(vertex_count);
+	fillCoverageVertices(vertices);
+
+	// float data benefits from 32-bit deltas, so it exercises modes that packed vertices don't use
+	std::vector<float> floats(vertex_count * 4);
+
+	for (size_t i = 0; i < floats.size(); ++i)
+		floats[i] = float(i / 4) * 0.25f + float(i % 4);
+
+	// unindexed triangle lists correlate with the same corner of the previous triangle, so level 3 should pick a delta distance of 3
+	std::vector<float> soup(vertex_count * 4);
+
+	for (size_t i = 0; i < soup.size(); ++i)
+		soup[i] = float(i / 4 % 3) * 1000.f + float(i / 12) * 0.25f + float(i % 4);
+
+	std::vector<unsigned char> buffer0(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	buffer0.resize(meshopt_encodeVertexBuffer(&buffer0[0], buffer0.size(), &vertices[0], vertex_count, sizeof(PV)));
+
+	meshopt_encodeVertexVersion(1);
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &vertices[0], vertex_count, sizeof(PV)));
+
+	std::vector<unsigned char> seekable(meshopt_encodeVertexBufferSeekableBound(vertex_count, sizeof(PV)));
+	seekable.resize(meshopt_encodeVertexBufferSeekable(&seekable[0], seekable.size(), &vertices[0], vertex_count, sizeof(PV)));
+
+	std::vector<unsigned char> parallel(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	int dispatched = 0;
+	parallel.resize(meshopt_encodeVertexBufferParallel(&parallel[0], parallel.size(), &vertices[0], vertex_count, sizeof(PV), dispatchReverse, &dispatched));
+
+	std::vector<unsigned char> fbuffer(meshopt_encodeVertexBufferBound(vertex_count, 16));
+	fbuffer.resize(meshopt_encodeVertexBuffer(&fbuffer[0], fbuffer.size(), &floats[0], vertex_count, 16));
+
+	std::vector<unsigned char> sbuffer2(meshopt_encodeVertexBufferBound(vertex_count, 16));
+	sbuffer2.resize(meshopt_encodeVertexBufferLevel(&sbuffer2[0], sbuffer2.size(), &soup[0], vertex_count, 16, 2));
+
+	std::vector<unsigned char> sbuffer3(meshopt_encodeVertexBufferBound(vertex_count, 16));
+	sbuffer3.resize(meshopt_encodeVertexBufferLevel(&sbuffer3[0], sbuffer3.size(), &soup[0], vertex_count, 16, 3));
+
+	meshopt_encodeVertexVersion(0);
+
+	assert(meshopt_decodeVertexVersion(&buffer0[0], buffer0.size()) == 0);
+	assert(meshopt_decodeVertexVersion(&buffer[0], buffer.size()) == 1);
+	assert(meshopt_decodeVertexVersion(&seekable[0], seekable.size()) == 1);
+	assert(buffer == parallel);
+	assert(sbuffer3.size() < sbuffer2.size());
+
+	// check that all decoders accept the new version
+	{
+		std::vector<PV> destination(vertex_count);
+
+		int result = meshopt_decodeVertexBuffer(&destination[0], vertex_count, sizeof(PV), &buffer[0], buffer.size());
+		(void)result;
+
+		assert(result == 0);
+		assert(memcmp(&vertices[0], &destination[0], vertex_count * sizeof(PV)) == 0);
+	}
+
+	{
+		std::vector<PV> destination(vertex_count);
+
+		int result = meshopt_decodeVertexBufferParallel(&destination[0], vertex_count, sizeof(PV), &seekable[0], seekable.size(), dispatchReverse, &dispatched);
+		(void)result;
+
+		assert(result == 0);
+		assert(memcmp(&vertices[0], &destination[0], vertex_count * sizeof(PV)) == 0);
+	}
+
+	{
+		std::vector<PV> destination(vertex_count);
+
+		int result = decodeVertexStream(destination, seekable, 100);
+		(void)result;
+
+		assert(result == 0);
+		assert(memcmp(&vertices[0], &destination[0], vertex_count * sizeof(PV)) == 0);
+	}
+
+	{
+		std::vector<PV> destination(1000);
+
+		int result = meshopt_decodeVertexBufferRange(&destination[0], 1500, 1000, vertex_count, sizeof(PV), &seekable[0], seekable.size());
+		(void)result;
+
+		assert(result == 0);
+		assert(memcmp(&vertices[1500], &destination[0], 1000 * sizeof(PV)) == 0);
+	}
+
+	{
+		std::vector<float> destination(vertex_count * 4);
+
+		int result = meshopt_decodeVertexBuffer(&destination[0], vertex_count, 16, &fbuffer[0], fbuffer.size());
+		(void)result;
+
+		assert(result == 0);
+		assert(memcmp(&floats[0], &destination[0], floats.size() * sizeof(float)) == 0);
+	}
+
+	{
+		std::vector<float> destination(vertex_count * 4);
+
+		int result = meshopt_decodeVertexBuffer(&destination[0], vertex_count, 16, &sbuffer3[0], sbuffer3.size());
+		(void)result;
+
+		assert(result == 0);
+		assert(memcmp(&soup[0], &destination[0], soup.size() * sizeof(float)) == 0);
+	}
+
+	// check that every delta distance (1-4) round-trips through the decoding kernel selected on this CPU
+	for (int distance = 1; distance <= 4; ++distance)
+	{
+		std::vector<float> periodic(vertex_count * 4);
+
+		for (size_t i = 0; i < periodic.size(); ++i)
+			periodic[i] = float(i / 4 % distance) * 1000.f + float(i / (4 * distance)) * 0.25f + float(i % 4);
+
+		meshopt_encodeVertexVersion(1);
+
+		std::vector<unsigned char> pbuffer(meshopt_encodeVertexBufferBound(vertex_count, 16));
+		pbuffer.resize(meshopt_encodeVertexBufferLevel(&pbuffer[0], pbuffer.size(), &periodic[0], vertex_count, 16, 3));
+
+		meshopt_encodeVertexVersion(0);
+
+		std::vector<float> destination(vertex_count * 4);
+
+		int result = meshopt_decodeVertexBuffer(&destination[0], vertex_count, 16, &pbuffer[0], pbuffer.size());
+		(void)result;
+
+		assert(result == 0);
+		assert(memcmp(&periodic[0], &destination[0], periodic.size() * sizeof(float)) == 0);
+	}
+
+	// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	for (size_t i = 0; i < buffer.size(); i += (i < 64 || buffer.size() - i < 64) ? 1 : 61)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+		std::vector<PV> destination(vertex_count);
+
+		int result = meshopt_decodeVertexBuffer(&destination[0], vertex_count, sizeof(PV), i == 0 ? 0 : &shortbuffer[0], i);
+		(void)result;
+
+		assert(result < 0);
+	}
+
+	// check that decoder doesn't accept unknown versions
+	{
+		std::vector<unsigned char> brokenbuffer(buffer);
+		brokenbuffer[0] |= 7;
+
+		std::vector<PV> destination(vertex_count);
+
+		int result = meshopt_decodeVertexBuffer(&destination[0], vertex_count, sizeof(PV), &brokenbuffer[0], brokenbuffer.size());
+		(void)result;
+
+		assert(result == -1);
+		assert(meshopt_decodeVertexVersion(&brokenbuffer[0], brokenbuffer.size()) == -1);
+	}
+}
+
+static void fillCoverageGrid(std::vector<unsigned int>& indices, size_t grid_size)
+{
+	indices.clear();
+
+	for (size_t y = 0; y < grid_size; ++y)
+		for (size_t x = 0; x < grid_size; ++x)
+		{
+			unsigned int v0 = unsigned(y * (grid_size + 1) + x);
+			unsigned int v1 = v0 + 1;
+			unsigned int v2 = v0 + unsigned(grid_size + 1);
+			unsigned int v3 = v2 + 1;
+
+			unsigned int quad[] = {v0, v2, v1, v1, v2, v3};
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+
+	size_t vertex_count = (grid_size + 1) * (grid_size + 1);
+
+	std::vector<unsigned int> remap(vertex_count);
+
+	// optimize the mesh so that the codec can exploit vertex cache locality and sequential vertex order
+	meshopt_optimizeVertexCache(&indices[0], &indices[0], indices.size(), vertex_count);
+	meshopt_optimizeVertexFetchRemap(&remap[0], &indices[0], indices.size(), vertex_count);
+	meshopt_remapIndexBuffer(&indices[0], &indices[0], indices.size(), &remap[0]);
+}
+
+static bool isRotatedTriangleList(const std::vector<unsigned int>& result, const std::vector<unsigned int>& indices)
+{
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		unsigned int a = indices[i + 0], b = indices[i + 1], c = indices[i + 2];
+
+		if (!((result[i + 0] == a && result[i + 1] == b && result[i + 2] == c) ||
+		        (result[i + 1] == a && result[i + 2] == b && result[i + 0] == c) ||
+		        (result[i + 2] == a && result[i + 0] == b && result[i + 1] == c)))
+			return false;
+	}
+
+	return true;
+}
+
+void encodeIndexLevelCoverage()
+{
+	const size_t grid_size = 32;
+
+	std::vector<unsigned int> indices;
+	fillCoverageGrid(indices, grid_size);
+
+	const size_t index_count = indices.size();
+	const size_t vertex_count = (grid_size + 1) * (grid_size + 1);
+
+	std::vector<unsigned char> reference(meshopt_encodeIndexBufferBound(index_count, vertex_count));
+	reference.resize(meshopt_encodeIndexBuffer(&reference[0], reference.size(), &indices[0], index_count));
+
+	for (int level = 0; level <= 1; ++level)
+	{
+		std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(index_count, vertex_count));
+		buffer.resize(meshopt_encodeIndexBufferLevel(&buffer[0], buffer.size(), &indices[0], index_count, level));
+
+		assert(buffer.size() > 0);
+		assert(level != 0 || buffer == reference);
+		assert(buffer.size() <= reference.size());
+
+		std::vector<unsigned int> destination(index_count);
+		std::vector<unsigned int> destination0(index_count);
+
+		int result = meshopt_decodeIndexBuffer(&destination[0], index_count, &buffer[0], buffer.size());
+		int result0 = meshopt_decodeIndexBuffer(&destination0[0], index_count, &reference[0], reference.size());
+		(void)result;
+		(void)result0;
+
+		// the encoding table doesn't affect triangle rotation so the decoded data must match exactly
+		assert(result == 0 && result0 == 0);
+		assert(destination == destination0);
+
+		// check that encode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+		for (size_t i = 0; i < buffer.size(); i += (i < 64 || buffer.size() - i < 64) ? 1 : 61)
+		{
+			std::vector<unsigned char> shortbuffer(i);
+			size_t size = meshopt_encodeIndexBufferLevel(i == 0 ? 0 : &shortbuffer[0], i, &indices[0], index_count, level);
+			(void)size;
+
+			assert(size == 0);
+		}
+	}
+}
+
+void encodeIndexChunkedCoverage()
+{
+	// use enough triangles for the stream to have 3 chunks, with the last chunk being partial
+	const size_t grid_size = 150;
+
+	std::vector<unsigned int> indices;
+	fillCoverageGrid(indices, grid_size);
+
+	const size_t index_count = indices.size();
+	const size_t vertex_count = (grid_size + 1) * (grid_size + 1);
+
+	std::vector<unsigned char> regular(meshopt_encodeIndexBufferBound(index_count, vertex_count));
+	regular.resize(meshopt_encodeIndexBuffer(&regular[0], regular.size(), &indices[0], index_count));
+
+	std::vector<unsigned char> buffer(meshopt_encodeIndexBufferChunkedBound(index_count, vertex_count));
+
+	// check that chunked encode produces the same output with and without a dispatcher
+	for (int k = 0; k < 2; ++k)
+	{
+		int dispatched = 0;
+
+		std::vector<unsigned char> cbuffer(meshopt_encodeIndexBufferChunkedBound(index_count, vertex_count));
+		cbuffer.resize(meshopt_encodeIndexBufferChunked(&cbuffer[0], cbuffer.size(), &indices[0], index_count, k == 0 ? dispatchReverse : 0, &dispatched));
+
+		assert(cbuffer.size() > 0);
+		assert(dispatched == (k == 0 ? 2 : 0));
+
+		if (k == 0)
+			buffer.swap(cbuffer);
+		else
+			assert(cbuffer == buffer);
+	}
+
+	// chunk restarts are relatively cheap since each chunk is seeded with the next vertex index
+	assert(buffer.size() < regular.size() + regular.size() / 50);
+
+	// check that parallel decode handles chunked and regular streams with and without a dispatcher, and that regular decode handles chunked streams
+	for (int k = 0; k < 3; ++k)
+	{
+		const std::vector<unsigned char>& input = k == 2 ? regular : buffer;
+
+		int dispatched = 0;
+
+		std::vector<unsigned int> destination(index_count);
+		std::vector<unsigned short> destination16(index_count);
+
+		int result = k == 1 ? meshopt_decodeIndexBuffer(&destination[0], index_count, &input[0], input.size()) : meshopt_decodeIndexBufferParallel(&destination[0], index_count, &input[0], input.size(), dispatchReverse, &dispatched);
+		int result16 = meshopt_decodeIndexBufferParallel(&destination16[0], index_count, &input[0], input.size(), 0, 0);
+		(void)result;
+		(void)result16;
+
+		assert(result == 0 && result16 == 0);
+		assert(dispatched == (k == 0));
+		assert(isRotatedTriangleList(destination, indices));
+
+		for (size_t i = 0; i < index_count; ++i)
+			assert(destination[i] == destination16[i]);
+	}
+
+	// check that encode is memory-safe and falls back to serial encoding when the buffer is smaller than the bound; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	for (size_t i = 0; i <= buffer.size(); i += (i < 64 || buffer.size() - i < 64) ? 1 : 997)
+	{
+		std::vector<unsigned char> shortbuffer(i);
+
+		int dispatched = 0;
+
+		size_t result = meshopt_encodeIndexBufferChunked(i == 0 ? 0 : &shortbuffer[0], i, &indices[0], index_count, dispatchReverse, &dispatched);
+		(void)result;
+
+		if (i == buffer.size())
+			assert(result == buffer.size() && shortbuffer == buffer);
+		else
+			assert(result == 0);
+	}
+
+	// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	for (size_t i = 0; i <= buffer.size(); i += (i < 64 || buffer.size() - i < 64) ? 1 : 997)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+		std::vector<unsigned int> destination(index_count);
+
+		int dispatched = 0;
+
+		int result = meshopt_decodeIndexBufferParallel(&destination[0], index_count, i == 0 ? 0 : &shortbuffer[0], i, dispatchReverse, &dispatched);
+		(void)result;
+
+		if (i == buffer.size())
+			assert(result == 0);
+		else
+			assert(result < 0);
+	}
+
+	// check that decoder doesn't accept extra bytes after a valid stream, malformed headers or malformed chunk offsets
+	for (int k = 0; k < 4; ++k)
+	{
+		std::vector<unsigned char> brokenbuffer(buffer);
+
+		if (k == 0)
+			brokenbuffer.push_back(0);
+		else if (k == 1)
+			brokenbuffer[0] = 0;
+		else
+			brokenbuffer[1 + (k - 2) * 8]++;
+
+		std::vector<unsigned int> destination(index_count);
+
+		int dispatched = 0;
+
+		int result = meshopt_decodeIndexBufferParallel(&destination[0], index_count, &brokenbuffer[0], brokenbuffer.size(), dispatchReverse, &dispatched);
+		(void)result;
+
+		assert(result < 0);
+	}
+}
+
+void encodeIndexRebaseCoverage()
+{
+	const size_t grid_size = 100;
+
+	std::vector<unsigned int> indices;
+	fillCoverageGrid(indices, grid_size);
+
+	const size_t index_count = indices.size();
+	const size_t vertex_count = (grid_size + 1) * (grid_size + 1);
+
+	// offset the indices so that the mesh references vertices past the 16-bit range
+	const unsigned int base = 100000;
+
+	for (size_t i = 0; i < index_count; ++i)
+		indices[i] += base;
+
+	std::vector<unsigned char> regular(meshopt_encodeIndexBufferBound(index_count, base + vertex_count));
+	regular.resize(meshopt_encodeIndexBuffer(&regular[0], regular.size(), &indices[0], index_count));
+
+	std::vector<unsigned char> chunked(meshopt_encodeIndexBufferChunkedBound(index_count, base + vertex_count));
+	chunked.resize(meshopt_encodeIndexBufferChunked(&chunked[0], chunked.size(), &indices[0], index_count, 0, 0));
+
+	for (int k = 0; k < 2; ++k)
+	{
+		const std::vector<unsigned char>& buffer = k == 0 ? regular : chunked;
+
+		std::vector<unsigned int> reference(index_count);
+		std::vector<unsigned short> destination(index_count);
+
+		int result = meshopt_decodeIndexBuffer(&reference[0], index_count, &buffer[0], buffer.size());
+		int resultr = meshopt_decodeIndexBufferRebase(&destination[0], index_count, base, &buffer[0], buffer.size());
+		(void)result;
+		(void)resultr;
+
+		assert(result == 0 && resultr == 0);
+
+		for (size_t i = 0; i < index_count; ++i)
+			assert(destination[i] == reference[i] - base);
+
+		// check that indices below the base vertex and above the 16-bit range are rejected
+		assert(meshopt_decodeIndexBufferRebase(&destination[0], index_count, base + 1, &buffer[0], buffer.size()) == -4);
+		assert(meshopt_decodeIndexBufferRebase(&destination[0], index_count, 0, &buffer[0], buffer.size()) == -4);
+		assert(meshopt_decodeIndexBufferRebase(&destination[0], index_count, base + unsigned(vertex_count) - 65536, &buffer[0], buffer.size()) == 0);
+		assert(meshopt_decodeIndexBufferRebase(&destination[0], index_count, base + unsigned(vertex_count) - 65537, &buffer[0], buffer.size()) == -4);
+
+		// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+		for (size_t i = 0; i <= buffer.size(); i += (i < 64 || buffer.size() - i < 64) ? 1 : 97)
+		{
+			std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+			int sresult = meshopt_decodeIndexBufferRebase(&destination[0], index_count, base, i == 0 ? 0 : &shortbuffer[0], i);
+			(void)sresult;
+
+			if (i == buffer.size())
+				assert(sresult == 0);
+			else
+				assert(sresult < 0);
+		}
+	}
+}
+
+void encodeIndexSequenceCoverage()
+{
+	// note: 1000 is a large delta that switches baselines, ~0u is a restart index and 1002 after a restart is a zero delta from baseline 1 which is reserved for restarts
+	const unsigned int data[] = {0, 1, 2, 2, ~0u, 1, 0, 1, 2, 1000, 1001, 3, 4, 1002, ~0u, 1002, 9, 9, 0xffffffff - 1, 5};
+	const size_t index_count = sizeof(data) / sizeof(data[0]);
+	const size_t vertex_count = 0xffffffff;
+
+	std::vector<unsigned char> buffer(meshopt_encodeIndexSequenceBound(index_count, vertex_count));
+	buffer.resize(meshopt_encodeIndexSequence(&buffer[0], buffer.size(), data, index_count));
+
+	// check that encode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(i);
+		size_t result = meshopt_encodeIndexSequence(i == 0 ? 0 : &shortbuffer[0], i, data, index_count);
+		(void)result;
+
+		if (i == buffer.size())
+			assert(result == buffer.size());
+		else
+			assert(result == 0);
+	}
+
+	// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	unsigned int destination[index_count];
+	unsigned short destination16[index_count];
+
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+		int result = meshopt_decodeIndexSequence(destination, index_count, i == 0 ? 0 : &shortbuffer[0], i);
+		int result16 = meshopt_decodeIndexSequence(destination16, index_count, i == 0 ? 0 : &shortbuffer[0], i);
+		(void)result;
+		(void)result16;
+
+		if (i == buffer.size())
+			assert(result == 0 && result16 == 0);
+		else
+			assert(result < 0 && result16 < 0);
+	}
+
+	for (size_t i = 0; i < index_count; ++i)
+		assert(destination[i] == data[i] && destination16[i] == (unsigned short)data[i]);
+
+	// check that decoder doesn't accept extra bytes after a valid stream
+	{
+		std::vector<unsigned char> largebuffer(buffer);
+		largebuffer.push_back(0);
+
+		int result = meshopt_decodeIndexSequence(destination, index_count, &largebuffer[0], largebuffer.size());
+		(void)result;
+
+		assert(result < 0);
+	}
+
+	// check that decoder doesn't accept malformed headers
+	{
+		std::vector<unsigned char> brokenbuffer(buffer);
+		brokenbuffer[0] = 0;
+
+		int result = meshopt_decodeIndexSequence(destination, index_count, &brokenbuffer[0], brokenbuffer.size());
+		(void)result;
+
+		assert(result < 0);
+	}
+
+	// check that single-byte sequences of various lengths take the fast path correctly
+	std::vector<unsigned int> sequence;
+
+	for (size_t i = 0; i < 37; ++i)
+	{
+		sequence.push_back(unsigned(i % 5 == 4 ? ~0u : i));
+
+		std::vector<unsigned char> sbuffer(meshopt_encodeIndexSequenceBound(sequence.size(), 64));
+		sbuffer.resize(meshopt_encodeIndexSequence(&sbuffer[0], sbuffer.size(), &sequence[0], sequence.size()));
+
+		assert(sbuffer.size() == 1 + sequence.size() + 4);
+
+		std::vector<unsigned int> sresult(sequence.size());
+		int result = meshopt_decodeIndexSequence(&sresult[0], sequence.size(), &sbuffer[0], sbuffer.size());
+		(void)result;
+
+		assert(result == 0 && sresult == sequence);
+	}
+
+	// check that 16-bit strips encode restart indices the same way as 32-bit strips
+	const unsigned int strip[] = {0, 1, 2, 3, ~0u, 4, 5, 6, ~0u, 7, 8, 9, 10};
+	const size_t strip_count = sizeof(strip) / sizeof(strip[0]);
+
+	unsigned short strip16[strip_count];
+
+	for (size_t i = 0; i < strip_count; ++i)
+		strip16[i] = (unsigned short)strip[i];
+
+	std::vector<unsigned char> sbuffer32(meshopt_encodeIndexSequenceBound(strip_count, 11));
+	sbuffer32.resize(meshopt_encodeIndexSequence(&sbuffer32[0], sbuffer32.size(), strip, strip_count));
+
+	std::vector<unsigned char> sbuffer16(meshopt_encodeIndexSequenceBound(strip_count, 11));
+	sbuffer16.resize(meshopt_encodeIndexSequence(&sbuffer16[0], sbuffer16.size(), strip16, strip_count));
+
+	assert(sbuffer16 == sbuffer32);
+
+	unsigned short sresult16[strip_count];
+	int sresult = meshopt_decodeIndexSequence(sresult16, strip_count, &sbuffer16[0], sbuffer16.size());
+	(void)sresult;
+
+	assert(sresult == 0 && memcmp(sresult16, strip16, sizeof(strip16)) == 0);
+}
+
+static int sinkEntropyCopy(void* context, const unsigned char* data, size_t size)
+{
+	std::vector<unsigned char>& destination = *static_cast<std::vector<unsigned char>*>(context);
+
+	// blocks are at most 64 KB; stop decoding after the first 100 KB to check that sink errors are propagated
+	assert(size > 0 && size <= 65536);
+
+	if (destination.size() >= 100000)
+		return 42;
+
+	destination.insert(destination.end(), data, data + size);
+	return 0;
+}
+
+void encodeEntropyCoverage()
+{
+	// check a few data distributions: empty data, single symbol, skewed symbols, incompressible data, and multi-block data with a mix of the above
+	for (int k = 0; k < 5; ++k)
+	{
+		const size_t sizes[] = {0, 1000, 3000, 5000, 150000};
+
+		std::vector<unsigned char> data(sizes[k]);
+
+		for (size_t i = 0; i < data.size(); ++i)
+		{
+			unsigned int h = unsigned(i) * 2654435761u;
+			unsigned int r = (h >> 16) & 255;
+
+			if (k == 1 || (k == 4 && i < 70000))
+				data[i] = 42;
+			else if (k == 2 || (k == 4 && i < 140000))
+				data[i] = (unsigned char)(r < 128 ? 0 : r < 192 ? 1 : r & 15);
+			else
+				data[i] = (unsigned char)(h >> 24);
+		}
+
+		std::vector<unsigned char> buffer(meshopt_encodeEntropyBound(data.size()));
+		buffer.resize(meshopt_encodeEntropy(&buffer[0], buffer.size(), data.empty() ? 0 : &data[0], data.size()));
+
+		assert(buffer.size() > 0 && buffer.size() <= meshopt_encodeEntropyBound(data.size()));
+		assert(k == 0 || k == 3 || buffer.size() < data.size() / 2);
+
+		std::vector<unsigned char> destination(data.size() + 1);
+
+		int result = meshopt_decodeEntropy(&destination[0], data.size(), &buffer[0], buffer.size());
+		(void)result;
+
+		assert(result == 0);
+		assert(data.empty() || memcmp(&destination[0], &data[0], data.size()) == 0);
+
+		// check that stream decode produces the same data and propagates sink errors
+		std::vector<unsigned char> streamed;
+
+		result = meshopt_decodeEntropyStream(data.size(), &buffer[0], buffer.size(), sinkEntropyCopy, &streamed);
+
+		assert(k == 4 ? result == 42 : (result == 0 && streamed == data));
+
+		// check that encode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+		for (size_t i = 0; i <= buffer.size(); i += (i < 64 || buffer.size() - i < 64) ? 1 : 997)
+		{
+			std::vector<unsigned char> shortbuffer(i);
+			size_t size = meshopt_encodeEntropy(i == 0 ? 0 : &shortbuffer[0], i, data.empty() ? 0 : &data[0], data.size());
+			(void)size;
+
+			if (i == buffer.size())
+				assert(size == buffer.size());
+			else
+				assert(size == 0);
+		}
+
+		// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+		for (size_t i = 0; i <= buffer.size(); i += (i < 64 || buffer.size() - i < 64) ? 1 : 997)
+		{
+			std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+			int sresult = meshopt_decodeEntropy(&destination[0], data.size(), i == 0 ? 0 : &shortbuffer[0], i);
+			(void)sresult;
+
+			if (i == buffer.size())
+				assert(sresult == 0);
+			else
+				assert(sresult < 0);
+		}
+
+		// check that decoder doesn't accept extra bytes after a valid stream, malformed headers or corrupted data
+		for (size_t i = 0; i < buffer.size() + 1; i += (i < 64 || buffer.size() - i < 64) ? 1 : 997)
+		{
+			std::vector<unsigned char> brokenbuffer(buffer);
+
+			if (i == buffer.size())
+				brokenbuffer.push_back(0);
+			else
+				brokenbuffer[i] ^= 1;
+
+			int bresult = meshopt_decodeEntropy(&destination[0], data.size(), &brokenbuffer[0], brokenbuffer.size());
+			(void)bresult;
+
+			// raw blocks and some table bits can be corrupted without making the stream invalid, but the decoder must never read or write out of bounds
+			assert(bresult <= 0);
+			assert((i != 0 && i != buffer.size()) || bresult < 0);
+		}
+	}
+}
+
+void encodeVertexLevelCoverage()
+{
+	typedef PackedVertexOct PV;
+
+	const size_t vertex_count = 3000;
+
+	std::vector<PV> vertices(vertex_count);
+	fillCoverageVertices(vertices);
+
+	for (int version = 0; version <= 1; ++version)
+	{
+		meshopt_encodeVertexVersion(version);
+
+		std::vector<unsigned char> reference(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+		reference.resize(meshopt_encodeVertexBuffer(&reference[0], reference.size(), &vertices[0], vertex_count, sizeof(PV)));
+
+		for (int level = 0; level <= 3; ++level)
+		{
+			std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+			buffer.resize(meshopt_encodeVertexBufferLevel(&buffer[0], buffer.size(), &vertices[0], vertex_count, sizeof(PV), level));
+
+			assert(buffer.size() > 0);
+			assert(level != 2 || buffer == reference);
+
+			std::vector<PV> destination(vertex_count);
+
+			int result = meshopt_decodeVertexBuffer(&destination[0], vertex_count, sizeof(PV), &buffer[0], buffer.size());
+			(void)result;
+
+			assert(result == 0);
+			assert(memcmp(&vertices[0], &destination[0], vertex_count * sizeof(PV)) == 0);
+
+			// check that encode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+			for (size_t i = 0; i < buffer.size(); i += (i < 64 || buffer.size() - i < 64) ? 1 : 61)
+			{
+				std::vector<unsigned char> shortbuffer(i);
+				size_t size = meshopt_encodeVertexBufferLevel(i == 0 ? 0 : &shortbuffer[0], i, &vertices[0], vertex_count, sizeof(PV), level);
+				(void)size;
+
+				assert(size == 0);
+			}
+		}
+	}
+
+	meshopt_encodeVertexVersion(0);
+}
+
+void encodeVertexSplitCoverage()
+{
+	typedef PackedVertexOct PV;
+
+	const size_t vertex_count = 3000;
+
+	std::vector<PV> vertices(vertex_count);
+	fillCoverageVertices(vertices);
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &vertices[0], vertex_count, sizeof(PV)));
+
+	// positions are tightly packed, the remaining attributes are padded and the texture coordinates are copied twice
+	std::vector<unsigned char> positions(vertex_count * 6);
+	std::vector<unsigned char> attributes(vertex_count * 12);
+	std::vector<unsigned char> texcoords(vertex_count * 4);
+
+	const meshopt_VertexOutput outputs[] =
+	    {
+	        {offsetof(PV, px), 6, &positions[0], 6},
+	        {offsetof(PV, nu), 6, &attributes[0], 12},
+	        {offsetof(PV, tx), 4, &texcoords[0], 4},
+	    };
+
+	const size_t output_count = sizeof(outputs) / sizeof(outputs[0]);
+
+	int result = meshopt_decodeVertexBufferSplit(outputs, output_count, vertex_count, sizeof(PV), &buffer[0], buffer.size());
+	(void)result;
+
+	assert(result == 0);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		assert(memcmp(&positions[i * 6], &vertices[i].px, 6) == 0);
+		assert(memcmp(&attributes[i * 12], &vertices[i].nu, 6) == 0);
+		assert(memcmp(&texcoords[i * 4], &vertices[i].tx, 4) == 0);
+	}
+
+	// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	for (size_t i = 0; i < buffer.size(); i += (i < 64 || buffer.size() - i < 64) ? 1 : 61)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+
+		int result = meshopt_decodeVertexBufferSplit(outputs, output_count, vertex_count, sizeof(PV), i == 0 ? 0 : &shortbuffer[0], i);
+		(void)result;
+
+		assert(result < 0);
+	}
+}
+
+void encodeVertexSizeCoverage()
+{
+	// vertex sizes that aren't a multiple of 4 and sizes above 256 bytes use separate code paths in all encoders and decoders
+	const size_t vertex_sizes[] = {1, 2, 3, 5, 6, 7, 13, 30, 255, 257, 300, 511, 512};
+
+	for (size_t s = 0; s < sizeof(vertex_sizes) / sizeof(vertex_sizes[0]); ++s)
+	{
+		size_t vertex_size = vertex_sizes[s];
+		size_t vertex_count = 5000 * 6 / vertex_size + 37;
+
+		std::vector<unsigned char> vertices(vertex_count * vertex_size);
+
+		for (size_t i = 0; i < vertices.size(); ++i)
+		{
+			size_t index = i / vertex_size, offset = i % vertex_size;
+			vertices[i] = (unsigned char)((offset % 3 == 0) ? index * (offset + 1) : (offset % 3 == 1) ? (index * index) >> 4 : offset);
+		}
+
+		for (int version = 0; version <= 1; ++version)
+		{
+			meshopt_encodeVertexVersion(version);
+
+			std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, vertex_size));
+			buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &vertices[0], vertex_count, vertex_size));
+
+			std::vector<unsigned char> seekable(meshopt_encodeVertexBufferSeekableBound(vertex_count, vertex_size));
+			seekable.resize(meshopt_encodeVertexBufferSeekable(&seekable[0], seekable.size(), &vertices[0], vertex_count, vertex_size));
+
+			std::vector<unsigned char> fast(meshopt_encodeVertexBufferBound(vertex_count, vertex_size));
+			fast.resize(meshopt_encodeVertexBufferLevel(&fast[0], fast.size(), &vertices[0], vertex_count, vertex_size, 0));
+
+			std::vector<unsigned char> parallel(meshopt_encodeVertexBufferBound(vertex_count, vertex_size));
+			int dispatched = 0;
+			parallel.resize(meshopt_encodeVertexBufferParallel(&parallel[0], parallel.size(), &vertices[0], vertex_count, vertex_size, dispatchReverse, &dispatched));
+
+			assert(buffer.size() > 0 && seekable.size() > 0 && fast.size() > 0);
+			assert(buffer == parallel);
+
+			std::vector<unsigned char> destination(vertices.size());
+
+			int result = meshopt_decodeVertexBuffer(&destination[0], vertex_count, vertex_size, &buffer[0], buffer.size());
+			assert(result == 0 && destination == vertices);
+
+			std::fill(destination.begin(), destination.end(), 0);
+			result = meshopt_decodeVertexBuffer(&destination[0], vertex_count, vertex_size, &fast[0], fast.size());
+			assert(result == 0 && destination == vertices);
+
+			std::fill(destination.begin(), destination.end(), 0);
+			result = meshopt_decodeVertexBufferParallel(&destination[0], vertex_count, vertex_size, &seekable[0], seekable.size(), dispatchReverse, &dispatched);
+			assert(result == 0 && destination == vertices);
+
+			size_t first = vertex_count / 3, count = vertex_count / 2;
+
+			result = meshopt_decodeVertexBufferRange(&destination[0], first, count, vertex_count, vertex_size, &seekable[0], seekable.size());
+			assert(result == 0 && memcmp(&destination[0], &vertices[first * vertex_size], count * vertex_size) == 0);
+			(void)result;
+
+			// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+			for (size_t i = 0; i < buffer.size(); i += (i < 64 || buffer.size() - i < 64) ? 1 : 61)
+			{
+				std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+
+				int result = meshopt_decodeVertexBuffer(&destination[0], vertex_count, vertex_size, i == 0 ? 0 : &shortbuffer[0], i);
+				(void)result;
+
+				assert(result < 0);
+			}
+		}
+	}
+
+	meshopt_encodeVertexVersion(0);
+}
+
+double remapStream(const Mesh& mesh, size_t attributes, size_t& unique_vertices)
+{
+	// unindexed streams are what importers feed to generateVertexRemap; every vertex is looked up in the hash table
+	size_t index_count = mesh.indices.size();
+
+	std::vector<float> vertices(index_count * attributes);
+
+	for (size_t i = 0; i < index_count; ++i)
+		memcpy(&vertices[i * attributes], &mesh.vertices[mesh.indices[i]], sizeof(float) * attributes);
+
+	std::vector<unsigned int> remap(index_count);
+
+	double start = timestamp();
+	unique_vertices = meshopt_generateVertexRemap(&remap[0], NULL, index_count, &vertices[0], index_count, sizeof(float) * attributes);
+	double end = timestamp();
+
+	return end - start;
+}
+
+double remapStreamMulti(const Mesh& mesh, size_t& unique_vertices)
+{
+	// same data as the 32-byte interleaved case, stored as separate position, normal and texture coordinate streams
+	size_t index_count = mesh.indices.size();
+
+	std::vector<float> positions(index_count * 3);
+	std::vector<float> normals(index_count * 3);
+	std::vector<float> texcoords(index_count * 2);
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		const Vertex& v = mesh.vertices[mesh.indices[i]];
+
+		memcpy(&positions[i * 3], &v.px, sizeof(float) * 3);
+		memcpy(&normals[i * 3], &v.nx, sizeof(float) * 3);
+		memcpy(&texcoords[i * 2], &v.tx, sizeof(float) * 2);
+	}
+
+	meshopt_Stream streams[] = {
+	    {&positions[0], sizeof(float) * 3, sizeof(float) * 3},
+	    {&normals[0], sizeof(float) * 3, sizeof(float) * 3},
+	    {&texcoords[0], sizeof(float) * 2, sizeof(float) * 2},
+	};
+
+	std::vector<unsigned int> remap(index_count);
+
+	double start = timestamp();
+	unique_vertices = meshopt_generateVertexRemapMulti(&remap[0], NULL, index_count, index_count, streams, sizeof(streams) / sizeof(streams[0]));
+	double end = timestamp();
+
+	return end - start;
+}
+
+void remap(const Mesh& mesh)
+{
+	// 12/24/32-byte vertices use specialized hashing and comparison; 28-byte vertices go through the generic path
+	size_t unique12 = 0, unique24 = 0, unique28 = 0, unique32 = 0;
+
+	double time12 = remapStream(mesh, 3, unique12);
+	double time24 = remapStream(mesh, 6, unique24);
+	double time28 = remapStream(mesh, 7, unique28);
+	double time32 = remapStream(mesh, 8, unique32);
+
+	size_t unique_multi = 0;
+	double time_multi = remapStreamMulti(mesh, unique_multi);
+
+	assert(unique32 == mesh.vertices.size());
+	assert(unique12 <= unique24 && unique24 <= unique28 && unique28 <= unique32);
+	assert(unique_multi == unique32);
+
+	printf("Remap    : %d vertices; 12b %.2f msec, 24b %.2f msec, 28b (generic) %.2f msec, 32b %.2f msec, 3 streams %.2f msec; %.1f Mvert/s\n",
+	       int(mesh.indices.size()), time12 * 1000, time24 * 1000, time28 * 1000, time32 * 1000, time_multi * 1000,
+	       double(mesh.indices.size()) / 1e6 / time32);
+}
+
+void remapTolerance(const Mesh& mesh)
+{
+	// scanned and tessellated data often has vertices that differ by float noise; jitter positions and normals to simulate that
+	size_t index_count = mesh.indices.size();
+
+	std::vector<Vertex> vertices(index_count);
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		Vertex v = mesh.vertices[mesh.indices[i]];
+
+		float jitter = float(int((unsigned(i) * 2654435761u) >> 24) - 128) / 128.f;
+
+		v.px += jitter * 1e-5f;
+		v.nz += jitter * 1e-4f;
+
+		vertices[i] = v;
+	}
+
+	std::vector<unsigned int> remap(index_count);
+
+	size_t unique_exact = meshopt_generateVertexRemap(&remap[0], NULL, index_count, &vertices[0], index_count, sizeof(Vertex));
+
+	const float tolerances[] = {2e-5f, 2e-5f, 2e-5f, 1e-3f, 1e-3f, 1e-3f, 0, 0};
+
+	double start = timestamp();
+	size_t unique = meshopt_generateVertexRemapTolerance(&remap[0], NULL, index_count, &vertices[0].px, index_count, sizeof(Vertex), tolerances, sizeof(tolerances) / sizeof(tolerances[0]));
+	double end = timestamp();
+
+	printf("RemapTol : %d vertices; exact %d unique, tolerance %d unique (original %d) in %.2f msec\n",
+	       int(index_count), int(unique_exact), int(unique), int(mesh.vertices.size()), (end - start) * 1000);
+}
+
+struct ExternalRemapContext
+{
+	const unsigned char* vertices;
+	size_t vertex_size;
+	size_t source_calls;
+	size_t source_limit;
+
+	std::vector<std::vector<unsigned char> > partitions;
+	std::vector<int> partition_reads;
+
+	std::vector<unsigned int> remap;
+	std::vector<unsigned char> unique_vertices;
+};
+
+static int externalSource(void* context, void* destination, size_t vertex_offset, size_t vertex_count)
+{
+	ExternalRemapContext& ctx = *static_cast<ExternalRemapContext*>(context);
+
+	if (++ctx.source_calls > ctx.source_limit)
+		return 42;
+
+	memcpy(destination, ctx.vertices + vertex_offset * ctx.vertex_size, vertex_count * ctx.vertex_size);
+	return 0;
+}
+
+static int externalWrite(void* context, size_t partition, const void* data, size_t size)
+{
+	ExternalRemapContext& ctx = *static_cast<ExternalRemapContext*>(context);
+
+	assert(ctx.partition_reads[partition] == 0);
+
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	ctx.partitions[partition].insert(ctx.partitions[partition].end(), bytes, bytes + size);
+	return 0;
+}
+
+static int externalRead(void* context, size_t partition, void* destination, size_t size)
+{
+	ExternalRemapContext& ctx = *static_cast<ExternalRemapContext*>(context);
+
+	assert(ctx.partitions[partition].size() == size);
+	ctx.partition_reads[partition]++;
+
+	memcpy(destination, &ctx.partitions[partition][0], size);
+
+	// storage for the partition is no longer needed
+	std::vector<unsigned char>().swap(ctx.partitions[partition]);
+	return 0;
+}
+
+static int externalRemapSink(void* context, const unsigned int* remap, size_t vertex_offset, size_t vertex_count)
+{
+	ExternalRemapContext& ctx = *static_cast<ExternalRemapContext*>(context);
+
+	assert(ctx.remap.size() == vertex_offset);
+	ctx.remap.insert(ctx.remap.end(), remap, remap + vertex_count);
+	return 0;
+}
+
+static void externalVertexSink(void* context, const void* vertices, size_t vertex_offset, size_t vertex_count)
+{
+	ExternalRemapContext& ctx = *static_cast<ExternalRemapContext*>(context);
+
+	assert(ctx.unique_vertices.size() == vertex_offset * ctx.vertex_size);
+
+	const unsigned char* bytes = static_cast<const unsigned char*>(vertices);
+	ctx.unique_vertices.insert(ctx.unique_vertices.end(), bytes, bytes + vertex_count * ctx.vertex_size);
+}
+
+static int generateVertexRemapExternal(ExternalRemapContext& ctx, size_t* unique_vertex_count, const void* vertices, size_t vertex_count, size_t vertex_size, size_t partition_count, size_t source_limit = ~size_t(0))
+{
+	ctx.vertices = static_cast<const unsigned char*>(vertices);
+	ctx.vertex_size = vertex_size;
+	ctx.source_calls = 0;
+	ctx.source_limit = source_limit;
+	ctx.partitions.assign(partition_count * 2, std::vector<unsigned char>());
+	ctx.partition_reads.assign(partition_count * 2, 0);
+	ctx.remap.clear();
+	ctx.unique_vertices.clear();
+
+	meshopt_RemapStorage storage = {&ctx, externalWrite, externalRead};
+
+	return meshopt_generateVertexRemapExternal(unique_vertex_count, vertex_count, vertex_size, externalSource, &ctx, partition_count, &storage, externalRemapSink, externalVertexSink, &ctx);
+}
+
+void remapExternal(const Mesh& mesh)
+{
+	size_t index_count = mesh.indices.size();
+
+	std::vector<Vertex> vertices(index_count);
+	for (size_t i = 0; i < index_count; ++i)
+		vertices[i] = mesh.vertices[mesh.indices[i]];
+
+	ExternalRemapContext ctx;
+
+	// partitions are kept in memory here; a real out-of-core setup would spill them to disk
+	double start = timestamp();
+	size_t unique = 0;
+	int result = generateVertexRemapExternal(ctx, &unique, &vertices[0], index_count, sizeof(Vertex), 16);
+	double end = timestamp();
+
+	assert(result == 0);
+	assert(unique == mesh.vertices.size());
+	(void)result;
+
+	printf("RemapExt : %d vertices, 16 partitions; %d unique in %.2f msec (in-memory storage)\n",
+	       int(index_count), int(unique), (end - start) * 1000);
+}
+
+void generateVertexRemapCoverage()
+{
+	// vertices are built from a small set of words so that there are plenty of duplicates; sizes cover specialized and generic paths
+	const size_t sizes[] = {4, 5, 12, 13, 16, 24, 28, 32, 36};
+	const size_t vertex_count = 300;
+
+	for (size_t si = 0; si < sizeof(sizes) / sizeof(sizes[0]); ++si)
+	{
+		size_t vertex_size = sizes[si];
+		size_t vertex_stride = vertex_size + 3;
 
-		for (size_t i = 0; i < mesh.indices.size(); i += 3)
+		std::vector<unsigned char> vertices(vertex_count * vertex_size);
+		std::vector<unsigned char> strided(vertex_count * vertex_stride);
+
+		for (size_t i = 0; i < vertex_count; ++i)
 		{
-			assert(result[i + 0] == result2[i + 0] && result[i + 1] == result2[i + 1] && result[i + 2] == result2[i + 2]);
+			unsigned int seed = unsigned(i * 7 % 23);
+
+			for (size_t k = 0; k < vertex_size; ++k)
+				vertices[i * vertex_size + k] = (unsigned char)((k == vertex_size - 1) ? seed % 3 : (seed >> (k % 4)) & 1);
+
+			memcpy(&strided[i * vertex_stride], &vertices[i * vertex_size], vertex_size);
+
+			// padding between vertices must not affect the result
+			for (size_t k = vertex_size; k < vertex_stride; ++k)
+				strided[i * vertex_stride + k] = (unsigned char)(i * 31 + k);
 		}
-	}
 
-	printf("IdxCodec : %.1f bits/triangle (post-deflate %.1f bits/triangle); encode %.2f msec, decode %.2f msec (%.2f GB/s)\n",
-	       double(buffer.size() * 8) / double(mesh.indices.size() / 3),
-	       double(csize * 8) / double(mesh.indices.size() / 3),
-	       (middle - start) * 1000,
-	       (end - middle) * 1000,
-	       (double(result.size() * 4) / (1 << 30)) / (end - middle));
+		// reference: each vertex maps to the first identical one in stream order
+		std::vector<unsigned int> first(vertex_count);
+		std::vector<unsigned int> expected(vertex_count);
+		size_t expected_unique = 0;
+
+		for (size_t i = 0; i < vertex_count; ++i)
+		{
+			size_t j = 0;
+			while (memcmp(&vertices[j * vertex_size], &vertices[i * vertex_size], vertex_size) != 0)
+				++j;
+
+			first[i] = unsigned(j);
+			expected[i] = (j == i) ? unsigned(expected_unique++) : expected[j];
+		}
+
+		std::vector<unsigned int> remap(vertex_count);
+		size_t unique = meshopt_generateVertexRemap(&remap[0], NULL, vertex_count, &vertices[0], vertex_count, vertex_size);
+
+		assert(unique == expected_unique);
+		assert(remap == expected);
+
+		std::vector<unsigned int> indices(vertex_count);
+		for (size_t i = 0; i < vertex_count; ++i)
+			indices[i] = unsigned(i);
+
+		std::vector<unsigned int> shadow(vertex_count);
+		meshopt_generateShadowIndexBuffer(&shadow[0], &indices[0], vertex_count, &strided[0], vertex_count, vertex_size, vertex_stride);
+
+		assert(shadow == first);
+
+		(void)unique;
+	}
 }
 
-void encodeIndexCoverage()
+void generateVertexRemapParallelCoverage()
 {
-	// note: 4 6 5 triangle here is a combo-breaker:
-	// we encode it without rotating, a=next, c=next - this means we do *not* bump next to 6
-	// which means that the next triangle can't be encoded via next sequencing!
-	const unsigned int indices[] = {0, 1, 2, 2, 1, 3, 4, 6, 5, 7, 8, 9};
-	const size_t index_count = sizeof(indices) / sizeof(indices[0]);
-	const size_t vertex_count = 10;
+	std::vector<unsigned int> indices;
+	fillCoverageGrid(indices, 150);
 
-	std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(index_count, vertex_count));
-	buffer.resize(meshopt_encodeIndexBuffer(&buffer[0], buffer.size(), indices, index_count));
+	size_t vertex_count = 151 * 151;
 
-	// check that encode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
-	for (size_t i = 0; i <= buffer.size(); ++i)
+	// adjacent grid columns share positions so that the remap has duplicates; 5-float vertices go through the generic hasher
+	for (size_t attributes = 3; attributes <= 5; attributes += 2)
 	{
-		std::vector<unsigned char> shortbuffer(i);
-		size_t result = meshopt_encodeIndexBuffer(i == 0 ? 0 : &shortbuffer[0], i, indices, index_count);
-		(void)result;
+		std::vector<float> vertices(vertex_count * attributes);
 
-		if (i == buffer.size())
-			assert(result == buffer.size());
-		else
-			assert(result == 0);
-	}
+		for (size_t i = 0; i < vertex_count; ++i)
+		{
+			float v[5] = {float(i % 151 / 2), float(i / 151), 0.f, 1.f, float(i % 7 == 0)};
+			memcpy(&vertices[i * attributes], v, sizeof(float) * attributes);
+		}
 
-	// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
-	unsigned int destination[index_count];
+		std::vector<float> unindexed(indices.size() * attributes);
 
-	for (size_t i = 0; i <= buffer.size(); ++i)
-	{
-		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
-		int result = meshopt_decodeIndexBuffer(destination, index_count, i == 0 ? 0 : &shortbuffer[0], i);
-		(void)result;
+		for (size_t i = 0; i < indices.size(); ++i)
+			memcpy(&unindexed[i * attributes], &vertices[indices[i] * attributes], sizeof(float) * attributes);
 
-		if (i == buffer.size())
-			assert(result == 0);
-		else
-			assert(result < 0);
-	}
+		size_t vertex_size = sizeof(float) * attributes;
 
-	// check that decoder doesn't accept extra bytes after a valid stream
-	{
-		std::vector<unsigned char> largebuffer(buffer);
-		largebuffer.push_back(0);
+		// indexed input
+		std::vector<unsigned int> expected(vertex_count);
+		size_t expected_unique = meshopt_generateVertexRemap(&expected[0], &indices[0], indices.size(), &vertices[0], vertex_count, vertex_size);
 
-		int result = meshopt_decodeIndexBuffer(destination, index_count, &largebuffer[0], largebuffer.size());
-		(void)result;
+		std::vector<unsigned int> remap(vertex_count);
 
-		assert(result < 0);
-	}
+		int dispatched = 0;
+		size_t unique = meshopt_generateVertexRemapParallel(&remap[0], &indices[0], indices.size(), &vertices[0], vertex_count, vertex_size, dispatchReverse, &dispatched);
 
-	// check that decoder doesn't accept malformed headers
-	{
-		std::vector<unsigned char> brokenbuffer(buffer);
-		brokenbuffer[0] = 0;
+		assert(unique == expected_unique);
+		assert(remap == expected);
+		assert(dispatched > 0);
 
-		int result = meshopt_decodeIndexBuffer(destination, index_count, &brokenbuffer[0], brokenbuffer.size());
-		(void)result;
+		unique = meshopt_generateVertexRemapParallel(&remap[0], &indices[0], indices.size(), &vertices[0], vertex_count, vertex_size, NULL, NULL);
 
-		assert(result < 0);
+		assert(unique == expected_unique);
+		assert(remap == expected);
+
+		// unindexed input
+		expected.resize(indices.size());
+		expected_unique = meshopt_generateVertexRemap(&expected[0], NULL, indices.size(), &unindexed[0], indices.size(), vertex_size);
+
+		remap.resize(indices.size());
+		unique = meshopt_generateVertexRemapParallel(&remap[0], NULL, indices.size(), &unindexed[0], indices.size(), vertex_size, dispatchReverse, &dispatched);
+
+		assert(unique == expected_unique);
+		assert(remap == expected);
+
+		// vertices that aren't referenced by the index buffer stay unmapped
+		std::vector<unsigned int> half(indices.begin(), indices.begin() + indices.size() / 2);
+		half.resize(half.size() / 3 * 3);
+
+		expected.resize(vertex_count);
+		expected_unique = meshopt_generateVertexRemap(&expected[0], &half[0], half.size(), &vertices[0], vertex_count, vertex_size);
+
+		remap.resize(vertex_count);
+		unique = meshopt_generateVertexRemapParallel(&remap[0], &half[0], half.size(), &vertices[0], vertex_count, vertex_size, dispatchReverse, &dispatched);
+
+		assert(unique == expected_unique);
+		assert(remap == expected);
+
+		(void)unique;
 	}
 }
 
-template <typename PV>
-void packVertex(const Mesh& mesh, const char* pvn)
+void generateVertexRemapMultiCoverage()
 {
-	std::vector<PV> pv(mesh.vertices.size());
-	packMesh(pv, mesh.vertices);
+	const size_t vertex_count = 300;
 
-	size_t csize = compress(pv);
+	// positions are padded with bytes that must be ignored; the last stream is one byte per vertex to exercise partial words
+	std::vector<float> positions(vertex_count * 4);
+	std::vector<unsigned short> normals(vertex_count * 4);
+	std::vector<unsigned char> flags(vertex_count);
 
-	printf("VtxPack%s  : %.1f bits/vertex (post-deflate %.1f bits/vertex)\n", pvn,
-	       double(pv.size() * sizeof(PV) * 8) / double(mesh.vertices.size()),
-	       double(csize * 8) / double(mesh.vertices.size()));
-}
+	const size_t vertex_size = sizeof(float) * 3 + sizeof(unsigned short) * 4 + 1;
+	std::vector<unsigned char> interleaved(vertex_count * vertex_size);
 
-template <typename PV>
-void encodeVertex(const Mesh& mesh, const char* pvn)
-{
-	std::vector<PV> pv(mesh.vertices.size());
-	packMesh(pv, mesh.vertices);
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		unsigned int seed = unsigned(i * 7 % 29);
 
-	// allocate result outside of the timing loop to exclude memset() from decode timing
-	std::vector<PV> result(mesh.vertices.size());
+		float p[4] = {float(seed % 5), float(seed % 3), 0.f, float(i)};
+		unsigned short n[4] = {(unsigned short)(seed % 2), 0, 1, (unsigned short)(seed % 4 == 0)};
+		unsigned char f = (unsigned char)(seed % 7 == 0);
 
-	double start = timestamp();
+		memcpy(&positions[i * 4], p, sizeof(p));
+		memcpy(&normals[i * 4], n, sizeof(n));
+		flags[i] = f;
 
-	std::vector<unsigned char> vbuf(meshopt_encodeVertexBufferBound(mesh.vertices.size(), sizeof(PV)));
-	vbuf.resize(meshopt_encodeVertexBuffer(&vbuf[0], vbuf.size(), &pv[0], mesh.vertices.size(), sizeof(PV)));
+		memcpy(&interleaved[i * vertex_size], p, sizeof(float) * 3);
+		memcpy(&interleaved[i * vertex_size + 12], n, sizeof(n));
+		interleaved[i * vertex_size + 20] = f;
+	}
 
-	double middle = timestamp();
+	meshopt_Stream streams[] = {
+	    {&positions[0], sizeof(float) * 3, sizeof(float) * 4},
+	    {&normals[0], sizeof(unsigned short) * 4, sizeof(unsigned short) * 4},
+	    {&flags[0], 1, 1},
+	};
 
-	int res = meshopt_decodeVertexBuffer(&result[0], mesh.vertices.size(), sizeof(PV), &vbuf[0], vbuf.size());
-	assert(res == 0);
-	(void)res;
+	std::vector<unsigned int> indices(vertex_count * 2);
+	for (size_t i = 0; i < indices.size(); ++i)
+		indices[i] = unsigned(i * 13 % vertex_count);
 
-	double end = timestamp();
+	// unindexed and indexed remap must match the remap of interleaved data
+	std::vector<unsigned int> expected(vertex_count), remap(vertex_count);
 
-	assert(memcmp(&pv[0], &result[0], pv.size() * sizeof(PV)) == 0);
+	size_t expected_unique = meshopt_generateVertexRemap(&expected[0], NULL, vertex_count, &interleaved[0], vertex_count, vertex_size);
+	size_t unique = meshopt_generateVertexRemapMulti(&remap[0], NULL, vertex_count, vertex_count, streams, 3);
 
-	size_t csize = compress(vbuf);
+	assert(unique == expected_unique);
+	assert(remap == expected);
 
-	printf("VtxCodec%1s: %.1f bits/vertex (post-deflate %.1f bits/vertex); encode %.2f msec, decode %.2f msec (%.2f GB/s)\n", pvn,
-	       double(vbuf.size() * 8) / double(mesh.vertices.size()),
-	       double(csize * 8) / double(mesh.vertices.size()),
-	       (middle - start) * 1000,
-	       (end - middle) * 1000,
-	       (double(result.size() * sizeof(PV)) / (1 << 30)) / (end - middle));
+	expected_unique = meshopt_generateVertexRemap(&expected[0], &indices[0], indices.size(), &interleaved[0], vertex_count, vertex_size);
+	unique = meshopt_generateVertexRemapMulti(&remap[0], &indices[0], indices.size(), vertex_count, streams, 3);
+
+	assert(unique == expected_unique);
+	assert(remap == expected);
+
+	// position-only shadow index buffer from the split layout must match the one built from interleaved data
+	std::vector<unsigned int> expected_shadow(indices.size()), shadow(indices.size());
+
+	meshopt_generateShadowIndexBuffer(&expected_shadow[0], &indices[0], indices.size(), &interleaved[0], vertex_count, sizeof(float) * 3, vertex_size);
+	meshopt_generateShadowIndexBufferMulti(&shadow[0], &indices[0], indices.size(), vertex_count, streams, 1);
+
+	assert(shadow == expected_shadow);
+
+	meshopt_generateShadowIndexBuffer(&expected_shadow[0], &indices[0], indices.size(), &interleaved[0], vertex_count, vertex_size, vertex_size);
+	meshopt_generateShadowIndexBufferMulti(&shadow[0], &indices[0], indices.size(), vertex_count, streams, 3);
+
+	assert(shadow == expected_shadow);
+
+	(void)unique;
 }
 
-void encodeVertexCoverage()
+void generateVertexRemapSortCoverage()
 {
-	typedef PackedVertexOct PV;
+	// large inputs with duplicates that are far apart use the sort path; the results must match the table path used by multi-stream remap
+	const size_t vertex_count = (1 << 22) + 2;
 
-	const PV vertices[] =
-	    {
-	        {0, 0, 0, 0, 0, 0, 0},
-	        {300, 0, 0, 0, 0, 500, 0},
-	        {0, 300, 0, 0, 0, 0, 500},
-	        {300, 300, 0, 0, 0, 500, 500},
-	    };
+	std::vector<float> vertices(vertex_count * 3);
 
-	const size_t vertex_count = 4;
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		unsigned int seed = unsigned(i) * 2654435761u % (1 << 20);
 
-	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
-	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), vertices, vertex_count, sizeof(PV)));
+		vertices[i * 3 + 0] = float(seed % 1024);
+		vertices[i * 3 + 1] = float(seed / 1024);
+		vertices[i * 3 + 2] = (i % 5 == 0) ? float(i) : 0.f;
+	}
 
-	// check that encode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
-	for (size_t i = 0; i <= buffer.size(); ++i)
+	meshopt_Stream stream = {&vertices[0], sizeof(float) * 3, sizeof(float) * 3};
+
+	std::vector<unsigned int> indices(vertex_count);
+	for (size_t i = 0; i < vertex_count; ++i)
+		indices[i] = unsigned(vertex_count - 1 - i);
+
+	std::vector<unsigned int> expected(vertex_count), remap(vertex_count);
+
+	size_t expected_unique = meshopt_generateVertexRemapMulti(&expected[0], NULL, vertex_count, vertex_count, &stream, 1);
+	size_t unique = meshopt_generateVertexRemap(&remap[0], NULL, vertex_count, &vertices[0], vertex_count, sizeof(float) * 3);
+
+	assert(unique == expected_unique);
+	assert(unique > vertex_count / 5 && unique < vertex_count / 2);
+	assert(remap == expected);
+
+	expected_unique = meshopt_generateVertexRemapMulti(&expected[0], &indices[0], vertex_count, vertex_count, &stream, 1);
+	unique = meshopt_generateVertexRemap(&remap[0], &indices[0], vertex_count, &vertices[0], vertex_count, sizeof(float) * 3);
+
+	assert(unique == expected_unique);
+	assert(remap == expected);
+
+	// vertices that aren't referenced must stay unassigned; the sort path uses the start of the remap table as scratch space
+	size_t partial_count = vertex_count / 6 * 3;
+
+	expected_unique = meshopt_generateVertexRemapMulti(&expected[0], &indices[0], partial_count, vertex_count, &stream, 1);
+	unique = meshopt_generateVertexRemap(&remap[0], &indices[0], partial_count, &vertices[0], vertex_count, sizeof(float) * 3);
+
+	assert(unique == expected_unique);
+	assert(remap == expected);
+	assert(remap[0] == ~0u);
+
+	// parallel remap sorts the same inputs, with every pass split into tasks
+	int dispatched = 0;
+
+	unique = meshopt_generateVertexRemapParallel(&remap[0], &indices[0], partial_count, &vertices[0], vertex_count, sizeof(float) * 3, dispatchReverse, &dispatched);
+
+	assert(unique == expected_unique);
+	assert(remap == expected);
+	assert(dispatched > 0);
+
+	expected_unique = meshopt_generateVertexRemapMulti(&expected[0], NULL, vertex_count, vertex_count, &stream, 1);
+	unique = meshopt_generateVertexRemapParallel(&remap[0], NULL, vertex_count, &vertices[0], vertex_count, sizeof(float) * 3, dispatchReverse, &dispatched);
+
+	assert(unique == expected_unique);
+	assert(remap == expected);
+
+	// every vertex repeats ~64 times, so runs of equal hash bits are long enough to be sorted before scanning
+	for (size_t i = 0; i < vertex_count; ++i)
 	{
-		std::vector<unsigned char> shortbuffer(i);
-		size_t result = meshopt_encodeVertexBuffer(i == 0 ? 0 : &shortbuffer[0], i, vertices, vertex_count, sizeof(PV));
-		(void)result;
+		unsigned int seed = unsigned(i) * 2654435761u % (1 << 16);
 
-		if (i == buffer.size())
-			assert(result == buffer.size());
-		else
-			assert(result == 0);
+		vertices[i * 3 + 0] = float(seed % 256);
+		vertices[i * 3 + 1] = float(seed / 256);
+		vertices[i * 3 + 2] = 0.f;
 	}
 
-	// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
-	PV destination[vertex_count];
+	expected_unique = meshopt_generateVertexRemapMulti(&expected[0], &indices[0], vertex_count, vertex_count, &stream, 1);
+	unique = meshopt_generateVertexRemap(&remap[0], &indices[0], vertex_count, &vertices[0], vertex_count, sizeof(float) * 3);
 
-	for (size_t i = 0; i <= buffer.size(); ++i)
+	assert(unique == expected_unique);
+	assert(unique == 1 << 16);
+	assert(remap == expected);
+}
+
+void generateVertexRemapToleranceCoverage()
+{
+	// values are multiples of 1/8 and tolerances are powers of two so that all cell computations are exact
+	const size_t vertex_count = 600;
+	const size_t components = 4;
+
+	std::vector<float> vertices(vertex_count * (components + 1));
+
+	for (size_t i = 0; i < vertex_count; ++i)
 	{
-		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
-		int result = meshopt_decodeVertexBuffer(destination, vertex_count, sizeof(PV), i == 0 ? 0 : &shortbuffer[0], i);
-		(void)result;
+		unsigned int seed = unsigned(i) * 2654435761u;
 
-		if (i == buffer.size())
-			assert(result == 0);
-		else
-			assert(result < 0);
+		vertices[i * 5 + 0] = float(seed % 40) / 8.f;
+		vertices[i * 5 + 1] = float((seed >> 8) % 24) / 8.f - 1.f;
+		vertices[i * 5 + 2] = float((seed >> 16) % 3);
+		vertices[i * 5 + 3] = float((seed >> 20) % 16) / 8.f;
+		vertices[i * 5 + 4] = float(i); // padding, not compared
 	}
 
-	// check that decoder doesn't accept extra bytes after a valid stream
+	const float tolerances[components] = {0.25f, 0.125f, 0, 0.5f};
+
+	std::vector<unsigned int> indices(vertex_count * 2);
+	for (size_t i = 0; i < indices.size(); ++i)
+		indices[i] = unsigned(i * 17 % vertex_count);
+
+	for (int indexed = 0; indexed < 2; ++indexed)
 	{
-		std::vector<unsigned char> largebuffer(buffer);
-		largebuffer.push_back(0);
+		size_t index_count = indexed ? indices.size() : vertex_count;
 
-		int result = meshopt_decodeVertexBuffer(destination, vertex_count, sizeof(PV), &largebuffer[0], largebuffer.size());
-		(void)result;
+		// reference: each vertex is merged into the earliest representative within tolerance in first reference order
+		std::vector<unsigned int> expected(vertex_count, ~0u);
+		std::vector<unsigned int> representatives;
 
-		assert(result < 0);
+		for (size_t i = 0; i < index_count; ++i)
+		{
+			unsigned int index = indexed ? indices[i] : unsigned(i);
+
+			if (expected[index] != ~0u)
+				continue;
+
+			size_t r = 0;
+
+			for (; r < representatives.size(); ++r)
+			{
+				const float* a = &vertices[representatives[r] * 5];
+				const float* b = &vertices[index * 5];
+
+				bool match = true;
+				for (size_t k = 0; k < components; ++k)
+					match = match && (tolerances[k] == 0 ? a[k] == b[k] : fabsf(a[k] - b[k]) <= tolerances[k]);
+
+				if (match)
+					break;
+			}
+
+			if (r == representatives.size())
+				representatives.push_back(index);
+
+			expected[index] = unsigned(r);
+		}
+
+		std::vector<unsigned int> remap(vertex_count);
+		size_t unique = meshopt_generateVertexRemapTolerance(&remap[0], indexed ? &indices[0] : NULL, index_count, &vertices[0], vertex_count, sizeof(float) * 5, tolerances, components);
+
+		assert(unique == representatives.size());
+		assert(remap == expected);
+
+		(void)unique;
 	}
 
-	// check that decoder doesn't accept malformed headers
+	// zero tolerance matches exact remap
+	const float zero[components] = {};
+
+	std::vector<float> packed(vertex_count * components);
+	for (size_t i = 0; i < vertex_count; ++i)
+		memcpy(&packed[i * components], &vertices[i * 5], sizeof(float) * components);
+
+	std::vector<unsigned int> expected(vertex_count), remap(vertex_count);
+	size_t expected_unique = meshopt_generateVertexRemap(&expected[0], NULL, vertex_count, &packed[0], vertex_count, sizeof(float) * components);
+	size_t unique = meshopt_generateVertexRemapTolerance(&remap[0], NULL, vertex_count, &vertices[0], vertex_count, sizeof(float) * 5, zero, components);
+
+	assert(unique == expected_unique);
+	assert(remap == expected);
+
+	(void)unique;
+	(void)expected_unique;
+}
+
+void generateVertexRemapExternalCoverage()
+{
+	std::vector<unsigned int> indices;
+	fillCoverageGrid(indices, 60);
+
+	// 20-byte vertices with duplicates from the grid, unindexed
+	std::vector<float> vertices(indices.size() * 5);
+
+	for (size_t i = 0; i < indices.size(); ++i)
 	{
-		std::vector<unsigned char> brokenbuffer(buffer);
-		brokenbuffer[0] = 0;
+		unsigned int v = indices[i];
+		float data[5] = {float(v % 61), float(v / 61), 0.f, float(v % 3), 1.f};
+
+		memcpy(&vertices[i * 5], data, sizeof(data));
+	}
+
+	size_t vertex_count = indices.size();
+	size_t vertex_size = sizeof(float) * 5;
+
+	std::vector<unsigned int> expected(vertex_count);
+	size_t expected_unique = meshopt_generateVertexRemap(&expected[0], NULL, vertex_count, &vertices[0], vertex_count, vertex_size);
+
+	std::vector<float> expected_vertices(expected_unique * 5);
+	meshopt_remapVertexBuffer(&expected_vertices[0], &vertices[0], vertex_count, vertex_size, &expected[0]);
+
+	const size_t partition_counts[] = {1, 3, 16, 1000};
+
+	for (size_t pi = 0; pi < sizeof(partition_counts) / sizeof(partition_counts[0]); ++pi)
+	{
+		size_t partition_count = partition_counts[pi];
+
+		ExternalRemapContext ctx;
+		size_t unique = 0;
+
+		int result = generateVertexRemapExternal(ctx, &unique, &vertices[0], vertex_count, vertex_size, partition_count);
+
+		assert(result == 0);
+		assert(unique == expected_unique);
+		assert(ctx.remap == expected);
+		assert(ctx.unique_vertices.size() == expected_vertices.size() * sizeof(float));
+		assert(memcmp(&ctx.unique_vertices[0], &expected_vertices[0], ctx.unique_vertices.size()) == 0);
+
+		for (size_t i = 0; i < ctx.partition_reads.size(); ++i)
+			assert(ctx.partition_reads[i] <= 1);
 
-		int result = meshopt_decodeVertexBuffer(destination, vertex_count, sizeof(PV), &brokenbuffer[0], brokenbuffer.size());
 		(void)result;
+	}
 
-		assert(result < 0);
+	// callback errors are propagated at every stage
+	ExternalRemapContext ctx;
+
+	for (size_t limit = 0; limit < 8; ++limit)
+	{
+		int result = generateVertexRemapExternal(ctx, NULL, &vertices[0], vertex_count, vertex_size, 4, limit);
+		assert(result == 42);
+		(void)result;
 	}
+
+	// empty input
+	size_t unique = 1;
+	int result = generateVertexRemapExternal(ctx, &unique, &vertices[0], 0, vertex_size, 4);
+
+	assert(result == 0 && unique == 0);
+	assert(ctx.remap.empty() && ctx.unique_vertices.empty());
+	(void)result;
 }
 
 void stripify(const Mesh& mesh)
@@ -935,12 +3259,27 @@ void process(const char* path)
 	stripify(copy);
 	meshlets(copy);
 	shadow(copy);
+	remap(copy);
+	remapTolerance(copy);
+	remapExternal(copy);
 
 	encodeIndex(copy);
+	encodeIndexLevels(copy);
+	encodeIndexSequences(copy);
 	packVertex<PackedVertex>(copy, "");
 	encodeVertex<PackedVertex>(copy, "");
 	encodeVertex<PackedVertexOct>(copy, "O");
 
+	meshopt_encodeVertexVersion(1);
+	encodeVertex<PackedVertex>(copy, "1");
+	encodeVertex<PackedVertexOct>(copy, "O1");
+	meshopt_encodeVertexVersion(0);
+
+	encodeVertexLevels(copy);
+	splitVertex(copy);
+	encodeEntropy(copy);
+	dequantizeVertex(copy);
+
 	simplify(mesh);
 }
 
@@ -960,7 +3299,28 @@ void processDev(const char* path)
 void processCoverage()
 {
 	encodeIndexCoverage();
+	encodeIndexLevelCoverage();
+	encodeIndexChunkedCoverage();
+	encodeIndexRebaseCoverage();
+	encodeIndexSequenceCoverage();
+	encodeEntropyCoverage();
 	encodeVertexCoverage();
+	encodeVertexSeekableCoverage();
+	encodeVertexParallelCoverage();
+	encodeVertexRangeCoverage();
+	encodeVertexDequantizeCoverage();
+	encodeFilterCoverage();
+	encodeVertexStreamCoverage();
+	encodeVertexVersionCoverage();
+	encodeVertexLevelCoverage();
+	encodeVertexSplitCoverage();
+	encodeVertexSizeCoverage();
+	generateVertexRemapCoverage();
+	generateVertexRemapParallelCoverage();
+	generateVertexRemapMultiCoverage();
+	generateVertexRemapSortCoverage();
+	generateVertexRemapToleranceCoverage();
+	generateVertexRemapExternalCoverage();
 }
 
 int main(int argc, char** argv)
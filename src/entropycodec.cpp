@@ -0,0 +1,454 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#include "meshoptimizer.h"
+
+#include <assert.h>
+#include <string.h>
+
+// This work is based on:
+// Jarek Duda. Asymmetric numeral systems: entropy coding combining speed of Huffman coding with compression rate of arithmetic coding. 2013
+// Fabian Giesen. Interleaved entropy coders. 2014
+namespace meshopt
+{
+
+const unsigned char kEntropyHeader = 0xc0;
+
+// data is split into blocks that are coded independently with a separate frequency table; this allows decoding the data incrementally
+const size_t kEntropyBlockSize = 65536;
+
+const unsigned char kEntropyBlockRaw = 0;
+const unsigned char kEntropyBlockRans = 1;
+
+// rANS state is kept in [kRansLow, kRansLow << 16) and is renormalized 16 bits at a time, so each symbol reads at most one word; frequencies are quantized to kRansScaleBits
+const unsigned int kRansScaleBits = 12;
+const unsigned int kRansScale = 1 << kRansScaleBits;
+const unsigned int kRansLow = 1 << 16;
+
+// each block starts with the mode byte; rANS blocks store a bitmap of used symbols, symbol frequencies, payload size and 4 initial states
+const size_t kEntropyTableMaxSize = 32 + 256 * 2;
+const size_t kEntropyBlockMaxOverhead = 1 + kEntropyTableMaxSize + 4 + 16;
+
+static void normalizeFrequencies(unsigned int* freqs, const unsigned int* counts, size_t total)
+{
+	unsigned int sum = 0;
+
+	for (int i = 0; i < 256; ++i)
+	{
+		// every symbol that's present needs a non-zero frequency to be encodable
+		unsigned int f = counts[i] ? unsigned((counts[i] * size_t(kRansScale)) / total) : 0;
+		f += (counts[i] && f == 0);
+
+		freqs[i] = f;
+		sum += f;
+	}
+
+	// rounding makes the sum deviate from the scale slightly; adjust the most frequent symbols since this has the smallest effect on compression
+	while (sum != kRansScale)
+	{
+		int best = 0;
+
+		for (int i = 1; i < 256; ++i)
+			if (freqs[i] > freqs[best])
+				best = i;
+
+		if (sum > kRansScale)
+		{
+			// the most frequent symbol has frequency of at least kRansScale / 256 so this never drops it to 0
+			assert(freqs[best] > 1);
+
+			freqs[best]--;
+			sum--;
+		}
+		else
+		{
+			freqs[best]++;
+			sum++;
+		}
+	}
+}
+
+static void encodeVByte(unsigned char*& data, unsigned int v)
+{
+	// encode 32-bit value in up to 5 7-bit groups
+	do
+	{
+		*data++ = (v & 127) | (v > 127 ? 128 : 0);
+		v >>= 7;
+	} while (v);
+}
+
+static unsigned int decodeVByte(const unsigned char*& data, const unsigned char* data_end)
+{
+	unsigned int result = 0;
+	unsigned int shift = 0;
+
+	// note that this loop always terminates, which is important for malformed data
+	for (int i = 0; i < 5 && data < data_end; ++i)
+	{
+		unsigned char group = *data++;
+		result |= unsigned(group & 127) << shift;
+		shift += 7;
+
+		if (group < 128)
+			break;
+	}
+
+	return result;
+}
+
+static void writeSize(unsigned char* data, size_t size)
+{
+	data[0] = (unsigned char)(size >> 0);
+	data[1] = (unsigned char)(size >> 8);
+	data[2] = (unsigned char)(size >> 16);
+	data[3] = (unsigned char)(size >> 24);
+}
+
+static unsigned int readSize(const unsigned char* data)
+{
+	return unsigned(data[0]) | (unsigned(data[1]) << 8) | (unsigned(data[2]) << 16) | (unsigned(data[3]) << 24);
+}
+
+static void encodeRans(unsigned int& x, unsigned char*& ptr, unsigned int start, unsigned int freq)
+{
+	// symbols that take the entire range don't change the state; this also avoids overflow in x_max below
+	if (freq == kRansScale)
+		return;
+
+	// renormalize so that the state stays in range after encoding the symbol; since x_max >= kRansLow << 4, one word is always enough
+	unsigned int x_max = ((kRansLow >> kRansScaleBits) << 16) * freq;
+
+	if (x >= x_max)
+	{
+		ptr -= 2;
+		ptr[0] = (unsigned char)(x & 0xff);
+		ptr[1] = (unsigned char)((x >> 8) & 0xff);
+		x >>= 16;
+	}
+
+	x = ((x / freq) << kRansScaleBits) + (x % freq) + start;
+}
+
+// encodes the block into scratch memory that's large enough to hold kEntropyBlockMaxOverhead + size bytes; returns 0 if rANS doesn't make the block smaller
+static size_t encodeBlockRans(unsigned char* scratch, const unsigned char* data, size_t size)
+{
+	unsigned int counts[256] = {};
+
+	for (size_t i = 0; i < size; ++i)
+		counts[data[i]]++;
+
+	unsigned int freqs[256];
+	normalizeFrequencies(freqs, counts, size);
+
+	unsigned int starts[256];
+	unsigned int start = 0;
+
+	for (int i = 0; i < 256; ++i)
+	{
+		starts[i] = start;
+		start += freqs[i];
+	}
+
+	// rANS is a LIFO coder so we encode symbols in reverse order, writing the payload backwards from the end of scratch memory
+	unsigned char* payload_end = scratch + kEntropyBlockMaxOverhead + size;
+	unsigned char* payload_limit = scratch + kEntropyBlockMaxOverhead;
+	unsigned char* ptr = payload_end;
+
+	unsigned int x[4] = {kRansLow, kRansLow, kRansLow, kRansLow};
+
+	for (size_t i = size; i > 0; --i)
+	{
+		// each symbol writes at most 2 bytes; bail out early once the payload gets larger than the input
+		if (ptr - payload_limit < 2)
+			return 0;
+
+		unsigned char s = data[i - 1];
+
+		encodeRans(x[(i - 1) & 3], ptr, starts[s], freqs[s]);
+	}
+
+	if (ptr - payload_limit < 16)
+		return 0;
+
+	// write final states in reverse so that the decoder reads state 0 first
+	for (int k = 3; k >= 0; --k)
+	{
+		ptr -= 4;
+		writeSize(ptr, x[k]);
+	}
+
+	size_t payload_size = payload_end - ptr;
+
+	// write block header right before the payload
+	unsigned char table[kEntropyTableMaxSize];
+	unsigned char* table_end = table + 32;
+
+	memset(table, 0, 32);
+
+	for (int i = 0; i < 256; ++i)
+		if (freqs[i])
+		{
+			table[i / 8] |= (unsigned char)(1 << (i % 8));
+			encodeVByte(table_end, freqs[i] - 1);
+		}
+
+	size_t table_size = table_end - table;
+
+	if (1 + table_size + 4 + payload_size >= 1 + size)
+		return 0;
+
+	unsigned char* header = ptr - (1 + table_size + 4);
+	assert(header >= scratch);
+
+	header[0] = kEntropyBlockRans;
+	memcpy(header + 1, table, table_size);
+	writeSize(header + 1 + table_size, payload_size);
+
+	// move the encoded block to the beginning of scratch memory
+	size_t result = payload_end - header;
+	memmove(scratch, header, result);
+
+	return result;
+}
+
+static unsigned char decodeRans(unsigned int& x, const unsigned char*& ptr, const unsigned int* table)
+{
+	// each table entry stores the symbol, the offset of the slot from the start of the symbol range, and the frequency minus 1
+	unsigned int e = table[x & (kRansScale - 1)];
+
+	x = ((e >> 20) + 1) * (x >> kRansScaleBits) + ((e >> 8) & 4095);
+
+	// valid states never need more than one word to renormalize; malformed states are detected after decoding the block
+	// renormalization is branchless since for compressible data it's not predictable
+	unsigned int v = ptr[0] | (ptr[1] << 8);
+	int n = x < kRansLow;
+
+	x = n ? (x << 16) | v : x;
+	ptr += n * 2;
+
+	return (unsigned char)(e & 255);
+}
+
+static const unsigned char* decodeBlockRans(unsigned char* destination, size_t size, const unsigned char* data, const unsigned char* data_end, unsigned int* table)
+{
+	if (size_t(data_end - data) < 32)
+		return 0;
+
+	const unsigned char* bitmap = data;
+	data += 32;
+
+	unsigned int start = 0;
+
+	for (int i = 0; i < 256; ++i)
+		if (bitmap[i / 8] & (1 << (i % 8)))
+		{
+			unsigned int freq = decodeVByte(data, data_end) + 1;
+
+			// frequencies must fill the table exactly
+			if (freq > kRansScale - start)
+				return 0;
+
+			for (unsigned int j = 0; j < freq; ++j)
+				table[start + j] = unsigned(i) | (j << 8) | ((freq - 1) << 20);
+
+			start += freq;
+		}
+
+	if (start != kRansScale)
+		return 0;
+
+	if (size_t(data_end - data) < 4)
+		return 0;
+
+	size_t payload_size = readSize(data);
+	data += 4;
+
+	if (size_t(data_end - data) < payload_size || payload_size < 16)
+		return 0;
+
+	const unsigned char* ptr = data;
+	const unsigned char* payload_end = data + payload_size;
+
+	// states are kept in local variables since stores to destination could otherwise alias them
+	unsigned int x0 = readSize(ptr + 0);
+	unsigned int x1 = readSize(ptr + 4);
+	unsigned int x2 = readSize(ptr + 8);
+	unsigned int x3 = readSize(ptr + 12);
+	ptr += 16;
+
+	size_t i = 0;
+
+	// fast path: each group of 4 symbols reads at most 8 bytes, so we only need to check bounds once per group
+	for (; i + 4 <= size && payload_end - ptr >= 8; i += 4)
+	{
+		unsigned char s0 = decodeRans(x0, ptr, table);
+		unsigned char s1 = decodeRans(x1, ptr, table);
+		unsigned char s2 = decodeRans(x2, ptr, table);
+		unsigned char s3 = decodeRans(x3, ptr, table);
+
+		destination[i + 0] = s0;
+		destination[i + 1] = s1;
+		destination[i + 2] = s2;
+		destination[i + 3] = s3;
+	}
+
+	unsigned int x[4] = {x0, x1, x2, x3};
+
+	// slow path: decode remaining symbols with bounds checks
+	for (; i < size; ++i)
+	{
+		unsigned int& xk = x[i & 3];
+		unsigned int e = table[xk & (kRansScale - 1)];
+
+		destination[i] = (unsigned char)(e & 255);
+		xk = ((e >> 20) + 1) * (xk >> kRansScaleBits) + ((e >> 8) & 4095);
+
+		if (xk < kRansLow)
+		{
+			if (payload_end - ptr < 2)
+				return 0;
+
+			xk = (xk << 16) | ptr[0] | (ptr[1] << 8);
+			ptr += 2;
+		}
+	}
+
+	// encoder starts with all states equal to kRansLow, so after decoding all symbols we must end up in the same state
+	if (x[0] != kRansLow || x[1] != kRansLow || x[2] != kRansLow || x[3] != kRansLow)
+		return 0;
+
+	if (ptr != payload_end)
+		return 0;
+
+	return payload_end;
+}
+
+static int decodeEntropy(unsigned char* destination, size_t data_size, const unsigned char* buffer, size_t buffer_size, meshopt_EntropySink sink, void* sink_context)
+{
+	// when sink is specified, blocks are decoded into scratch memory and passed to the sink
+	meshopt_Allocator allocator;
+
+	unsigned int* table = allocator.allocate<unsigned int>(kRansScale);
+	unsigned char* scratch = sink ? allocator.allocate<unsigned char>(kEntropyBlockSize) : 0;
+
+	const unsigned char* data = buffer;
+	const unsigned char* data_end = buffer + buffer_size;
+
+	if (buffer_size < 1)
+		return -2;
+
+	if (*data++ != kEntropyHeader)
+		return -1;
+
+	for (size_t offset = 0; offset < data_size; offset += kEntropyBlockSize)
+	{
+		size_t size = (offset + kEntropyBlockSize < data_size) ? kEntropyBlockSize : data_size - offset;
+		unsigned char* target = sink ? scratch : destination + offset;
+
+		if (data == data_end)
+			return -2;
+
+		unsigned char mode = *data++;
+
+		if (mode == kEntropyBlockRaw)
+		{
+			if (size_t(data_end - data) < size)
+				return -2;
+
+			memcpy(target, data, size);
+			data += size;
+		}
+		else if (mode == kEntropyBlockRans)
+		{
+			data = decodeBlockRans(target, size, data, data_end, table);
+			if (!data)
+				return -2;
+		}
+		else
+		{
+			return -1;
+		}
+
+		if (sink)
+		{
+			int result = sink(sink_context, scratch, size);
+			if (result != 0)
+				return result;
+		}
+	}
+
+	if (data != data_end)
+		return -3;
+
+	return 0;
+}
+
+} // namespace meshopt
+
+size_t meshopt_encodeEntropy(unsigned char* buffer, size_t buffer_size, const unsigned char* data, size_t data_size)
+{
+	using namespace meshopt;
+
+	if (buffer_size < 1)
+		return 0;
+
+	meshopt_Allocator allocator;
+
+	unsigned char* scratch = allocator.allocate<unsigned char>(kEntropyBlockMaxOverhead + kEntropyBlockSize);
+
+	unsigned char* output = buffer;
+	unsigned char* output_end = buffer + buffer_size;
+
+	*output++ = kEntropyHeader;
+
+	for (size_t offset = 0; offset < data_size; offset += kEntropyBlockSize)
+	{
+		size_t size = (offset + kEntropyBlockSize < data_size) ? kEntropyBlockSize : data_size - offset;
+
+		size_t block_size = encodeBlockRans(scratch, data + offset, size);
+
+		// blocks that don't compress are stored as is, which bounds the size of the output
+		if (block_size == 0)
+		{
+			if (size_t(output_end - output) < 1 + size)
+				return 0;
+
+			*output++ = kEntropyBlockRaw;
+			memcpy(output, data + offset, size);
+			output += size;
+		}
+		else
+		{
+			if (size_t(output_end - output) < block_size)
+				return 0;
+
+			memcpy(output, scratch, block_size);
+			output += block_size;
+		}
+	}
+
+	assert(output <= buffer + buffer_size);
+
+	return output - buffer;
+}
+
+size_t meshopt_encodeEntropyBound(size_t data_size)
+{
+	using namespace meshopt;
+
+	size_t block_count = (data_size + kEntropyBlockSize - 1) / kEntropyBlockSize;
+
+	// worst case is every block stored as is
+	return 1 + block_count + data_size;
+}
+
+int meshopt_decodeEntropy(unsigned char* destination, size_t data_size, const unsigned char* buffer, size_t buffer_size)
+{
+	return meshopt::decodeEntropy(destination, data_size, buffer, buffer_size, 0, 0);
+}
+
+int meshopt_decodeEntropyStream(size_t data_size, const unsigned char* buffer, size_t buffer_size, meshopt_EntropySink sink, void* sink_context)
+{
+	assert(sink);
+
+	return meshopt::decodeEntropy(0, data_size, buffer, buffer_size, sink, sink_context);
+}
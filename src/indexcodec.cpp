@@ -11,6 +11,11 @@ namespace meshopt
 {
 
 const unsigned char kIndexHeader = 0xe0;
+const unsigned char kIndexHeaderChunked = 0x08;
+const unsigned char kSequenceHeader = 0xd0;
+
+// chunked streams reset codec state every kIndexChunkTriangles triangles so that chunks can be encoded and decoded independently
+const size_t kIndexChunkTriangles = 16384;
 
 typedef unsigned int VertexFifo[16];
 typedef unsigned int EdgeFifo[16][2];
@@ -26,6 +31,27 @@ static const unsigned char kCodeAuxEncodingTable[16] = {
     0, 0, // last two entries aren't used for encoding
 };
 
+// decoding of edge triangles keyed on fec: vertex fifo distance, wrap mask and extra slot, followed by flags (1 = next, 2 = free)
+// the vertex is read from vertexfifo[((offset - distance) & mask) | slot], where slot 16 holds next and slot 17 holds the free index
+static const unsigned char kDecodeEdgeTable[16][4] = {
+    {1, 0, 16, 1},
+    {2, 15, 0, 0},
+    {3, 15, 0, 0},
+    {4, 15, 0, 0},
+    {5, 15, 0, 0},
+    {6, 15, 0, 0},
+    {7, 15, 0, 0},
+    {8, 15, 0, 0},
+    {9, 15, 0, 0},
+    {10, 15, 0, 0},
+    {11, 15, 0, 0},
+    {12, 15, 0, 0},
+    {13, 15, 0, 0},
+    {14, 15, 0, 0},
+    {15, 15, 0, 0},
+    {16, 0, 17, 2},
+};
+
 static int rotateTriangle(unsigned int a, unsigned int b, unsigned int c, unsigned int next)
 {
 	(void)a;
@@ -105,7 +131,7 @@ static unsigned int decodeVByte(const unsigned char*& data)
 	for (int i = 0; i < 4; ++i)
 	{
 		unsigned char group = *data++;
-		result |= (group & 127) << shift;
+		result |= unsigned(group & 127) << shift;
 		shift += 7;
 
 		if (group < 128)
@@ -144,146 +170,456 @@ static int getCodeAuxIndex(unsigned char v, const unsigned char* table)
 	return -1;
 }
 
-static void writeTriangle(void* destination, size_t offset, size_t index_size, unsigned int a, unsigned int b, unsigned int c)
+static void encodeSequenceSymbol(unsigned char*& data, unsigned int v, int baseline)
 {
-	if (index_size == 2)
+	// the first byte stores the baseline in the low bit followed by 6 bits of value; the rest of the value is encoded in up to 4 7-bit groups
+	*data++ = (unsigned char)(((v & 63) << 1) | baseline | (v > 63 ? 128 : 0));
+	v >>= 6;
+
+	while (v)
 	{
-		static_cast<unsigned short*>(destination)[offset + 0] = static_cast<unsigned short>(a);
-		static_cast<unsigned short*>(destination)[offset + 1] = static_cast<unsigned short>(b);
-		static_cast<unsigned short*>(destination)[offset + 2] = static_cast<unsigned short>(c);
+		*data++ = (v & 127) | (v > 127 ? 128 : 0);
+		v >>= 7;
 	}
-	else
+}
+
+template <typename T>
+static void decodeSequenceByte(T* destination, unsigned char code, unsigned int* last)
+{
+	// single byte code 1 (baseline 1, zero delta) is reserved for the restart index
+	if (code == 1)
 	{
-		static_cast<unsigned int*>(destination)[offset + 0] = a;
-		static_cast<unsigned int*>(destination)[offset + 1] = b;
-		static_cast<unsigned int*>(destination)[offset + 2] = c;
+		*destination = T(~0u);
+		return;
 	}
-}
 
-} // namespace meshopt
+	int baseline = code & 1;
+	unsigned int v = code >> 1;
+	unsigned int d = (v >> 1) ^ -int(v & 1);
 
-size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
+	unsigned int index = last[baseline] + d;
+
+	last[baseline] = index;
+	*destination = T(index);
+}
+
+template <typename T>
+static int decodeIndexSequence(T* destination, size_t index_count, const unsigned char* buffer, size_t buffer_size)
 {
-	using namespace meshopt;
+	// the minimum valid encoding is header, 1 byte per index and a 4-byte tail
+	if (buffer_size < 1 + index_count + 4)
+		return -2;
 
-	assert(index_count % 3 == 0);
+	if (buffer[0] != kSequenceHeader)
+		return -1;
+
+	unsigned int last[2] = {};
+
+	// since we store a 4-byte tail at the end, index data has to begin before data_safe_end
+	const unsigned char* data = buffer + 1;
+	const unsigned char* data_safe_end = buffer + buffer_size - 4;
+
+	size_t i = 0;
+
+	while (i < index_count)
+	{
+		// make sure we have enough data to read
+		// each index reads at most 5 bytes of data; there's a 4 byte tail after data_safe_end
+		// after this we can be sure we can read without extra bounds checks
+		if (data >= data_safe_end)
+			return -2;
 
+		// fast path: next 4 indices are encoded with one byte each, which is the most common case for well-optimized data
+		unsigned int groups;
+		memcpy(&groups, data, 4);
+
+		if ((groups & 0x80808080) == 0 && i + 4 <= index_count)
+		{
+			decodeSequenceByte(destination + i + 0, data[0], last);
+			decodeSequenceByte(destination + i + 1, data[1], last);
+			decodeSequenceByte(destination + i + 2, data[2], last);
+			decodeSequenceByte(destination + i + 3, data[3], last);
+
+			data += 4;
+			i += 4;
+			continue;
+		}
+
+		unsigned char lead = *data++;
+
+		if (lead < 128)
+		{
+			decodeSequenceByte(destination + i, lead, last);
+			i++;
+			continue;
+		}
+
+		// slow path: up to 4 extra bytes
+		// note that this loop always terminates, which is important for malformed data
+		int baseline = lead & 1;
+		unsigned int v = (lead >> 1) & 63;
+		unsigned int shift = 6;
+
+		for (int k = 0; k < 4; ++k)
+		{
+			unsigned char group = *data++;
+			v |= unsigned(group & 127) << shift;
+			shift += 7;
+
+			if (group < 128)
+				break;
+		}
+
+		unsigned int d = (v >> 1) ^ -int(v & 1);
+		unsigned int index = last[baseline] + d;
+
+		last[baseline] = index;
+		destination[i] = T(index);
+		i++;
+	}
+
+	// fast path may read symbols from the tail of malformed streams, so we might end up past data_safe_end
+	if (data > data_safe_end)
+		return -2;
+
+	// we should've read all data bytes and stopped at the boundary between data and tail
+	if (data != data_safe_end)
+		return -3;
+
+	return 0;
+}
+
+template <typename T, bool Rebase>
+static int decodeIndexBuffer(T* destination, size_t index_count, const unsigned char* buffer, size_t buffer_size, unsigned int seed, unsigned int base)
+{
 	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
 	if (buffer_size < 1 + index_count / 3 + 16)
-		return 0;
+		return -2;
 
-	buffer[0] = kIndexHeader;
+	if (buffer[0] != kIndexHeader)
+		return -1;
 
 	EdgeFifo edgefifo;
 	memset(edgefifo, -1, sizeof(edgefifo));
 
-	VertexFifo vertexfifo;
+	// extra slots 16 and 17 hold next and the last free index for branchless fifo reads in the edge path
+	unsigned int vertexfifo[18];
 	memset(vertexfifo, -1, sizeof(vertexfifo));
 
 	size_t edgefifooffset = 0;
 	size_t vertexfifooffset = 0;
 
-	unsigned int next = 0;
-	unsigned int last = 0;
+	// seed is the initial value for next and last; it's 0 for regular streams and is stored for each chunk in chunked streams
+	unsigned int next = seed;
+	unsigned int last = seed;
 
-	unsigned char* code = buffer + 1;
-	unsigned char* data = code + index_count / 3;
-	unsigned char* data_safe_end = buffer + buffer_size - 16;
+	// bitwise or of all rebased indices; this is cheaper than checking the range of each index
+	unsigned int range = 0;
 
-	// use static encoding table; it's possible to pack the result and then build an optimal table and repack
-	// for now we keep it simple and use the table that has been generated based on symbol frequency on a training mesh set
-	const unsigned char* codeaux_table = kCodeAuxEncodingTable;
+	// since we store 16-byte codeaux table at the end, triangle data has to begin before data_safe_end
+	const unsigned char* code = buffer + 1;
+	const unsigned char* data = code + index_count / 3;
+	const unsigned char* data_safe_end = buffer + buffer_size - 16;
+
+	const unsigned char* codeaux_table = data_safe_end;
 
 	for (size_t i = 0; i < index_count; i += 3)
 	{
-		// make sure we have enough space to write a triangle
-		// each triangle writes at most 16 bytes: 1b for codeaux and 5b for each free index
-		// after this we can be sure we can write without extra bounds checks
+		// make sure we have enough data to read for a triangle
+		// each triangle reads at most 16 bytes of data: 1b for codeaux and 5b for each free index
+		// after this we can be sure we can read without extra bounds checks
 		if (data > data_safe_end)
-			return 0;
+			return -2;
 
-		int fer = getEdgeFifo(edgefifo, indices[i + 0], indices[i + 1], indices[i + 2], edgefifooffset);
+		unsigned char codetri = *code++;
 
-		if (fer >= 0 && (fer >> 2) < 15)
+		if (codetri < 0xf0)
 		{
-			const unsigned int* order = kTriangleIndexOrder[fer & 3];
+			int fe = codetri >> 4;
+
+			// fifo reads are wrapped around 16 entry buffer
+			unsigned int a = edgefifo[(edgefifooffset - 1 - fe) & 15][0];
+			unsigned int b = edgefifo[(edgefifooffset - 1 - fe) & 15][1];
+
+			// note: this is the most common path in the entire decoder
+			// fec values aren't predictable, so instead of branching or relying on cmov we select c with a memory load
+			// vertex fifo has two extra slots for next and the free index, and the table maps fec to the slot to read
+			const unsigned char* decode = kDecodeEdgeTable[codetri & 15];
 
-			unsigned int a = indices[i + order[0]], b = indices[i + order[1]], c = indices[i + order[2]];
+			// single-byte free indices are decoded speculatively; longer ones take a separate branch that's rarely taken
+			// note that we need to update the last index since free indices are delta-encoded
+			int fecf = decode[3] >> 1;
+			unsigned int lead = *data;
+
+			if (fecf & (lead >> 7))
+				last = decodeIndex(data, next, last);
+			else
+			{
+				last += ((lead >> 1) ^ -int(lead & 1)) & (0u - fecf);
+				data += fecf;
+			}
 
-			// encode edge index and vertex fifo index, next or free index
-			int fe = fer >> 2;
-			int fc = getVertexFifo(vertexfifo, c, vertexfifooffset);
+			vertexfifo[16] = next;
+			vertexfifo[17] = last;
 
-			int fec = (fc >= 1 && fc < 15) ? fc : (c == next) ? (next++, 0) : 15;
+			unsigned int c = vertexfifo[((vertexfifooffset - decode[0]) & decode[1]) | decode[2]];
 
-			*code++ = static_cast<unsigned char>((fe << 4) | fec);
+			next += decode[3] & 1;
 
-			// note that we need to update the last index since free indices are delta-encoded
-			if (fec == 15)
-				encodeIndex(data, c, next, last), last = c;
+			// output triangle
+			destination[i + 0] = T(Rebase ? a - base : a);
+			destination[i + 1] = T(Rebase ? b - base : b);
+			destination[i + 2] = T(Rebase ? c - base : c);
 
-			// we only need to push third vertex since first two are likely already in the vertex fifo
-			if (fec == 0 || fec == 15)
-				pushVertexFifo(vertexfifo, c, vertexfifooffset);
+			if (Rebase)
+				range |= (a - base) | (b - base) | (c - base);
+
+			// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
+			pushVertexFifo(vertexfifo, c, vertexfifooffset, decode[3] != 0);
 
-			// we only need to push two new edges to edge fifo since the third one is already there
 			pushEdgeFifo(edgefifo, c, b, edgefifooffset);
 			pushEdgeFifo(edgefifo, a, c, edgefifooffset);
 		}
 		else
 		{
-			int rotation = rotateTriangle(indices[i + 0], indices[i + 1], indices[i + 2], next);
-			const unsigned int* order = kTriangleIndexOrder[rotation];
+			// fast path: read codeaux from the table; slow path: read a full byte for codeaux instead of using a table lookup
+			bool aux = codetri >= 0xfe;
+
+			unsigned char codeaux = aux ? *data : codeaux_table[codetri & 15];
+			data += aux;
+
+			// note: table can't contain feb/fec=15
+			int fea = codetri == 0xff ? 15 : 0;
+			int feb = codeaux >> 4;
+			int fec = codeaux & 15;
+
+			// fifo reads are wrapped around 16 entry buffer
+			// also note that we increment next for all three vertices before decoding indices - this matches encoder behavior
+			unsigned int a = next;
+			next += fea == 0;
+
+			unsigned int bf = vertexfifo[(vertexfifooffset - feb) & 15];
+			unsigned int b = (feb == 0) ? next : bf;
+
+			int feb0 = feb == 0;
+			next += feb0;
+
+			unsigned int cf = vertexfifo[(vertexfifooffset - fec) & 15];
+			unsigned int c = (fec == 0) ? next : cf;
+
+			int fec0 = fec == 0;
+			next += fec0;
+
+			// note that we need to update the last index since free indices are delta-encoded
+			if (aux)
+			{
+				if (fea == 15)
+					last = a = decodeIndex(data, next, last);
+
+				if (feb == 15)
+					last = b = decodeIndex(data, next, last);
+
+				if (fec == 15)
+					last = c = decodeIndex(data, next, last);
+			}
+
+			// output triangle
+			destination[i + 0] = T(Rebase ? a - base : a);
+			destination[i + 1] = T(Rebase ? b - base : b);
+			destination[i + 2] = T(Rebase ? c - base : c);
+
+			if (Rebase)
+				range |= (a - base) | (b - base) | (c - base);
 
-			unsigned int a = indices[i + order[0]], b = indices[i + order[1]], c = indices[i + order[2]];
+			// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
+			pushVertexFifo(vertexfifo, a, vertexfifooffset);
+			pushVertexFifo(vertexfifo, b, vertexfifooffset, feb0 | (feb == 15));
+			pushVertexFifo(vertexfifo, c, vertexfifooffset, fec0 | (fec == 15));
 
-			int fb = getVertexFifo(vertexfifo, b, vertexfifooffset);
-			int fc = getVertexFifo(vertexfifo, c, vertexfifooffset);
+			pushEdgeFifo(edgefifo, b, a, edgefifooffset);
+			pushEdgeFifo(edgefifo, c, b, edgefifooffset);
+			pushEdgeFifo(edgefifo, a, c, edgefifooffset);
+		}
+	}
+
+	// we should've read all data bytes and stopped at the boundary between data and codeaux table
+	if (data != data_safe_end)
+		return -3;
+
+	// rebased indices must fit into 16 bits; indices below base wrap around and fail this check as well
+	if (Rebase && (range >> 16) != 0)
+		return -4;
+
+	return 0;
+}
+
+} // namespace meshopt
+
+namespace meshopt
+{
+
+struct EncodeIndexState
+{
+	EdgeFifo edgefifo;
+	VertexFifo vertexfifo;
+
+	size_t edgefifooffset;
+	size_t vertexfifooffset;
+
+	unsigned int next;
+};
+
+// fe < 15 means the triangle reuses an edge from the edge fifo and is encoded with fe/fec; fe == 15 means the triangle is encoded with fea/feb/fec
+struct EncodeIndexTriangle
+{
+	int fe;
+	int fea, feb, fec;
+	unsigned int a, b, c;
+};
+
+static void initEncodeIndexState(EncodeIndexState& state, unsigned int seed)
+{
+	memset(state.edgefifo, -1, sizeof(state.edgefifo));
+	memset(state.vertexfifo, -1, sizeof(state.vertexfifo));
+
+	state.edgefifooffset = 0;
+	state.vertexfifooffset = 0;
+
+	state.next = seed;
+}
+
+// computes the codes for the next triangle and advances fifo and next state; this is shared between encoding and codeaux statistics gathering so that they can't diverge
+static void encodeIndexTriangle(EncodeIndexTriangle& tri, EncodeIndexState& state, const unsigned int* indices)
+{
+	unsigned int& next = state.next;
+
+	int fer = getEdgeFifo(state.edgefifo, indices[0], indices[1], indices[2], state.edgefifooffset);
+
+	if (fer >= 0 && (fer >> 2) < 15)
+	{
+		const unsigned int* order = kTriangleIndexOrder[fer & 3];
+
+		unsigned int a = indices[order[0]], b = indices[order[1]], c = indices[order[2]];
+
+		// encode edge index and vertex fifo index, next or free index
+		int fc = getVertexFifo(state.vertexfifo, c, state.vertexfifooffset);
+
+		int fec = (fc >= 1 && fc < 15) ? fc : (c == next) ? (next++, 0) : 15;
+
+		tri.fe = fer >> 2;
+		tri.fea = 0;
+		tri.feb = 0;
+		tri.fec = fec;
+		tri.a = a, tri.b = b, tri.c = c;
+
+		// we only need to push third vertex since first two are likely already in the vertex fifo
+		if (fec == 0 || fec == 15)
+			pushVertexFifo(state.vertexfifo, c, state.vertexfifooffset);
+
+		// we only need to push two new edges to edge fifo since the third one is already there
+		pushEdgeFifo(state.edgefifo, c, b, state.edgefifooffset);
+		pushEdgeFifo(state.edgefifo, a, c, state.edgefifooffset);
+	}
+	else
+	{
+		int rotation = rotateTriangle(indices[0], indices[1], indices[2], next);
+		const unsigned int* order = kTriangleIndexOrder[rotation];
+
+		unsigned int a = indices[order[0]], b = indices[order[1]], c = indices[order[2]];
+
+		int fb = getVertexFifo(state.vertexfifo, b, state.vertexfifooffset);
+		int fc = getVertexFifo(state.vertexfifo, c, state.vertexfifooffset);
+
+		// after rotation, a is almost always equal to next, so we don't waste bits on FIFO encoding for a
+		int fea = (a == next) ? (next++, 0) : 15;
+		int feb = (fb >= 0 && fb < 14) ? (fb + 1) : (b == next) ? (next++, 0) : 15;
+		int fec = (fc >= 0 && fc < 14) ? (fc + 1) : (c == next) ? (next++, 0) : 15;
+
+		tri.fe = 15;
+		tri.fea = fea;
+		tri.feb = feb;
+		tri.fec = fec;
+		tri.a = a, tri.b = b, tri.c = c;
+
+		// only push vertices that weren't already in fifo
+		if (fea == 0 || fea == 15)
+			pushVertexFifo(state.vertexfifo, a, state.vertexfifooffset);
+
+		if (feb == 0 || feb == 15)
+			pushVertexFifo(state.vertexfifo, b, state.vertexfifooffset);
+
+		if (fec == 0 || fec == 15)
+			pushVertexFifo(state.vertexfifo, c, state.vertexfifooffset);
+
+		// all three edges aren't in the fifo; pushing all of them is important so that we can match them for later triangles
+		pushEdgeFifo(state.edgefifo, b, a, state.edgefifooffset);
+		pushEdgeFifo(state.edgefifo, c, b, state.edgefifooffset);
+		pushEdgeFifo(state.edgefifo, a, c, state.edgefifooffset);
+	}
+}
+
+static size_t encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count, const unsigned char* codeaux_table, unsigned int seed)
+{
+	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
+	if (buffer_size < 1 + index_count / 3 + 16)
+		return 0;
 
-			// after rotation, a is almost always equal to next, so we don't waste bits on FIFO encoding for a
-			int fea = (a == next) ? (next++, 0) : 15;
-			int feb = (fb >= 0 && fb < 14) ? (fb + 1) : (b == next) ? (next++, 0) : 15;
-			int fec = (fc >= 0 && fc < 14) ? (fc + 1) : (c == next) ? (next++, 0) : 15;
+	buffer[0] = kIndexHeader;
+
+	EncodeIndexState state;
+	initEncodeIndexState(state, seed);
 
+	unsigned int last = seed;
+
+	unsigned char* code = buffer + 1;
+	unsigned char* data = code + index_count / 3;
+	unsigned char* data_safe_end = buffer + buffer_size - 16;
+
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		// make sure we have enough space to write a triangle
+		// each triangle writes at most 16 bytes: 1b for codeaux and 5b for each free index
+		// after this we can be sure we can write without extra bounds checks
+		if (data > data_safe_end)
+			return 0;
+
+		EncodeIndexTriangle tri;
+		encodeIndexTriangle(tri, state, indices + i);
+
+		if (tri.fe < 15)
+		{
+			*code++ = static_cast<unsigned char>((tri.fe << 4) | tri.fec);
+
+			// note that we need to update the last index since free indices are delta-encoded
+			if (tri.fec == 15)
+				encodeIndex(data, tri.c, state.next, last), last = tri.c;
+		}
+		else
+		{
 			// we encode feb & fec in 4 bits using a table if possible, and as a full byte otherwise
-			unsigned char codeaux = static_cast<unsigned char>((feb << 4) | fec);
+			unsigned char codeaux = static_cast<unsigned char>((tri.feb << 4) | tri.fec);
 			int codeauxindex = getCodeAuxIndex(codeaux, codeaux_table);
 
 			// <14 encodes an index into codeaux table, 14 encodes fea=0, 15 encodes fea=15
-			if (fea == 0 && codeauxindex >= 0 && codeauxindex < 14)
+			if (tri.fea == 0 && codeauxindex >= 0 && codeauxindex < 14)
 			{
 				*code++ = static_cast<unsigned char>((15 << 4) | codeauxindex);
 			}
 			else
 			{
-				*code++ = static_cast<unsigned char>((15 << 4) | 14 | fea);
+				*code++ = static_cast<unsigned char>((15 << 4) | 14 | tri.fea);
 				*data++ = codeaux;
 			}
 
 			// note that we need to update the last index since free indices are delta-encoded
-			if (fea == 15)
-				encodeIndex(data, a, next, last), last = a;
-
-			if (feb == 15)
-				encodeIndex(data, b, next, last), last = b;
-
-			if (fec == 15)
-				encodeIndex(data, c, next, last), last = c;
-
-			// only push vertices that weren't already in fifo
-			if (fea == 0 || fea == 15)
-				pushVertexFifo(vertexfifo, a, vertexfifooffset);
+			if (tri.fea == 15)
+				encodeIndex(data, tri.a, state.next, last), last = tri.a;
 
-			if (feb == 0 || feb == 15)
-				pushVertexFifo(vertexfifo, b, vertexfifooffset);
+			if (tri.feb == 15)
+				encodeIndex(data, tri.b, state.next, last), last = tri.b;
 
-			if (fec == 0 || fec == 15)
-				pushVertexFifo(vertexfifo, c, vertexfifooffset);
-
-			// all three edges aren't in the fifo; pushing all of them is important so that we can match them for later triangles
-			pushEdgeFifo(edgefifo, b, a, edgefifooffset);
-			pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-			pushEdgeFifo(edgefifo, a, c, edgefifooffset);
+			if (tri.fec == 15)
+				encodeIndex(data, tri.c, state.next, last), last = tri.c;
 		}
 	}
 
@@ -308,6 +644,243 @@ size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, cons
 	return data - buffer;
 }
 
+static void countCodeAux(unsigned int* codeaux_counts, const unsigned int* indices, size_t index_count, unsigned int seed)
+{
+	EncodeIndexState state;
+	initEncodeIndexState(state, seed);
+
+	// codeaux values don't depend on the table, so we only need to advance the encoder state without producing any output
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		EncodeIndexTriangle tri;
+		encodeIndexTriangle(tri, state, indices + i);
+
+		// only codeaux values that don't need separately encoded indices can be encoded using a table
+		if (tri.fe == 15 && tri.fea == 0 && tri.feb != 15 && tri.fec != 15)
+			codeaux_counts[(tri.feb << 4) | tri.fec]++;
+	}
+}
+
+static void buildCodeAuxTable(unsigned char* table, const unsigned int* counts)
+{
+	bool used[256] = {};
+
+	// pick 14 most frequent values; ties and unused slots are resolved in favor of the static table order to keep the result deterministic
+	for (int i = 0; i < 14; ++i)
+	{
+		int best = -1;
+
+		for (int j = 0; j < 14; ++j)
+		{
+			unsigned char v = kCodeAuxEncodingTable[j];
+
+			if (!used[v] && (best < 0 || counts[v] > counts[best]))
+				best = v;
+		}
+
+		for (int v = 0; v < 256; ++v)
+			if (!used[v] && counts[v] > counts[best])
+				best = v;
+
+		table[i] = static_cast<unsigned char>(best);
+		used[best] = true;
+	}
+
+	// last two entries aren't used for encoding
+	table[14] = 0;
+	table[15] = 0;
+}
+
+static void writeChunkEntry(unsigned char* data, size_t offset, unsigned int seed)
+{
+	for (int k = 0; k < 4; ++k)
+	{
+		data[k] = (unsigned char)(offset >> (k * 8));
+		data[4 + k] = (unsigned char)(seed >> (k * 8));
+	}
+}
+
+static size_t readChunkOffset(const unsigned char* data)
+{
+	return size_t(data[0]) | (size_t(data[1]) << 8) | (size_t(data[2]) << 16) | (size_t(data[3]) << 24);
+}
+
+static unsigned int readChunkSeed(const unsigned char* data)
+{
+	return unsigned(data[4]) | (unsigned(data[5]) << 8) | (unsigned(data[6]) << 16) | (unsigned(data[7]) << 24);
+}
+
+struct EncodeIndexTasks
+{
+	const unsigned int* indices;
+	size_t index_count;
+
+	// chunk maxima are computed by the first pass and are converted to seeds before the second pass
+	unsigned int* seeds;
+
+	// each chunk is encoded into a separate region of the output buffer; sizes are 0 on failure
+	unsigned char* buffer;
+	size_t* offsets;
+	size_t* sizes;
+};
+
+static void measureIndexTask(void* context, size_t task_index)
+{
+	const EncodeIndexTasks& tasks = *static_cast<const EncodeIndexTasks*>(context);
+
+	size_t index_begin = task_index * kIndexChunkTriangles * 3;
+	size_t index_end = (index_begin + kIndexChunkTriangles * 3 < tasks.index_count) ? index_begin + kIndexChunkTriangles * 3 : tasks.index_count;
+
+	unsigned int result = 0;
+
+	for (size_t i = index_begin; i < index_end; ++i)
+		result = result < tasks.indices[i] ? tasks.indices[i] : result;
+
+	tasks.seeds[task_index] = result;
+}
+
+static void encodeIndexTask(void* context, size_t task_index)
+{
+	const EncodeIndexTasks& tasks = *static_cast<const EncodeIndexTasks*>(context);
+
+	size_t index_begin = task_index * kIndexChunkTriangles * 3;
+	size_t index_end = (index_begin + kIndexChunkTriangles * 3 < tasks.index_count) ? index_begin + kIndexChunkTriangles * 3 : tasks.index_count;
+
+	size_t offset = tasks.offsets[task_index];
+
+	tasks.sizes[task_index] = encodeIndexBuffer(tasks.buffer + offset, tasks.offsets[task_index + 1] - offset, tasks.indices + index_begin, index_end - index_begin, kCodeAuxEncodingTable, tasks.seeds[task_index]);
+}
+
+struct DecodeIndexTasks
+{
+	void* destination;
+	size_t index_count;
+	size_t index_size;
+
+	const unsigned char* buffer;
+	size_t buffer_size;
+	size_t chunk_count;
+
+	// when rebasing, indices are decoded to 16 bits relative to base and are validated to be in range
+	bool rebase;
+	unsigned int base;
+
+	int* results;
+};
+
+static int decodeIndexChunk(const DecodeIndexTasks& tasks, size_t chunk)
+{
+	size_t index_begin = chunk * kIndexChunkTriangles * 3;
+	size_t index_end = (index_begin + kIndexChunkTriangles * 3 < tasks.index_count) ? index_begin + kIndexChunkTriangles * 3 : tasks.index_count;
+
+	const unsigned char* entry = tasks.buffer + 1 + chunk * 8;
+
+	// chunk data has to end where the next chunk starts, or where the stream ends for the last chunk
+	size_t chunk_begin = readChunkOffset(entry);
+	size_t chunk_end = (chunk + 1 < tasks.chunk_count) ? readChunkOffset(entry + 8) : tasks.buffer_size;
+
+	if (chunk_begin > chunk_end || chunk_end > tasks.buffer_size)
+		return -2;
+
+	unsigned int seed = readChunkSeed(entry);
+
+	if (tasks.rebase)
+		return decodeIndexBuffer<unsigned short, true>(static_cast<unsigned short*>(tasks.destination) + index_begin, index_end - index_begin, tasks.buffer + chunk_begin, chunk_end - chunk_begin, seed, tasks.base);
+	else if (tasks.index_size == 2)
+		return decodeIndexBuffer<unsigned short, false>(static_cast<unsigned short*>(tasks.destination) + index_begin, index_end - index_begin, tasks.buffer + chunk_begin, chunk_end - chunk_begin, seed, 0);
+	else
+		return decodeIndexBuffer<unsigned int, false>(static_cast<unsigned int*>(tasks.destination) + index_begin, index_end - index_begin, tasks.buffer + chunk_begin, chunk_end - chunk_begin, seed, 0);
+}
+
+static void decodeIndexTask(void* context, size_t task_index)
+{
+	const DecodeIndexTasks& tasks = *static_cast<const DecodeIndexTasks*>(context);
+
+	tasks.results[task_index] = decodeIndexChunk(tasks, task_index);
+}
+
+static int decodeIndexBufferChunked(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size, bool rebase, unsigned int base, meshopt_Dispatch dispatch, void* dispatch_context)
+{
+	size_t chunk_count = (index_count / 3 + kIndexChunkTriangles - 1) / kIndexChunkTriangles;
+
+	if (buffer_size < 1 + chunk_count * 8)
+		return -2;
+
+	if (chunk_count == 0)
+		return buffer_size == 1 ? 0 : -3;
+
+	// the first chunk has to start right after the table; subsequent chunks are validated by the preceding chunk
+	if (readChunkOffset(buffer + 1) != 1 + chunk_count * 8)
+		return -2;
+
+	DecodeIndexTasks tasks = {};
+	tasks.destination = destination;
+	tasks.index_count = index_count;
+	tasks.index_size = index_size;
+	tasks.buffer = buffer;
+	tasks.buffer_size = buffer_size;
+	tasks.chunk_count = chunk_count;
+	tasks.rebase = rebase;
+	tasks.base = base;
+
+	if (!dispatch)
+	{
+		for (size_t i = 0; i < chunk_count; ++i)
+		{
+			int result = decodeIndexChunk(tasks, i);
+			if (result != 0)
+				return result;
+		}
+
+		return 0;
+	}
+
+	meshopt_Allocator allocator;
+
+	tasks.results = allocator.allocate<int>(chunk_count);
+
+	dispatch(dispatch_context, decodeIndexTask, &tasks, chunk_count);
+
+	for (size_t i = 0; i < chunk_count; ++i)
+		if (tasks.results[i] != 0)
+			return tasks.results[i];
+
+	return 0;
+}
+
+} // namespace meshopt
+
+size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+
+	// use static encoding table that has been generated based on symbol frequency on a training mesh set
+	return encodeIndexBuffer(buffer, buffer_size, indices, index_count, kCodeAuxEncodingTable, 0);
+}
+
+size_t meshopt_encodeIndexBufferLevel(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count, int level)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(level >= 0 && level <= 1);
+
+	if (level == 0)
+		return encodeIndexBuffer(buffer, buffer_size, indices, index_count, kCodeAuxEncodingTable, 0);
+
+	// first pass gathers codeaux statistics without producing any output
+	unsigned int counts[256] = {};
+	countCodeAux(counts, indices, index_count, 0);
+
+	// second pass encodes the data using the optimal table; the table is stored in the stream so decoding doesn't change
+	unsigned char table[16];
+	buildCodeAuxTable(table, counts);
+
+	return encodeIndexBuffer(buffer, buffer_size, indices, index_count, table, 0);
+}
+
 size_t meshopt_encodeIndexBufferBound(size_t index_count, size_t vertex_count)
 {
 	assert(index_count % 3 == 0);
@@ -331,171 +904,261 @@ int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t inde
 	assert(index_count % 3 == 0);
 	assert(index_size == 2 || index_size == 4);
 
-	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
-	if (buffer_size < 1 + index_count / 3 + 16)
-		return -2;
+	if (buffer_size > 0 && buffer[0] == (kIndexHeader | kIndexHeaderChunked))
+		return decodeIndexBufferChunked(destination, index_count, index_size, buffer, buffer_size, false, 0, 0, 0);
 
-	if (buffer[0] != kIndexHeader)
-		return -1;
+	// output loops are specialized for each index size so that the triangle loop doesn't need to switch on it
+	if (index_size == 2)
+		return decodeIndexBuffer<unsigned short, false>(static_cast<unsigned short*>(destination), index_count, buffer, buffer_size, 0, 0);
+	else
+		return decodeIndexBuffer<unsigned int, false>(static_cast<unsigned int*>(destination), index_count, buffer, buffer_size, 0, 0);
+}
 
-	EdgeFifo edgefifo;
-	memset(edgefifo, -1, sizeof(edgefifo));
+int meshopt_decodeIndexBufferRebase(unsigned short* destination, size_t index_count, unsigned int base_vertex, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
 
-	VertexFifo vertexfifo;
-	memset(vertexfifo, -1, sizeof(vertexfifo));
+	assert(index_count % 3 == 0);
 
-	size_t edgefifooffset = 0;
-	size_t vertexfifooffset = 0;
+	// rebasing and range validation happen in the same pass as decoding so that large meshes can be split into 16-bit submeshes without an extra pass
+	if (buffer_size > 0 && buffer[0] == (kIndexHeader | kIndexHeaderChunked))
+		return decodeIndexBufferChunked(destination, index_count, 2, buffer, buffer_size, true, base_vertex, 0, 0);
 
-	unsigned int next = 0;
-	unsigned int last = 0;
+	return decodeIndexBuffer<unsigned short, true>(destination, index_count, buffer, buffer_size, 0, base_vertex);
+}
 
-	// since we store 16-byte codeaux table at the end, triangle data has to begin before data_safe_end
-	const unsigned char* code = buffer + 1;
-	const unsigned char* data = code + index_count / 3;
-	const unsigned char* data_safe_end = buffer + buffer_size - 16;
+size_t meshopt_encodeIndexBufferChunked(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count, meshopt_Dispatch dispatch, void* dispatch_context)
+{
+	using namespace meshopt;
 
-	const unsigned char* codeaux_table = data_safe_end;
+	assert(index_count % 3 == 0);
 
-	for (size_t i = 0; i < index_count; i += 3)
-	{
-		// make sure we have enough data to read for a triangle
-		// each triangle reads at most 16 bytes of data: 1b for codeaux and 5b for each free index
-		// after this we can be sure we can read without extra bounds checks
-		if (data > data_safe_end)
-			return -2;
+	size_t chunk_count = (index_count / 3 + kIndexChunkTriangles - 1) / kIndexChunkTriangles;
 
-		unsigned char codetri = *code++;
+	// chunked streams start with a table that stores the offset and the seed for each chunk
+	size_t table_size = 1 + chunk_count * 8;
 
-		if (codetri < 0xf0)
-		{
-			int fe = codetri >> 4;
+	if (buffer_size < table_size)
+		return 0;
 
-			// fifo reads are wrapped around 16 entry buffer
-			unsigned int a = edgefifo[(edgefifooffset - 1 - fe) & 15][0];
-			unsigned int b = edgefifo[(edgefifooffset - 1 - fe) & 15][1];
+	meshopt_Allocator allocator;
 
-			int fec = codetri & 15;
+	EncodeIndexTasks tasks = {};
+	tasks.indices = indices;
+	tasks.index_count = index_count;
+	tasks.seeds = allocator.allocate<unsigned int>(chunk_count + 1);
+	tasks.buffer = buffer;
+	tasks.offsets = allocator.allocate<size_t>(chunk_count + 1);
+	tasks.sizes = allocator.allocate<size_t>(chunk_count + 1);
 
-			// note: this is the most common path in the entire decoder
-			// inside this if we try to stay branchless (by using cmov/etc.) since these aren't predictable
-			if (fec != 15)
-			{
-				// fifo reads are wrapped around 16 entry buffer
-				unsigned int cf = vertexfifo[(vertexfifooffset - 1 - fec) & 15];
-				unsigned int c = (fec == 0) ? next : cf;
+	if (dispatch)
+	{
+		dispatch(dispatch_context, measureIndexTask, &tasks, chunk_count);
+	}
+	else
+	{
+		for (size_t i = 0; i < chunk_count; ++i)
+			measureIndexTask(&tasks, i);
+	}
 
-				int fec0 = fec == 0;
-				next += fec0;
+	// next is seeded with the first vertex that hasn't been referenced by preceding chunks, which matches serial encoding for meshes optimized with meshopt_optimizeVertexFetch
+	unsigned int max_index = 0;
 
-				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
+	for (size_t i = 0; i < chunk_count; ++i)
+	{
+		unsigned int chunk_max = tasks.seeds[i];
 
-				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
-				pushVertexFifo(vertexfifo, c, vertexfifooffset, fec0);
+		tasks.seeds[i] = i == 0 ? 0 : max_index + 1;
+		max_index = max_index < chunk_max ? chunk_max : max_index;
+	}
 
-				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
-			}
-			else
-			{
-				unsigned int c = 0;
+	// each chunk is encoded into a region that's large enough for the worst case; chunks are compacted afterwards
+	size_t offset = table_size;
 
-				// note that we need to update the last index since free indices are delta-encoded
-				last = c = decodeIndex(data, next, last);
+	for (size_t i = 0; i < chunk_count; ++i)
+	{
+		size_t chunk_index_count = (i + 1 < chunk_count) ? kIndexChunkTriangles * 3 : index_count - i * kIndexChunkTriangles * 3;
 
-				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
+		tasks.offsets[i] = offset;
+		offset += meshopt_encodeIndexBufferBound(chunk_index_count, size_t(max_index) + 1);
+	}
 
-				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
-				pushVertexFifo(vertexfifo, c, vertexfifooffset);
+	tasks.offsets[chunk_count] = offset;
 
-				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
-			}
+	unsigned char* data = buffer + table_size;
+
+	if (offset <= buffer_size)
+	{
+		if (dispatch)
+		{
+			dispatch(dispatch_context, encodeIndexTask, &tasks, chunk_count);
 		}
 		else
 		{
-			// fast path: read codeaux from the table
-			if (codetri < 0xfe)
-			{
-				unsigned char codeaux = codeaux_table[codetri & 15];
+			for (size_t i = 0; i < chunk_count; ++i)
+				encodeIndexTask(&tasks, i);
+		}
 
-				// note: table can't contain feb/fec=15
-				int feb = codeaux >> 4;
-				int fec = codeaux & 15;
+		// chunk regions are ordered and each chunk moves towards the beginning of the buffer so memmove doesn't overwrite chunks that haven't been moved yet
+		for (size_t i = 0; i < chunk_count; ++i)
+		{
+			size_t size = tasks.sizes[i];
 
-				// fifo reads are wrapped around 16 entry buffer
-				// also note that we increment next for all three vertices before decoding indices - this matches encoder behavior
-				unsigned int a = next++;
+			if (size == 0)
+				return 0;
 
-				unsigned int bf = vertexfifo[(vertexfifooffset - feb) & 15];
-				unsigned int b = (feb == 0) ? next : bf;
+			// offsets are 32-bit so chunked streams are limited to 4 GB
+			if (size_t(data - buffer) > 0xffffffff)
+				return 0;
 
-				int feb0 = feb == 0;
-				next += feb0;
+			writeChunkEntry(buffer + 1 + i * 8, data - buffer, tasks.seeds[i]);
 
-				unsigned int cf = vertexfifo[(vertexfifooffset - fec) & 15];
-				unsigned int c = (fec == 0) ? next : cf;
+			memmove(data, buffer + tasks.offsets[i], size);
+			data += size;
+		}
+	}
+	else
+	{
+		// the buffer is too small to encode chunks in parallel; encode them serially using the remaining space, which only requires the buffer to fit the result
+		for (size_t i = 0; i < chunk_count; ++i)
+		{
+			size_t index_begin = i * kIndexChunkTriangles * 3;
+			size_t index_end = (index_begin + kIndexChunkTriangles * 3 < index_count) ? index_begin + kIndexChunkTriangles * 3 : index_count;
 
-				int fec0 = fec == 0;
-				next += fec0;
+			size_t size = encodeIndexBuffer(data, buffer + buffer_size - data, indices + index_begin, index_end - index_begin, kCodeAuxEncodingTable, tasks.seeds[i]);
 
-				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
+			if (size == 0)
+				return 0;
 
-				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
-				pushVertexFifo(vertexfifo, a, vertexfifooffset);
-				pushVertexFifo(vertexfifo, b, vertexfifooffset, feb0);
-				pushVertexFifo(vertexfifo, c, vertexfifooffset, fec0);
+			if (size_t(data - buffer) > 0xffffffff)
+				return 0;
 
-				pushEdgeFifo(edgefifo, b, a, edgefifooffset);
-				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
-			}
-			else
-			{
-				// slow path: read a full byte for codeaux instead of using a table lookup
-				unsigned char codeaux = *data++;
+			writeChunkEntry(buffer + 1 + i * 8, data - buffer, tasks.seeds[i]);
 
-				int fea = codetri == 0xfe ? 0 : 15;
-				int feb = codeaux >> 4;
-				int fec = codeaux & 15;
+			data += size;
+		}
+	}
 
-				// fifo reads are wrapped around 16 entry buffer
-				// also note that we increment next for all three vertices before decoding indices - this matches encoder behavior
-				unsigned int a = (fea == 0) ? next++ : 0;
-				unsigned int b = (feb == 0) ? next++ : vertexfifo[(vertexfifooffset - feb) & 15];
-				unsigned int c = (fec == 0) ? next++ : vertexfifo[(vertexfifooffset - fec) & 15];
+	buffer[0] = kIndexHeader | kIndexHeaderChunked;
 
-				// note that we need to update the last index since free indices are delta-encoded
-				if (fea == 15)
-					last = a = decodeIndex(data, next, last);
+	assert(data <= buffer + buffer_size);
 
-				if (feb == 15)
-					last = b = decodeIndex(data, next, last);
+	return data - buffer;
+}
 
-				if (fec == 15)
-					last = c = decodeIndex(data, next, last);
+size_t meshopt_encodeIndexBufferChunkedBound(size_t index_count, size_t vertex_count)
+{
+	using namespace meshopt;
 
-				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
+	assert(index_count % 3 == 0);
 
-				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
-				pushVertexFifo(vertexfifo, a, vertexfifooffset);
-				pushVertexFifo(vertexfifo, b, vertexfifooffset, (feb == 0) | (feb == 15));
-				pushVertexFifo(vertexfifo, c, vertexfifooffset, (fec == 0) | (fec == 15));
+	size_t chunk_count = (index_count / 3 + kIndexChunkTriangles - 1) / kIndexChunkTriangles;
 
-				pushEdgeFifo(edgefifo, b, a, edgefifooffset);
-				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
-			}
+	// each chunk is a regular stream with its own header and codeaux table, see meshopt_encodeIndexBufferBound
+	return 1 + chunk_count * 8 + chunk_count * (1 + 16) + (meshopt_encodeIndexBufferBound(index_count, vertex_count) - 1 - 16);
+}
+
+int meshopt_decodeIndexBufferParallel(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size, meshopt_Dispatch dispatch, void* dispatch_context)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(index_size == 2 || index_size == 4);
+
+	// regular streams can only be decoded serially since codec state is carried across the entire stream
+	if (buffer_size < 1 || buffer[0] != (kIndexHeader | kIndexHeaderChunked))
+		return meshopt_decodeIndexBuffer(destination, index_count, index_size, buffer, buffer_size);
+
+	return decodeIndexBufferChunked(destination, index_count, index_size, buffer, buffer_size, false, 0, dispatch, dispatch_context);
+}
+
+size_t meshopt_encodeIndexSequence(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
+{
+	using namespace meshopt;
+
+	// the minimum valid encoding is header, 1 byte per index and a 4-byte tail
+	if (buffer_size < 1 + index_count + 4)
+		return 0;
+
+	buffer[0] = kSequenceHeader;
+
+	// each index is delta-encoded relative to one of two baselines; this helps sequences that interleave two ranges, such as line lists and strips
+	unsigned int last[2] = {};
+	int current = 0;
+
+	unsigned char* data = buffer + 1;
+	unsigned char* data_safe_end = buffer + buffer_size - 4;
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		// make sure we have enough space to write
+		// each index writes at most 5 bytes of data; there's a 4 byte tail after data_safe_end
+		// after this we can be sure we can write without extra bounds checks
+		if (data >= data_safe_end)
+			return 0;
+
+		unsigned int index = indices[i];
+
+		// restart index is encoded as a single byte and doesn't update the baselines
+		if (index == ~0u)
+		{
+			*data++ = 1;
+			continue;
 		}
+
+		unsigned int d0 = index - last[0];
+		unsigned int d1 = index - last[1];
+
+		unsigned int v0 = (d0 << 1) ^ (int(d0) >> 31);
+		unsigned int v1 = (d1 << 1) ^ (int(d1) >> 31);
+
+		// switch the baseline when the delta from the current one doesn't fit into a single byte; this keeps baselines in separate index ranges
+		// note that picking the baseline with the smallest delta is worse in practice since both baselines end up tracking the same range
+		current ^= (current ? v1 : v0) >= 64;
+
+		// zero delta from baseline 1 is reserved for the restart index
+		int baseline = (current == 1 && v1 == 0) ? 0 : current;
+
+		encodeSequenceSymbol(data, baseline ? v1 : v0, baseline);
+
+		last[baseline] = index;
 	}
 
-	// we should've read all data bytes and stopped at the boundary between data and codeaux table
-	if (data != data_safe_end)
-		return -3;
+	// make sure we have enough space to write tail
+	if (data > data_safe_end)
+		return 0;
 
-	return 0;
+	// tail is used as padding so that the decoder can read 4 bytes at a time
+	for (int k = 0; k < 4; ++k)
+		*data++ = 0;
+
+	assert(data <= buffer + buffer_size);
+
+	return data - buffer;
+}
+
+size_t meshopt_encodeIndexSequenceBound(size_t index_count, size_t vertex_count)
+{
+	// compute number of bits required for each index
+	unsigned int vertex_bits = 1;
+
+	while (vertex_bits < 32 && vertex_count > size_t(1) << vertex_bits)
+		vertex_bits++;
+
+	// worst-case encoding is a zigzag-encoded delta (vertex_bits + 1 bits) that uses 6 bits in the first byte and 7 bits in each subsequent byte
+	unsigned int vertex_groups = 1 + (vertex_bits + 1) / 7;
+
+	return 1 + index_count * vertex_groups + 4;
+}
+
+int meshopt_decodeIndexSequence(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	assert(index_size == 2 || index_size == 4);
+
+	if (index_size == 2)
+		return decodeIndexSequence(static_cast<unsigned short*>(destination), index_count, buffer, buffer_size);
+	else
+		return decodeIndexSequence(static_cast<unsigned int*>(destination), index_count, buffer, buffer_size);
 }
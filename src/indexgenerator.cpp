@@ -2,48 +2,153 @@
 #include "meshoptimizer.h"
 
 #include <assert.h>
+#include <math.h>
 #include <string.h>
 
+#if defined(__GNUC__)
+#define HASH_PREFETCH(ptr) __builtin_prefetch(ptr)
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <xmmintrin.h>
+#define HASH_PREFETCH(ptr) _mm_prefetch(reinterpret_cast<const char*>(ptr), _MM_HINT_T0)
+#else
+#define HASH_PREFETCH(ptr) (void)(ptr)
+#endif
+
 namespace meshopt
 {
 
+// large tables don't fit into cache; the lookup loop requests buckets for a few vertices ahead to overlap cache misses
+const size_t kHashPrefetchDistance = 16;
+const size_t kHashPrefetchBuckets = 1 << 20;
+
+static unsigned int hashLoad(const unsigned char* data)
+{
+	unsigned int v;
+	memcpy(&v, data, 4);
+	return v;
+}
+
+static unsigned int hashRotate(unsigned int v, int r)
+{
+	return (v << r) | (v >> (32 - r));
+}
+
+static unsigned int hashUpdate(unsigned int h, const unsigned char* key, size_t len)
+{
+	// each word is scrambled independently so that multiplies can overlap; the dependency chain through h is just xor+rotate
+	const unsigned int m = 0xcc9e2d51;
+
+	while (len >= 4)
+	{
+		h = hashRotate(h ^ hashRotate(hashLoad(key) * m, 15), 13);
+
+		key += 4;
+		len -= 4;
+	}
+
+	if (len > 0)
+	{
+		unsigned int k = 0;
+		memcpy(&k, key, len);
+
+		h = hashRotate(h ^ hashRotate(k * m, 15), 13);
+	}
+
+	return h;
+}
+
+static unsigned int hashFinal(unsigned int h)
+{
+	// final mix folds high bits into low bits which are used to select the bucket
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+
+	return h;
+}
+
+static unsigned int hashBytes(const unsigned char* key, size_t len)
+{
+	return hashFinal(hashUpdate(0, key, len));
+}
+
+template <size_t Size>
+static bool equalBytes(const unsigned char* lhs, const unsigned char* rhs)
+{
+	unsigned int diff = 0;
+
+	for (size_t i = 0; i < Size; i += 4)
+		diff |= hashLoad(lhs + i) ^ hashLoad(rhs + i);
+
+	return diff == 0;
+}
+
 struct VertexHasher
 {
-	const char* vertices;
+	const unsigned char* vertices;
 	size_t vertex_size;
 	size_t vertex_stride;
 
 	size_t hash(unsigned int index) const
 	{
-		// MurmurHash2
-		const unsigned int m = 0x5bd1e995;
-		const int r = 24;
+		return hashBytes(vertices + index * vertex_stride, vertex_size);
+	}
 
-		unsigned int h = 0;
-		const char* key = vertices + index * vertex_stride;
-		size_t len = vertex_size;
+	bool equal(unsigned int lhs, unsigned int rhs) const
+	{
+		return memcmp(vertices + lhs * vertex_stride, vertices + rhs * vertex_stride, vertex_size) == 0;
+	}
+};
 
-		while (len >= 4)
-		{
-			unsigned int k = *reinterpret_cast<const unsigned int*>(key);
+// specialization for common vertex sizes; Size is a multiple of 4 so hashing and comparison unroll into a few word operations
+template <size_t Size>
+struct VertexHasherFixed
+{
+	const unsigned char* vertices;
+	size_t vertex_stride;
+
+	size_t hash(unsigned int index) const
+	{
+		return hashBytes(vertices + index * vertex_stride, Size);
+	}
+
+	bool equal(unsigned int lhs, unsigned int rhs) const
+	{
+		return equalBytes<Size>(vertices + lhs * vertex_stride, vertices + rhs * vertex_stride);
+	}
+};
+
+struct VertexStreamHasher
+{
+	const meshopt_Stream* streams;
+	size_t stream_count;
 
-			k *= m;
-			k ^= k >> r;
-			k *= m;
+	size_t hash(unsigned int index) const
+	{
+		unsigned int h = 0;
 
-			h *= m;
-			h ^= k;
+		for (size_t i = 0; i < stream_count; ++i)
+		{
+			const meshopt_Stream& s = streams[i];
 
-			key += 4;
-			len -= 4;
+			h = hashUpdate(h, static_cast<const unsigned char*>(s.data) + index * s.stride, s.size);
 		}
 
-		return h;
+		return hashFinal(h);
 	}
 
 	bool equal(unsigned int lhs, unsigned int rhs) const
 	{
-		return memcmp(vertices + lhs * vertex_stride, vertices + rhs * vertex_stride, vertex_size) == 0;
+		for (size_t i = 0; i < stream_count; ++i)
+		{
+			const meshopt_Stream& s = streams[i];
+			const unsigned char* data = static_cast<const unsigned char*>(s.data);
+
+			if (memcmp(data + lhs * s.stride, data + rhs * s.stride, s.size) != 0)
+				return false;
+		}
+
+		return true;
 	}
 };
 
@@ -83,30 +188,21 @@ static T* hashLookup(T* table, size_t buckets, const Hash& hash, const T& key, c
 	return 0;
 }
 
-} // namespace meshopt
-
-size_t meshopt_generateVertexRemap(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size)
+template <typename Hash>
+static size_t generateVertexRemap(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const Hash& hasher, unsigned int* table, size_t table_size)
 {
-	using namespace meshopt;
-
-	assert(indices || index_count == vertex_count);
-	assert(index_count % 3 == 0);
-	assert(vertex_size > 0 && vertex_size <= 256);
-
-	meshopt_Allocator allocator;
-
-	memset(destination, -1, vertex_count * sizeof(unsigned int));
-
-	VertexHasher hasher = {static_cast<const char*>(vertices), vertex_size, vertex_size};
-
-	size_t table_size = hashBuckets(vertex_count);
-	unsigned int* table = allocator.allocate<unsigned int>(table_size);
-	memset(table, -1, table_size * sizeof(unsigned int));
-
 	unsigned int next_vertex = 0;
 
+	bool prefetch = table_size >= kHashPrefetchBuckets;
+
 	for (size_t i = 0; i < index_count; ++i)
 	{
+		if (prefetch && i + kHashPrefetchDistance < index_count)
+		{
+			unsigned int ahead = indices ? indices[i + kHashPrefetchDistance] : unsigned(i + kHashPrefetchDistance);
+			HASH_PREFETCH(&table[hasher.hash(ahead) & (table_size - 1)]);
+		}
+
 		unsigned int index = indices ? indices[i] : unsigned(i);
 		assert(index < vertex_count);
 
@@ -130,83 +226,1475 @@ size_t meshopt_generateVertexRemap(unsigned int* destination, const unsigned int
 	}
 
 	assert(next_vertex <= vertex_count);
+	(void)vertex_count;
 
 	return next_vertex;
 }
 
-void meshopt_remapVertexBuffer(void* destination, const void* vertices, size_t vertex_count, size_t vertex_size, const unsigned int* remap)
+template <typename Hash>
+static void generateShadowIndexBuffer(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const Hash& hasher, unsigned int* remap, unsigned int* table, size_t table_size)
 {
-	assert(vertex_size > 0 && vertex_size <= 256);
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int index = indices[i];
+		assert(index < vertex_count);
 
-	meshopt_Allocator allocator;
+		if (remap[index] == ~0u)
+		{
+			unsigned int* entry = hashLookup(table, table_size, hasher, index, ~0u);
 
-	// support in-place remap
-	if (destination == vertices)
+			if (*entry == ~0u)
+				*entry = index;
+
+			remap[index] = *entry;
+		}
+
+		destination[i] = remap[index];
+	}
+
+	(void)vertex_count;
+}
+
+static void dispatchTasks(meshopt_Dispatch dispatch, void* dispatch_context, void (*task)(void*, size_t), void* context, size_t task_count)
+{
+	if (dispatch)
 	{
-		char* vertices_copy = allocator.allocate<char>(vertex_count * vertex_size);
-		memcpy(vertices_copy, vertices, vertex_count * vertex_size);
-		vertices = vertices_copy;
+		dispatch(dispatch_context, task, context, task_count);
+	}
+	else
+	{
+		for (size_t i = 0; i < task_count; ++i)
+			task(context, i);
 	}
+}
 
-	for (size_t i = 0; i < vertex_count; ++i)
+// sort-based deduplication replaces random table accesses with a radix sort that streams through memory
+// the first pass distributes vertices by the top hash bits; each bucket is then sorted by the next bits while it's in cache, and runs of equal bits are scanned for duplicates
+// the only large allocation is 8 bytes per vertex for the sorted entries: hashes and per-bucket permutations are stored in the remap table until the result is written
+const size_t kSortRadixBits = 11;
+const size_t kSortRadixBuckets = 1 << kSortRadixBits;
+const size_t kSortRunShift = 32 - 2 * kSortRadixBits;
+const size_t kSortBlockSize = 65536;
+const size_t kSortMinVertices = 1 << 22;
+
+// runs of equal bits longer than this are sorted by the full hash, so that vertices are only compared against distinct vertices with the same hash
+const size_t kSortRunMaxScan = 16;
+
+// key is the vertex hash until the bucket is scanned, after which it's the position of the first equal vertex
+struct SortEntry
+{
+	unsigned int key;
+	unsigned int value;
+};
+
+// positions are indices in first-reference order; order maps them to vertex indices and is NULL for unindexed input
+template <typename Hash>
+struct SortTasks
+{
+	Hash hasher;
+
+	unsigned int* destination;
+	const unsigned int* order;
+	size_t count;
+	size_t block_count;
+
+	SortEntry* sorted;
+	unsigned int* cursors; // block_count * kSortRadixBuckets
+	unsigned int* block_offsets;
+	size_t buckets[kSortRadixBuckets + 1];
+};
+
+template <typename Hash>
+static void sortHashTask(void* context, size_t task_index)
+{
+	SortTasks<Hash>& tasks = *static_cast<SortTasks<Hash>*>(context);
+
+	size_t begin = task_index * kSortBlockSize;
+	size_t end = begin + kSortBlockSize < tasks.count ? begin + kSortBlockSize : tasks.count;
+
+	unsigned int* counts = &tasks.cursors[task_index * kSortRadixBuckets];
+	memset(counts, 0, kSortRadixBuckets * sizeof(unsigned int));
+
+	// destination has at least count elements and isn't needed until the result is written, so it holds the hash of each position
+	for (size_t k = begin; k < end; ++k)
 	{
-		if (remap[i] != ~0u)
-		{
-			assert(remap[i] < vertex_count);
+		// for indexed input, vertices are read in the order of first reference which is scattered through the vertex buffer
+		if (tasks.order && k + kHashPrefetchDistance < end)
+			HASH_PREFETCH(tasks.hasher.vertices + tasks.order[k + kHashPrefetchDistance] * tasks.hasher.vertex_stride);
 
-			memcpy(static_cast<char*>(destination) + remap[i] * vertex_size, static_cast<const char*>(vertices) + i * vertex_size, vertex_size);
-		}
+		unsigned int h = unsigned(tasks.hasher.hash(tasks.order ? tasks.order[k] : unsigned(k)));
+
+		tasks.destination[k] = h;
+		counts[h >> (32 - kSortRadixBits)]++;
 	}
 }
 
-void meshopt_remapIndexBuffer(unsigned int* destination, const unsigned int* indices, size_t index_count, const unsigned int* remap)
+template <typename Hash>
+static void sortScatterTask(void* context, size_t task_index)
 {
-	assert(index_count % 3 == 0);
+	SortTasks<Hash>& tasks = *static_cast<SortTasks<Hash>*>(context);
 
-	for (size_t i = 0; i < index_count; ++i)
+	size_t begin = task_index * kSortBlockSize;
+	size_t end = begin + kSortBlockSize < tasks.count ? begin + kSortBlockSize : tasks.count;
+
+	// blocks scatter into disjoint ranges in block order, so each bucket lists its vertices in increasing position
+	unsigned int* cursors = &tasks.cursors[task_index * kSortRadixBuckets];
+
+	for (size_t k = begin; k < end; ++k)
 	{
-		unsigned int index = indices ? indices[i] : unsigned(i);
-		assert(remap[index] != ~0u);
+		unsigned int h = tasks.destination[k];
+		SortEntry& entry = tasks.sorted[cursors[h >> (32 - kSortRadixBits)]++];
 
-		destination[i] = remap[index];
+		entry.key = h;
+		entry.value = unsigned(k);
 	}
 }
 
-void meshopt_generateShadowIndexBuffer(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, size_t vertex_stride)
+// entries in a bucket are in position order, so ordering ties by entry index keeps equal hashes in the order of first reference; heap sort doesn't need extra memory
+static bool sortEntryLess(const SortEntry* entries, unsigned int l, unsigned int r)
 {
-	using namespace meshopt;
+	return entries[l].key < entries[r].key || (entries[l].key == entries[r].key && l < r);
+}
 
-	assert(indices);
-	assert(index_count % 3 == 0);
-	assert(vertex_size > 0 && vertex_size <= 256);
-	assert(vertex_size <= vertex_stride);
+static void sortSiftDown(unsigned int* perm, size_t root, size_t count, const SortEntry* entries)
+{
+	for (;;)
+	{
+		size_t child = root * 2 + 1;
 
-	meshopt_Allocator allocator;
+		if (child >= count)
+			break;
 
-	unsigned int* remap = allocator.allocate<unsigned int>(vertex_count);
-	memset(remap, -1, vertex_count * sizeof(unsigned int));
+		if (child + 1 < count && sortEntryLess(entries, perm[child], perm[child + 1]))
+			child++;
 
-	VertexHasher hasher = {static_cast<const char*>(vertices), vertex_size, vertex_stride};
+		if (!sortEntryLess(entries, perm[root], perm[child]))
+			break;
 
-	size_t table_size = hashBuckets(vertex_count);
-	unsigned int* table = allocator.allocate<unsigned int>(table_size);
-	memset(table, -1, table_size * sizeof(unsigned int));
+		unsigned int t = perm[root];
+		perm[root] = perm[child];
+		perm[child] = t;
 
-	for (size_t i = 0; i < index_count; ++i)
+		root = child;
+	}
+}
+
+static void sortRunByKey(unsigned int* perm, size_t count, const SortEntry* entries)
+{
+	for (size_t i = count / 2; i > 0; --i)
+		sortSiftDown(perm, i - 1, count, entries);
+
+	for (size_t i = count - 1; i > 0; --i)
 	{
-		unsigned int index = indices[i];
-		assert(index < vertex_count);
+		unsigned int t = perm[0];
+		perm[0] = perm[i];
+		perm[i] = t;
 
-		if (remap[index] == ~0u)
+		sortSiftDown(perm, 0, i, entries);
+	}
+}
+
+template <typename Hash>
+static void sortBucketTask(void* context, size_t task_index)
+{
+	SortTasks<Hash>& tasks = *static_cast<SortTasks<Hash>*>(context);
+
+	SortEntry* entries = tasks.sorted + tasks.buckets[task_index];
+	size_t count = tasks.buckets[task_index + 1] - tasks.buckets[task_index];
+
+	// hashes of this bucket's range of positions have been scattered already, so the range is reused for a permutation that sorts the bucket by the next bits
+	unsigned int* perm = tasks.destination + tasks.buckets[task_index];
+
+	unsigned int histogram[kSortRadixBuckets];
+	memset(histogram, 0, sizeof(histogram));
+
+	for (size_t i = 0; i < count; ++i)
+		histogram[(entries[i].key >> kSortRunShift) & (kSortRadixBuckets - 1)]++;
+
+	unsigned int offset = 0;
+
+	for (size_t i = 0; i < kSortRadixBuckets; ++i)
+	{
+		unsigned int bucket_count = histogram[i];
+		histogram[i] = offset;
+		offset += bucket_count;
+	}
+
+	// the pass is stable, so vertices in each run stay in the order of first reference
+	for (size_t i = 0; i < count; ++i)
+		perm[histogram[(entries[i].key >> kSortRunShift) & (kSortRadixBuckets - 1)]++] = unsigned(i);
+
+	const unsigned int* order = tasks.order;
+	const unsigned char* vertices = tasks.hasher.vertices;
+	size_t vertex_stride = tasks.hasher.vertex_stride;
+
+	for (size_t begin = 0; begin < count;)
+	{
+		unsigned int run = entries[perm[begin]].key >> kSortRunShift;
+
+		size_t end = begin + 1;
+		while (end < count && (entries[perm[end]].key >> kSortRunShift) == run)
+			++end;
+
+		// long runs are sorted so that equal hashes are adjacent and each group of equal hashes is scanned separately; short runs are scanned as a whole
+		bool sorted = end - begin > kSortRunMaxScan;
+
+		if (sorted)
+			sortRunByKey(perm + begin, end - begin, entries);
+
+		for (size_t group = begin; group < end;)
 		{
-			unsigned int* entry = hashLookup(table, table_size, hasher, index, ~0u);
+			size_t group_end = end;
 
-			if (*entry == ~0u)
-				*entry = index;
+			if (sorted)
+			{
+				group_end = group + 1;
+				while (group_end < end && entries[perm[group_end]].key == entries[perm[group]].key)
+					++group_end;
+			}
 
-			remap[index] = *entry;
+			// vertices in the group are compared against distinct vertices of the group seen so far, which are moved to the front of the group
+			size_t unique = 0;
+
+			for (size_t i = group; i < group_end; ++i)
+			{
+				// entries are scattered over the entire input, so for indexed input the order entry of upcoming vertices is requested before the vertex itself
+				if (order && i + 2 * kHashPrefetchDistance < count)
+					HASH_PREFETCH(&order[entries[perm[i + 2 * kHashPrefetchDistance]].value]);
+
+				if (i + kHashPrefetchDistance < count)
+				{
+					unsigned int ahead = entries[perm[i + kHashPrefetchDistance]].value;
+					HASH_PREFETCH(vertices + (order ? order[ahead] : ahead) * vertex_stride);
+				}
+
+				SortEntry& entry = entries[perm[i]];
+				unsigned int vertex = order ? order[entry.value] : entry.value;
+
+				size_t j = 0;
+
+				for (; j < unique; ++j)
+				{
+					const SortEntry& first = entries[perm[group + j]];
+
+					if (first.key == entry.key && tasks.hasher.equal(order ? order[first.value] : first.value, vertex))
+						break;
+				}
+
+				// keys of distinct vertices are compared until the end of the group, so they are replaced afterwards
+				if (j == unique)
+				{
+					unsigned int k = perm[i];
+					perm[i] = perm[group + unique];
+					perm[group + unique] = k;
+					unique++;
+				}
+				else
+					entry.key = entries[perm[group + j]].value;
+			}
+
+			for (size_t j = 0; j < unique; ++j)
+				entries[perm[group + j]].key = entries[perm[group + j]].value;
+
+			group = group_end;
 		}
 
-		destination[i] = remap[index];
+		begin = end;
+	}
+}
+
+template <typename Hash>
+static void sortFirstTask(void* context, size_t task_index)
+{
+	SortTasks<Hash>& tasks = *static_cast<SortTasks<Hash>*>(context);
+
+	size_t begin = task_index * kSortBlockSize;
+	size_t end = begin + kSortBlockSize < tasks.count ? begin + kSortBlockSize : tasks.count;
+
+	// until the result is written, destination is indexed by position and holds the position of the first equal vertex
+	for (size_t i = begin; i < end; ++i)
+		tasks.destination[tasks.sorted[i].value] = tasks.sorted[i].key;
+}
+
+template <typename Hash>
+static void sortCountTask(void* context, size_t task_index)
+{
+	SortTasks<Hash>& tasks = *static_cast<SortTasks<Hash>*>(context);
+
+	size_t begin = task_index * kSortBlockSize;
+	size_t end = begin + kSortBlockSize < tasks.count ? begin + kSortBlockSize : tasks.count;
+
+	unsigned int unique = 0;
+
+	for (size_t k = begin; k < end; ++k)
+		unique += tasks.destination[k] == k;
+
+	tasks.block_offsets[task_index] = unique;
+}
+
+template <typename Hash>
+static void sortAssignTask(void* context, size_t task_index)
+{
+	SortTasks<Hash>& tasks = *static_cast<SortTasks<Hash>*>(context);
+
+	size_t begin = task_index * kSortBlockSize;
+	size_t end = begin + kSortBlockSize < tasks.count ? begin + kSortBlockSize : tasks.count;
+
+	unsigned int next_vertex = tasks.block_offsets[task_index];
+
+	for (size_t k = begin; k < end; ++k)
+		if (tasks.destination[k] == k)
+			tasks.destination[k] = next_vertex++;
+}
+
+template <typename Hash>
+static void sortResolveTask(void* context, size_t task_index)
+{
+	SortTasks<Hash>& tasks = *static_cast<SortTasks<Hash>*>(context);
+
+	size_t begin = task_index * kSortBlockSize;
+	size_t end = begin + kSortBlockSize < tasks.count ? begin + kSortBlockSize : tasks.count;
+
+	// first vertices have new indices now, so every entry can look up its result; destination is only read here and written in the next pass
+	for (size_t i = begin; i < end; ++i)
+		tasks.sorted[i].key = tasks.destination[tasks.sorted[i].key];
+}
+
+template <typename Hash>
+static void sortWriteTask(void* context, size_t task_index)
+{
+	SortTasks<Hash>& tasks = *static_cast<SortTasks<Hash>*>(context);
+
+	size_t begin = task_index * kSortBlockSize;
+	size_t end = begin + kSortBlockSize < tasks.count ? begin + kSortBlockSize : tasks.count;
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		const SortEntry& entry = tasks.sorted[i];
+
+		tasks.destination[tasks.order ? tasks.order[entry.value] : entry.value] = entry.key;
+	}
+}
+
+template <typename Hash>
+static size_t generateVertexRemapSorted(unsigned int* destination, const unsigned int* order, size_t count, size_t vertex_count, const Hash& hasher, meshopt_Allocator& allocator, meshopt_Dispatch dispatch, void* dispatch_context)
+{
+	SortTasks<Hash> tasks;
+	tasks.hasher = hasher;
+	tasks.destination = destination;
+	tasks.order = order;
+	tasks.count = count;
+	tasks.block_count = (count + kSortBlockSize - 1) / kSortBlockSize;
+
+	tasks.sorted = allocator.allocate<SortEntry>(count);
+	tasks.cursors = allocator.allocate<unsigned int>(tasks.block_count * kSortRadixBuckets);
+	tasks.block_offsets = allocator.allocate<unsigned int>(tasks.block_count);
+
+	dispatchTasks(dispatch, dispatch_context, sortHashTask<Hash>, &tasks, tasks.block_count);
+
+	// convert per-block bucket counts into scatter cursors; buckets are laid out one after another, blocks in order within each bucket
+	size_t offset = 0;
+
+	for (size_t b = 0; b < kSortRadixBuckets; ++b)
+	{
+		tasks.buckets[b] = offset;
+
+		for (size_t i = 0; i < tasks.block_count; ++i)
+		{
+			unsigned int block_count = tasks.cursors[i * kSortRadixBuckets + b];
+			tasks.cursors[i * kSortRadixBuckets + b] = unsigned(offset);
+			offset += block_count;
+		}
+	}
+
+	assert(offset == count);
+	tasks.buckets[kSortRadixBuckets] = offset;
+
+	dispatchTasks(dispatch, dispatch_context, sortScatterTask<Hash>, &tasks, tasks.block_count);
+	dispatchTasks(dispatch, dispatch_context, sortBucketTask<Hash>, &tasks, kSortRadixBuckets);
+
+	dispatchTasks(dispatch, dispatch_context, sortFirstTask<Hash>, &tasks, tasks.block_count);
+	dispatchTasks(dispatch, dispatch_context, sortCountTask<Hash>, &tasks, tasks.block_count);
+
+	// new indices are assigned in the order of first reference, which matches the hash table path
+	unsigned int next_vertex = 0;
+
+	for (size_t i = 0; i < tasks.block_count; ++i)
+	{
+		unsigned int block_unique = tasks.block_offsets[i];
+		tasks.block_offsets[i] = next_vertex;
+		next_vertex += block_unique;
 	}
+
+	dispatchTasks(dispatch, dispatch_context, sortAssignTask<Hash>, &tasks, tasks.block_count);
+	dispatchTasks(dispatch, dispatch_context, sortResolveTask<Hash>, &tasks, tasks.block_count);
+
+	// for indexed input, vertices that aren't referenced must stay unassigned; their entries were used as scratch space
+	if (order)
+		memset(destination, -1, vertex_count * sizeof(unsigned int));
+
+	dispatchTasks(dispatch, dispatch_context, sortWriteTask<Hash>, &tasks, tasks.block_count);
+
+	return next_vertex;
+}
+
+// table lookups are cheap when duplicate vertices are stored close to each other, which is true for most meshes even if they are large
+const size_t kSortProbeSamples = 256;
+const size_t kSortProbeWindow = 32;
+
+template <typename Hash>
+static bool hasVertexLocality(size_t vertex_count, const Hash& hasher)
+{
+	if (vertex_count <= kSortProbeWindow)
+		return true;
+
+	size_t local = 0;
+
+	for (size_t s = 0; s < kSortProbeSamples; ++s)
+	{
+		size_t i = kSortProbeWindow + (vertex_count - kSortProbeWindow) / kSortProbeSamples * s;
+
+		for (size_t j = i - kSortProbeWindow; j < i; ++j)
+			if (hasher.equal(unsigned(j), unsigned(i)))
+			{
+				local++;
+				break;
+			}
+	}
+
+	return local * 8 >= kSortProbeSamples;
+}
+
+template <typename Hash>
+static size_t generateVertexRemapAuto(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const Hash& hasher, meshopt_Allocator& allocator)
+{
+	// once the hash table is much larger than the cache and duplicates are scattered, sorting hashes is faster than looking them up
+	if (vertex_count >= kSortMinVertices && !hasVertexLocality(vertex_count, hasher))
+	{
+		unsigned int* order = 0;
+		size_t count = vertex_count;
+
+		// for indexed input, vertices are processed in the order of first reference, which is the order the table path assigns new indices in
+		if (indices)
+		{
+			order = allocator.allocate<unsigned int>(vertex_count);
+			count = 0;
+
+			for (size_t i = 0; i < index_count; ++i)
+			{
+				unsigned int index = indices[i];
+				assert(index < vertex_count);
+
+				if (destination[index] == ~0u)
+				{
+					destination[index] = 0;
+					order[count++] = index;
+				}
+			}
+		}
+
+		return generateVertexRemapSorted(destination, order, count, vertex_count, hasher, allocator, NULL, NULL);
+	}
+
+	size_t table_size = hashBuckets(vertex_count);
+	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+	memset(table, -1, table_size * sizeof(unsigned int));
+
+	return generateVertexRemap(destination, indices, index_count, vertex_count, hasher, table, table_size);
+}
+
+// tolerance welding locates candidates on a grid with cells that are twice the tolerance, so that every vertex within tolerance is in one of 2 cells per axis
+const size_t kToleranceGridComponents = 3;
+
+struct VertexTolerance
+{
+	const float* vertices;
+	size_t vertex_stride_float;
+	const float* tolerances;
+	size_t component_count;
+
+	size_t grid[kToleranceGridComponents];
+	float scale[kToleranceGridComponents];
+	size_t grid_count;
+
+	void cell(unsigned int index, int* cells, int* neighbors) const
+	{
+		const float* v = vertices + index * vertex_stride_float;
+
+		for (size_t j = 0; j < grid_count; ++j)
+		{
+			float x = v[grid[j]] * scale[j];
+
+			// out of range values are clamped which keeps cells of nearby vertices at most 1 apart; NaN fails both comparisons and ends up in the lowest cell
+			float f = x > -1e9f ? (x < 1e9f ? floorf(x) : 1e9f) : -1e9f;
+			float r = x - f;
+
+			cells[j] = int(f);
+			neighbors[j] = r < 0.5f ? -1 : 1;
+		}
+	}
+
+	unsigned int hash(unsigned int index, const int* cells) const
+	{
+		const float* v = vertices + index * vertex_stride_float;
+
+		unsigned int h = hashUpdate(0, reinterpret_cast<const unsigned char*>(cells), grid_count * sizeof(int));
+
+		// components without tolerance must match exactly so they are hashed as is; other tolerant components are only compared
+		for (size_t i = 0; i < component_count; ++i)
+			if (tolerances[i] == 0)
+				h = hashUpdate(h, reinterpret_cast<const unsigned char*>(&v[i]), sizeof(float));
+
+		return hashFinal(h);
+	}
+
+	bool equal(unsigned int lhs, unsigned int rhs) const
+	{
+		const float* lv = vertices + lhs * vertex_stride_float;
+		const float* rv = vertices + rhs * vertex_stride_float;
+
+		for (size_t i = 0; i < component_count; ++i)
+		{
+			// binary equal components always match, which keeps duplicate NaNs merged like meshopt_generateVertexRemap does
+			if (memcmp(&lv[i], &rv[i], sizeof(float)) == 0)
+				continue;
+
+			float d = lv[i] - rv[i];
+
+			if (tolerances[i] == 0 || !(d <= tolerances[i] && d >= -tolerances[i]))
+				return false;
+		}
+
+		return true;
+	}
+};
+
+static size_t generateVertexRemapTolerance(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const VertexTolerance& tolerance, unsigned int* table, size_t table_size)
+{
+	size_t hashmod = table_size - 1;
+	unsigned int next_vertex = 0;
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int index = indices ? indices[i] : unsigned(i);
+		assert(index < vertex_count);
+
+		if (destination[index] != ~0u)
+			continue;
+
+		int cells[kToleranceGridComponents];
+		int neighbors[kToleranceGridComponents];
+		tolerance.cell(index, cells, neighbors);
+
+		unsigned int best = ~0u;
+		size_t home = 0;
+
+		// representatives within tolerance can be in any combination of the home and the neighboring cell on each axis; the earliest one wins
+		for (size_t mask = 0; mask < (size_t(1) << tolerance.grid_count); ++mask)
+		{
+			int probe_cells[kToleranceGridComponents];
+
+			for (size_t j = 0; j < tolerance.grid_count; ++j)
+				probe_cells[j] = cells[j] + ((mask >> j) & 1 ? neighbors[j] : 0);
+
+			size_t bucket = tolerance.hash(index, probe_cells) & hashmod;
+
+			if (mask == 0)
+				home = bucket;
+
+			// cells don't have separate keys, so the entire probe sequence up to the first empty bucket needs to be checked
+			for (size_t probe = 0; table[bucket] != ~0u; ++probe)
+			{
+				assert(probe <= hashmod);
+
+				unsigned int item = table[bucket];
+
+				if (destination[item] < (best == ~0u ? ~0u : destination[best]) && tolerance.equal(item, index))
+					best = item;
+
+				bucket = (bucket + probe + 1) & hashmod;
+			}
+		}
+
+		if (best != ~0u)
+		{
+			destination[index] = destination[best];
+		}
+		else
+		{
+			for (size_t probe = 0; table[home] != ~0u; ++probe)
+				home = (home + probe + 1) & hashmod;
+
+			table[home] = index;
+			destination[index] = next_vertex++;
+		}
+	}
+
+	assert(next_vertex <= vertex_count);
+	(void)vertex_count;
+
+	return next_vertex;
+}
+
+// parallel remap splits vertices into partitions by the top bits of the hash; equal vertices always land in the same partition
+const size_t kRemapPartitionBits = 6;
+const size_t kRemapPartitions = 1 << kRemapPartitionBits;
+const size_t kRemapBlockSize = 16384;
+
+template <typename Hash>
+struct RemapPartitionHasher
+{
+	const Hash* hasher;
+	const unsigned int* order;
+	const unsigned int* hashes;
+
+	size_t hash(unsigned int key) const
+	{
+		return hashes[key];
+	}
+
+	bool equal(unsigned int lhs, unsigned int rhs) const
+	{
+		return hasher->equal(order ? order[lhs] : lhs, order ? order[rhs] : rhs);
+	}
+};
+
+// all per-vertex arrays are indexed by position in first-reference order; order maps it to vertex index and is NULL for unindexed input
+template <typename Hash>
+struct RemapTasks
+{
+	Hash hasher;
+
+	unsigned int* destination;
+	const unsigned int* order;
+	size_t count;
+	size_t block_count;
+
+	unsigned int* hashes; // hash of each vertex, replaced with the position of the first equal vertex during partition lookup
+	unsigned int* cursors; // block_count * kRemapPartitions
+	unsigned int* partitioned;
+	size_t partition_offsets[kRemapPartitions + 1];
+	size_t table_offsets[kRemapPartitions + 1];
+	unsigned int* tables;
+	unsigned int* block_offsets;
+};
+
+template <typename Hash>
+static void remapHashTask(void* context, size_t task_index)
+{
+	RemapTasks<Hash>& tasks = *static_cast<RemapTasks<Hash>*>(context);
+
+	size_t begin = task_index * kRemapBlockSize;
+	size_t end = begin + kRemapBlockSize < tasks.count ? begin + kRemapBlockSize : tasks.count;
+
+	unsigned int* counts = &tasks.cursors[task_index * kRemapPartitions];
+	memset(counts, 0, kRemapPartitions * sizeof(unsigned int));
+
+	for (size_t k = begin; k < end; ++k)
+	{
+		unsigned int h = unsigned(tasks.hasher.hash(tasks.order ? tasks.order[k] : unsigned(k)));
+
+		tasks.hashes[k] = h;
+		counts[h >> (32 - kRemapPartitionBits)]++;
+	}
+}
+
+template <typename Hash>
+static void remapScatterTask(void* context, size_t task_index)
+{
+	RemapTasks<Hash>& tasks = *static_cast<RemapTasks<Hash>*>(context);
+
+	size_t begin = task_index * kRemapBlockSize;
+	size_t end = begin + kRemapBlockSize < tasks.count ? begin + kRemapBlockSize : tasks.count;
+
+	// blocks scatter into disjoint ranges in block order, so each partition lists its vertices in increasing position
+	unsigned int* cursors = &tasks.cursors[task_index * kRemapPartitions];
+
+	for (size_t k = begin; k < end; ++k)
+		tasks.partitioned[cursors[tasks.hashes[k] >> (32 - kRemapPartitionBits)]++] = unsigned(k);
+}
+
+template <typename Hash>
+static void remapPartitionTask(void* context, size_t task_index)
+{
+	RemapTasks<Hash>& tasks = *static_cast<RemapTasks<Hash>*>(context);
+
+	unsigned int* table = tasks.tables + tasks.table_offsets[task_index];
+	size_t table_size = tasks.table_offsets[task_index + 1] - tasks.table_offsets[task_index];
+
+	memset(table, -1, table_size * sizeof(unsigned int));
+
+	RemapPartitionHasher<Hash> hasher = {&tasks.hasher, tasks.order, tasks.hashes};
+
+	size_t begin = tasks.partition_offsets[task_index];
+	size_t end = tasks.partition_offsets[task_index + 1];
+
+	const unsigned char* vertices = tasks.hasher.vertices;
+	size_t vertex_stride = tasks.hasher.vertex_stride;
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		// partition members are spread over the entire input so most accesses miss the cache; hashes, buckets and vertices of upcoming members are requested in stages
+		if (i + 3 * kHashPrefetchDistance < end)
+			HASH_PREFETCH(&tasks.hashes[tasks.partitioned[i + 3 * kHashPrefetchDistance]]);
+
+		if (i + 2 * kHashPrefetchDistance < end)
+			HASH_PREFETCH(&table[tasks.hashes[tasks.partitioned[i + 2 * kHashPrefetchDistance]] & (table_size - 1)]);
+
+		if (i + kHashPrefetchDistance < end)
+		{
+			unsigned int ahead = tasks.partitioned[i + kHashPrefetchDistance];
+			unsigned int first = table[tasks.hashes[ahead] & (table_size - 1)];
+
+			HASH_PREFETCH(vertices + (tasks.order ? tasks.order[ahead] : ahead) * vertex_stride);
+
+			if (first != ~0u)
+				HASH_PREFETCH(vertices + (tasks.order ? tasks.order[first] : first) * vertex_stride);
+		}
+
+		unsigned int k = tasks.partitioned[i];
+
+		unsigned int* entry = hashLookup(table, table_size, hasher, k, ~0u);
+
+		if (*entry == ~0u)
+			*entry = k;
+
+		// the hash of k is no longer needed since lookups only hash the key
+		tasks.hashes[k] = *entry;
+	}
+}
+
+template <typename Hash>
+static void remapCountTask(void* context, size_t task_index)
+{
+	RemapTasks<Hash>& tasks = *static_cast<RemapTasks<Hash>*>(context);
+
+	size_t begin = task_index * kRemapBlockSize;
+	size_t end = begin + kRemapBlockSize < tasks.count ? begin + kRemapBlockSize : tasks.count;
+
+	unsigned int unique = 0;
+
+	for (size_t k = begin; k < end; ++k)
+		unique += tasks.hashes[k] == k;
+
+	tasks.block_offsets[task_index] = unique;
+}
+
+template <typename Hash>
+static void remapAssignTask(void* context, size_t task_index)
+{
+	RemapTasks<Hash>& tasks = *static_cast<RemapTasks<Hash>*>(context);
+
+	size_t begin = task_index * kRemapBlockSize;
+	size_t end = begin + kRemapBlockSize < tasks.count ? begin + kRemapBlockSize : tasks.count;
+
+	unsigned int next_vertex = tasks.block_offsets[task_index];
+
+	for (size_t k = begin; k < end; ++k)
+		if (tasks.hashes[k] == k)
+			tasks.destination[tasks.order ? tasks.order[k] : k] = next_vertex++;
+}
+
+template <typename Hash>
+static void remapResolveTask(void* context, size_t task_index)
+{
+	RemapTasks<Hash>& tasks = *static_cast<RemapTasks<Hash>*>(context);
+
+	size_t begin = task_index * kRemapBlockSize;
+	size_t end = begin + kRemapBlockSize < tasks.count ? begin + kRemapBlockSize : tasks.count;
+
+	for (size_t k = begin; k < end; ++k)
+	{
+		unsigned int first = tasks.hashes[k];
+
+		if (first != k)
+			tasks.destination[tasks.order ? tasks.order[k] : k] = tasks.destination[tasks.order ? tasks.order[first] : first];
+	}
+}
+
+template <typename Hash>
+static size_t generateVertexRemapParallel(unsigned int* destination, const unsigned int* order, size_t count, size_t vertex_count, const Hash& hasher, meshopt_Dispatch dispatch, void* dispatch_context)
+{
+	meshopt_Allocator allocator;
+
+	// inputs that the serial algorithm would sort are sorted here as well, with every pass split into tasks
+	if (vertex_count >= kSortMinVertices && !hasVertexLocality(vertex_count, hasher))
+		return generateVertexRemapSorted(destination, order, count, vertex_count, hasher, allocator, dispatch, dispatch_context);
+
+	RemapTasks<Hash> tasks = {};
+	tasks.hasher = hasher;
+	tasks.destination = destination;
+	tasks.order = order;
+	tasks.count = count;
+	tasks.block_count = (count + kRemapBlockSize - 1) / kRemapBlockSize;
+
+	tasks.hashes = allocator.allocate<unsigned int>(count);
+	tasks.cursors = allocator.allocate<unsigned int>(tasks.block_count * kRemapPartitions);
+	tasks.partitioned = allocator.allocate<unsigned int>(count);
+	tasks.block_offsets = allocator.allocate<unsigned int>(tasks.block_count);
+
+	dispatchTasks(dispatch, dispatch_context, remapHashTask<Hash>, &tasks, tasks.block_count);
+
+	// convert per-block partition counts into scatter cursors; partitions are laid out one after another, blocks in order within each partition
+	size_t offset = 0;
+
+	for (size_t p = 0; p < kRemapPartitions; ++p)
+	{
+		tasks.partition_offsets[p] = offset;
+
+		for (size_t b = 0; b < tasks.block_count; ++b)
+		{
+			unsigned int block_count = tasks.cursors[b * kRemapPartitions + p];
+			tasks.cursors[b * kRemapPartitions + p] = unsigned(offset);
+			offset += block_count;
+		}
+	}
+
+	assert(offset == count);
+	tasks.partition_offsets[kRemapPartitions] = offset;
+
+	size_t table_total = 0;
+
+	for (size_t p = 0; p < kRemapPartitions; ++p)
+	{
+		tasks.table_offsets[p] = table_total;
+		table_total += hashBuckets(tasks.partition_offsets[p + 1] - tasks.partition_offsets[p]);
+	}
+
+	tasks.table_offsets[kRemapPartitions] = table_total;
+	tasks.tables = allocator.allocate<unsigned int>(table_total);
+
+	dispatchTasks(dispatch, dispatch_context, remapScatterTask<Hash>, &tasks, tasks.block_count);
+	dispatchTasks(dispatch, dispatch_context, remapPartitionTask<Hash>, &tasks, kRemapPartitions);
+	dispatchTasks(dispatch, dispatch_context, remapCountTask<Hash>, &tasks, tasks.block_count);
+
+	// unique vertices get new indices in order of first reference, which matches the serial algorithm
+	unsigned int next_vertex = 0;
+
+	for (size_t b = 0; b < tasks.block_count; ++b)
+	{
+		unsigned int block_unique = tasks.block_offsets[b];
+		tasks.block_offsets[b] = next_vertex;
+		next_vertex += block_unique;
+	}
+
+	dispatchTasks(dispatch, dispatch_context, remapAssignTask<Hash>, &tasks, tasks.block_count);
+	dispatchTasks(dispatch, dispatch_context, remapResolveTask<Hash>, &tasks, tasks.block_count);
+
+	return next_vertex;
+}
+
+// out-of-core remap stores vertex records (position + vertex data) in hash partitions and (position, first equal position) pairs in position ranges
+const size_t kExternalBatchSize = 4096;
+const size_t kExternalRankWords = 8;
+
+static unsigned int popcount(unsigned int v)
+{
+	v = v - ((v >> 1) & 0x55555555);
+	v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+	return (((v + (v >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+}
+
+static size_t externalPartition(unsigned int hash, size_t partition_count)
+{
+	// top bits select the partition so that they don't correlate with the low bits that select the bucket within the partition
+	return ((hash >> 16) * partition_count) >> 16;
+}
+
+struct ExternalRemap
+{
+	size_t vertex_count;
+	size_t vertex_size;
+	size_t record_size;
+	size_t partition_count;
+	size_t range_size;
+
+	meshopt_VertexSource source;
+	void* source_context;
+	const meshopt_RemapStorage* storage;
+
+	size_t* record_counts; // records in each hash partition
+	size_t* pair_counts;   // pairs in each position range
+	unsigned int* unique;  // bit for each position that holds the first occurrence of a vertex
+	unsigned int* ranks;   // number of unique positions before each group of kExternalRankWords words
+};
+
+static int externalScatter(ExternalRemap& state, meshopt_Allocator& allocator)
+{
+	size_t record_size = state.record_size;
+
+	unsigned char* batch = allocator.allocate<unsigned char>(kExternalBatchSize * state.vertex_size);
+	unsigned char* records = allocator.allocate<unsigned char>(kExternalBatchSize * record_size);
+	unsigned int* partitions = allocator.allocate<unsigned int>(kExternalBatchSize);
+	size_t* offsets = allocator.allocate<size_t>(state.partition_count + 1);
+
+	VertexHasher hasher = {batch, state.vertex_size, state.vertex_size};
+
+	for (size_t begin = 0; begin < state.vertex_count; begin += kExternalBatchSize)
+	{
+		size_t count = state.vertex_count - begin < kExternalBatchSize ? state.vertex_count - begin : kExternalBatchSize;
+
+		int result = state.source(state.source_context, batch, begin, count);
+		if (result != 0)
+			return result;
+
+		memset(offsets, 0, (state.partition_count + 1) * sizeof(size_t));
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			partitions[i] = unsigned(externalPartition(unsigned(hasher.hash(unsigned(i))), state.partition_count));
+			offsets[partitions[i] + 1]++;
+		}
+
+		for (size_t p = 0; p < state.partition_count; ++p)
+		{
+			state.record_counts[p] += offsets[p + 1];
+			offsets[p + 1] += offsets[p];
+		}
+
+		// group records by partition so that each partition gets one write per batch; records stay in position order within each partition
+		for (size_t i = 0; i < count; ++i)
+		{
+			unsigned char* record = records + (offsets[partitions[i]]++) * record_size;
+			unsigned int position = unsigned(begin + i);
+
+			memcpy(record, &position, 4);
+			memcpy(record + 4, batch + i * state.vertex_size, state.vertex_size);
+		}
+
+		size_t offset = 0;
+
+		for (size_t p = 0; p < state.partition_count; ++p)
+		{
+			if (offsets[p] > offset)
+			{
+				int result = state.storage->write(state.storage->context, p, records + offset * record_size, (offsets[p] - offset) * record_size);
+				if (result != 0)
+					return result;
+			}
+
+			offset = offsets[p];
+		}
+	}
+
+	return 0;
+}
+
+static int externalDeduplicate(ExternalRemap& state, meshopt_Allocator& allocator)
+{
+	size_t record_size = state.record_size;
+	size_t partition_count = state.partition_count;
+
+	size_t max_records = 0;
+	for (size_t p = 0; p < partition_count; ++p)
+		max_records = max_records < state.record_counts[p] ? state.record_counts[p] : max_records;
+
+	unsigned char* records = allocator.allocate<unsigned char>(max_records * record_size);
+	unsigned int* pairs = allocator.allocate<unsigned int>(max_records * 2);
+	unsigned int* sorted = allocator.allocate<unsigned int>(max_records * 2);
+	size_t* offsets = allocator.allocate<size_t>(partition_count + 1);
+
+	size_t max_table_size = hashBuckets(max_records);
+	unsigned int* table = allocator.allocate<unsigned int>(max_table_size);
+
+	VertexHasher hasher = {records + 4, state.vertex_size, record_size};
+
+	for (size_t p = 0; p < partition_count; ++p)
+	{
+		size_t count = state.record_counts[p];
+
+		if (count == 0)
+			continue;
+
+		int result = state.storage->read(state.storage->context, p, records, count * record_size);
+		if (result != 0)
+			return result;
+
+		size_t table_size = hashBuckets(count);
+		memset(table, -1, table_size * sizeof(unsigned int));
+
+		memset(offsets, 0, (partition_count + 1) * sizeof(size_t));
+
+		// records are in position order, so the first record that is inserted for each vertex is its first occurrence
+		for (size_t i = 0; i < count; ++i)
+		{
+			unsigned int* entry = hashLookup(table, table_size, hasher, unsigned(i), ~0u);
+
+			if (*entry == ~0u)
+				*entry = unsigned(i);
+
+			unsigned int position, first;
+			memcpy(&position, records + i * record_size, 4);
+			memcpy(&first, records + *entry * record_size, 4);
+
+			if (position == first)
+				state.unique[position / 32] |= 1u << (position % 32);
+
+			pairs[i * 2 + 0] = position;
+			pairs[i * 2 + 1] = first;
+
+			offsets[position / state.range_size + 1]++;
+		}
+
+		for (size_t r = 0; r < partition_count; ++r)
+		{
+			state.pair_counts[r] += offsets[r + 1];
+			offsets[r + 1] += offsets[r];
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			size_t offset = offsets[pairs[i * 2] / state.range_size]++;
+
+			sorted[offset * 2 + 0] = pairs[i * 2 + 0];
+			sorted[offset * 2 + 1] = pairs[i * 2 + 1];
+		}
+
+		size_t offset = 0;
+
+		for (size_t r = 0; r < partition_count; ++r)
+		{
+			if (offsets[r] > offset)
+			{
+				int result = state.storage->write(state.storage->context, partition_count + r, sorted + offset * 2, (offsets[r] - offset) * 8);
+				if (result != 0)
+					return result;
+			}
+
+			offset = offsets[r];
+		}
+	}
+
+	return 0;
+}
+
+static unsigned int externalRank(const ExternalRemap& state, size_t position)
+{
+	size_t word = position / 32;
+	unsigned int rank = state.ranks[word / kExternalRankWords];
+
+	for (size_t i = word & ~(kExternalRankWords - 1); i < word; ++i)
+		rank += popcount(state.unique[i]);
+
+	return rank + popcount(state.unique[word] & ((1u << (position % 32)) - 1));
+}
+
+static int externalEmit(ExternalRemap& state, meshopt_Allocator& allocator, meshopt_RemapSink remap_sink, meshopt_VertexSink vertex_sink, void* sink_context)
+{
+	size_t range_size = state.range_size;
+
+	unsigned int* pairs = allocator.allocate<unsigned int>(range_size * 2);
+	unsigned int* remap = allocator.allocate<unsigned int>(range_size);
+	unsigned char* batch = allocator.allocate<unsigned char>(kExternalBatchSize * state.vertex_size);
+
+	unsigned int next_vertex = 0;
+
+	for (size_t r = 0; r < state.partition_count; ++r)
+	{
+		size_t begin = r * range_size;
+		size_t count = state.pair_counts[r];
+
+		if (count == 0)
+			continue;
+
+		assert(count == (state.vertex_count - begin < range_size ? state.vertex_count - begin : range_size));
+
+		int result = state.storage->read(state.storage->context, state.partition_count + r, pairs, count * 8);
+		if (result != 0)
+			return result;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			size_t position = pairs[i * 2 + 0];
+			assert(position >= begin && position < begin + count);
+
+			remap[position - begin] = externalRank(state, pairs[i * 2 + 1]);
+		}
+
+		result = remap_sink(sink_context, remap, begin, count);
+		if (result != 0)
+			return result;
+
+		if (!vertex_sink)
+			continue;
+
+		// unique vertices are emitted in the order of their first occurrence, which is the order of their new indices
+		for (size_t offset = 0; offset < count; offset += kExternalBatchSize)
+		{
+			size_t batch_count = count - offset < kExternalBatchSize ? count - offset : kExternalBatchSize;
+
+			result = state.source(state.source_context, batch, begin + offset, batch_count);
+			if (result != 0)
+				return result;
+
+			size_t unique = 0;
+
+			for (size_t i = 0; i < batch_count; ++i)
+				if (remap[offset + i] == next_vertex + unique)
+				{
+					memmove(batch + unique * state.vertex_size, batch + i * state.vertex_size, state.vertex_size);
+					unique++;
+				}
+
+			if (unique)
+				vertex_sink(sink_context, batch, next_vertex, unique);
+
+			next_vertex += unsigned(unique);
+		}
+	}
+
+	return 0;
+}
+
+} // namespace meshopt
+
+size_t meshopt_generateVertexRemap(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	assert(indices || index_count == vertex_count);
+	assert(index_count % 3 == 0);
+	assert(vertex_size > 0 && vertex_size <= 256);
+
+	meshopt_Allocator allocator;
+
+	memset(destination, -1, vertex_count * sizeof(unsigned int));
+
+	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+
+	// hashing and comparison are specialized for common vertex sizes so that they unroll into a few word operations
+	if (vertex_size == 12)
+	{
+		VertexHasherFixed<12> hasher = {vertex_data, vertex_size};
+		return generateVertexRemapAuto(destination, indices, index_count, vertex_count, hasher, allocator);
+	}
+	else if (vertex_size == 16)
+	{
+		VertexHasherFixed<16> hasher = {vertex_data, vertex_size};
+		return generateVertexRemapAuto(destination, indices, index_count, vertex_count, hasher, allocator);
+	}
+	else if (vertex_size == 24)
+	{
+		VertexHasherFixed<24> hasher = {vertex_data, vertex_size};
+		return generateVertexRemapAuto(destination, indices, index_count, vertex_count, hasher, allocator);
+	}
+	else if (vertex_size == 32)
+	{
+		VertexHasherFixed<32> hasher = {vertex_data, vertex_size};
+		return generateVertexRemapAuto(destination, indices, index_count, vertex_count, hasher, allocator);
+	}
+	else
+	{
+		VertexHasher hasher = {vertex_data, vertex_size, vertex_size};
+		return generateVertexRemapAuto(destination, indices, index_count, vertex_count, hasher, allocator);
+	}
+}
+
+void meshopt_remapVertexBuffer(void* destination, const void* vertices, size_t vertex_count, size_t vertex_size, const unsigned int* remap)
+{
+	assert(vertex_size > 0 && vertex_size <= 256);
+
+	meshopt_Allocator allocator;
+
+	// support in-place remap
+	if (destination == vertices)
+	{
+		char* vertices_copy = allocator.allocate<char>(vertex_count * vertex_size);
+		memcpy(vertices_copy, vertices, vertex_count * vertex_size);
+		vertices = vertices_copy;
+	}
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		if (remap[i] != ~0u)
+		{
+			assert(remap[i] < vertex_count);
+
+			memcpy(static_cast<char*>(destination) + remap[i] * vertex_size, static_cast<const char*>(vertices) + i * vertex_size, vertex_size);
+		}
+	}
+}
+
+void meshopt_remapIndexBuffer(unsigned int* destination, const unsigned int* indices, size_t index_count, const unsigned int* remap)
+{
+	assert(index_count % 3 == 0);
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int index = indices ? indices[i] : unsigned(i);
+		assert(remap[index] != ~0u);
+
+		destination[i] = remap[index];
+	}
+}
+
+void meshopt_generateShadowIndexBuffer(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, size_t vertex_stride)
+{
+	using namespace meshopt;
+
+	assert(indices);
+	assert(index_count % 3 == 0);
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size <= vertex_stride);
+
+	meshopt_Allocator allocator;
+
+	unsigned int* remap = allocator.allocate<unsigned int>(vertex_count);
+	memset(remap, -1, vertex_count * sizeof(unsigned int));
+
+	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+
+	size_t table_size = hashBuckets(vertex_count);
+	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+	memset(table, -1, table_size * sizeof(unsigned int));
+
+	// hashing and comparison are specialized for common vertex sizes so that they unroll into a few word operations
+	if (vertex_size == 12)
+	{
+		VertexHasherFixed<12> hasher = {vertex_data, vertex_stride};
+		generateShadowIndexBuffer(destination, indices, index_count, vertex_count, hasher, remap, table, table_size);
+	}
+	else if (vertex_size == 16)
+	{
+		VertexHasherFixed<16> hasher = {vertex_data, vertex_stride};
+		generateShadowIndexBuffer(destination, indices, index_count, vertex_count, hasher, remap, table, table_size);
+	}
+	else if (vertex_size == 24)
+	{
+		VertexHasherFixed<24> hasher = {vertex_data, vertex_stride};
+		generateShadowIndexBuffer(destination, indices, index_count, vertex_count, hasher, remap, table, table_size);
+	}
+	else if (vertex_size == 32)
+	{
+		VertexHasherFixed<32> hasher = {vertex_data, vertex_stride};
+		generateShadowIndexBuffer(destination, indices, index_count, vertex_count, hasher, remap, table, table_size);
+	}
+	else
+	{
+		VertexHasher hasher = {vertex_data, vertex_size, vertex_stride};
+		generateShadowIndexBuffer(destination, indices, index_count, vertex_count, hasher, remap, table, table_size);
+	}
+}
+
+size_t meshopt_generateVertexRemapMulti(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count)
+{
+	using namespace meshopt;
+
+	assert(indices || index_count == vertex_count);
+	assert(index_count % 3 == 0);
+	assert(stream_count > 0 && stream_count <= 16);
+
+	for (size_t i = 0; i < stream_count; ++i)
+	{
+		assert(streams[i].size > 0 && streams[i].size <= 256);
+		assert(streams[i].size <= streams[i].stride);
+	}
+
+	meshopt_Allocator allocator;
+
+	memset(destination, -1, vertex_count * sizeof(unsigned int));
+
+	VertexStreamHasher hasher = {streams, stream_count};
+
+	size_t table_size = hashBuckets(vertex_count);
+	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+	memset(table, -1, table_size * sizeof(unsigned int));
+
+	return generateVertexRemap(destination, indices, index_count, vertex_count, hasher, table, table_size);
+}
+
+void meshopt_generateShadowIndexBufferMulti(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count)
+{
+	using namespace meshopt;
+
+	assert(indices);
+	assert(index_count % 3 == 0);
+	assert(stream_count > 0 && stream_count <= 16);
+
+	for (size_t i = 0; i < stream_count; ++i)
+	{
+		assert(streams[i].size > 0 && streams[i].size <= 256);
+		assert(streams[i].size <= streams[i].stride);
+	}
+
+	meshopt_Allocator allocator;
+
+	unsigned int* remap = allocator.allocate<unsigned int>(vertex_count);
+	memset(remap, -1, vertex_count * sizeof(unsigned int));
+
+	VertexStreamHasher hasher = {streams, stream_count};
+
+	size_t table_size = hashBuckets(vertex_count);
+	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+	memset(table, -1, table_size * sizeof(unsigned int));
+
+	generateShadowIndexBuffer(destination, indices, index_count, vertex_count, hasher, remap, table, table_size);
+}
+
+size_t meshopt_generateVertexRemapTolerance(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertices, size_t vertex_count, size_t vertex_stride, const float* tolerances, size_t component_count)
+{
+	using namespace meshopt;
+
+	assert(indices || index_count == vertex_count);
+	assert(index_count % 3 == 0);
+	assert(vertex_stride > 0 && vertex_stride <= 256);
+	assert(vertex_stride % sizeof(float) == 0);
+	assert(component_count > 0 && component_count * sizeof(float) <= vertex_stride);
+
+	meshopt_Allocator allocator;
+
+	memset(destination, -1, vertex_count * sizeof(unsigned int));
+
+	VertexTolerance tolerance = {};
+	tolerance.vertices = vertices;
+	tolerance.vertex_stride_float = vertex_stride / sizeof(float);
+	tolerance.tolerances = tolerances;
+	tolerance.component_count = component_count;
+
+	for (size_t i = 0; i < component_count && tolerance.grid_count < kToleranceGridComponents; ++i)
+	{
+		assert(tolerances[i] >= 0);
+
+		if (tolerances[i] > 0)
+		{
+			tolerance.grid[tolerance.grid_count] = i;
+			tolerance.scale[tolerance.grid_count] = 1.f / (2 * tolerances[i]);
+			tolerance.grid_count++;
+		}
+	}
+
+	// probe sequences are scanned until an empty bucket, so the table is kept at most 80% full
+	size_t table_size = hashBuckets(vertex_count + vertex_count / 4);
+	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+	memset(table, -1, table_size * sizeof(unsigned int));
+
+	return generateVertexRemapTolerance(destination, indices, index_count, vertex_count, tolerance, table, table_size);
+}
+
+size_t meshopt_generateVertexRemapParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_Dispatch dispatch, void* dispatch_context)
+{
+	using namespace meshopt;
+
+	assert(indices || index_count == vertex_count);
+	assert(index_count % 3 == 0);
+	assert(vertex_size > 0 && vertex_size <= 256);
+
+	// partitioning doesn't pay off when all vertices fit into one block
+	if (vertex_count <= kRemapBlockSize)
+		return meshopt_generateVertexRemap(destination, indices, index_count, vertices, vertex_count, vertex_size);
+
+	meshopt_Allocator allocator;
+
+	memset(destination, -1, vertex_count * sizeof(unsigned int));
+
+	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+
+	unsigned int* order = 0;
+	size_t count = vertex_count;
+
+	// for indexed input, vertices are processed in the order of first reference, which is the order the serial algorithm assigns new indices in
+	if (indices)
+	{
+		order = allocator.allocate<unsigned int>(vertex_count);
+		count = 0;
+
+		for (size_t i = 0; i < index_count; ++i)
+		{
+			unsigned int index = indices[i];
+			assert(index < vertex_count);
+
+			if (destination[index] == ~0u)
+			{
+				destination[index] = 0;
+				order[count++] = index;
+			}
+		}
+	}
+
+	if (vertex_size == 12)
+	{
+		VertexHasherFixed<12> hasher = {vertex_data, vertex_size};
+		return generateVertexRemapParallel(destination, order, count, vertex_count, hasher, dispatch, dispatch_context);
+	}
+	else if (vertex_size == 16)
+	{
+		VertexHasherFixed<16> hasher = {vertex_data, vertex_size};
+		return generateVertexRemapParallel(destination, order, count, vertex_count, hasher, dispatch, dispatch_context);
+	}
+	else if (vertex_size == 24)
+	{
+		VertexHasherFixed<24> hasher = {vertex_data, vertex_size};
+		return generateVertexRemapParallel(destination, order, count, vertex_count, hasher, dispatch, dispatch_context);
+	}
+	else if (vertex_size == 32)
+	{
+		VertexHasherFixed<32> hasher = {vertex_data, vertex_size};
+		return generateVertexRemapParallel(destination, order, count, vertex_count, hasher, dispatch, dispatch_context);
+	}
+	else
+	{
+		VertexHasher hasher = {vertex_data, vertex_size, vertex_size};
+		return generateVertexRemapParallel(destination, order, count, vertex_count, hasher, dispatch, dispatch_context);
+	}
+}
+
+int meshopt_generateVertexRemapExternal(size_t* unique_vertex_count, size_t vertex_count, size_t vertex_size, meshopt_VertexSource source, void* source_context, size_t partition_count, const struct meshopt_RemapStorage* storage, meshopt_RemapSink remap_sink, meshopt_VertexSink vertex_sink, void* sink_context)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(partition_count > 0 && partition_count <= 65536);
+	assert(source && storage && remap_sink);
+
+	meshopt_Allocator allocator;
+
+	ExternalRemap state = {};
+	state.vertex_count = vertex_count;
+	state.vertex_size = vertex_size;
+	state.record_size = 4 + vertex_size;
+	state.partition_count = partition_count;
+	state.range_size = (vertex_count + partition_count - 1) / partition_count;
+	state.source = source;
+	state.source_context = source_context;
+	state.storage = storage;
+
+	size_t word_count = (vertex_count + 31) / 32;
+	size_t rank_count = (word_count + kExternalRankWords - 1) / kExternalRankWords;
+
+	state.record_counts = allocator.allocate<size_t>(partition_count);
+	state.pair_counts = allocator.allocate<size_t>(partition_count);
+	state.unique = allocator.allocate<unsigned int>(word_count + 1);
+	state.ranks = allocator.allocate<unsigned int>(rank_count + 1);
+
+	memset(state.record_counts, 0, partition_count * sizeof(size_t));
+	memset(state.pair_counts, 0, partition_count * sizeof(size_t));
+	memset(state.unique, 0, (word_count + 1) * sizeof(unsigned int));
+
+	int result = externalScatter(state, allocator);
+	if (result != 0)
+		return result;
+
+	result = externalDeduplicate(state, allocator);
+	if (result != 0)
+		return result;
+
+	// new index of each unique vertex is the number of unique vertices before its first occurrence
+	unsigned int unique = 0;
+
+	for (size_t i = 0; i < word_count; ++i)
+	{
+		if (i % kExternalRankWords == 0)
+			state.ranks[i / kExternalRankWords] = unique;
+
+		unique += popcount(state.unique[i]);
+	}
+
+	result = externalEmit(state, allocator, remap_sink, vertex_sink, sink_context);
+	if (result != 0)
+		return result;
+
+	if (unique_vertex_count)
+		*unique_vertex_count = unique;
+
+	return 0;
 }
@@ -30,6 +30,8 @@ extern "C" {
 /**
  * Generates a vertex remap table from the vertex buffer and an optional index buffer and returns number of unique vertices
  * As a result, all vertices that are binary equivalent map to the same (new) location, with no gaps in the resulting sequence.
+ * Inputs with at least 4M vertices where equal vertices are far apart are deduplicated by sorting vertex hashes instead of using a hash table.
+ * This needs 8 bytes of temporary memory per vertex, or 12 bytes when indices are specified, compared to 4-8 bytes per vertex for the hash table.
  *
  * destination must contain enough space for the resulting remap table (vertex_count elements)
  * indices can be NULL if the input is unindexed
@@ -61,6 +63,92 @@ MESHOPTIMIZER_API void meshopt_remapIndexBuffer(unsigned int* destination, const
  */
 MESHOPTIMIZER_EXPERIMENTAL void meshopt_generateShadowIndexBuffer(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, size_t vertex_stride);
 
+struct meshopt_Stream
+{
+	const void* data; /* data for the first vertex */
+	size_t size;      /* number of bytes of each vertex that are compared, 1-256 */
+	size_t stride;    /* distance between consecutive vertices; must be at least size */
+};
+
+/**
+ * Experimental: Generates a vertex remap table from multiple vertex streams and an optional index buffer and returns number of unique vertices
+ * As a result, all vertices that are binary equivalent in every stream map to the same (new) location, with no gaps in the resulting sequence.
+ * This is equivalent to meshopt_generateVertexRemap on interleaved vertex data, but doesn't require interleaving separate attribute streams first.
+ * Resulting remap table should be used to reorder each stream with meshopt_remapVertexBuffer.
+ *
+ * destination must contain enough space for the resulting remap table (vertex_count elements)
+ * indices can be NULL if the input is unindexed
+ * stream_count must be <= 16
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_generateVertexRemapMulti(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count);
+
+/**
+ * Experimental: Generate index buffer that can be used for more efficient rendering when only a subset of the vertex attributes is necessary
+ * All vertices that are binary equivalent (wrt specified streams) map to the first vertex in the original vertex buffer.
+ * This makes it possible to build position-only index buffers for Z pre-pass or shadowmap rendering from separate attribute streams.
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements)
+ * stream_count must be <= 16
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_generateShadowIndexBufferMulti(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count);
+
+/**
+ * Experimental: Generates a vertex remap table that merges vertices which are equal within a tolerance and returns number of unique vertices
+ * Each vertex consists of component_count floats; two vertices are merged when every component differs by at most the corresponding tolerance.
+ * Vertices are processed in the order of first reference and each one is merged into the earliest preceding unique vertex within tolerance, or becomes a new unique vertex.
+ * Candidates are located using the first 3 components with non-zero tolerance; components with zero tolerance must match exactly.
+ * After meshopt_remapVertexBuffer, each unique vertex contains data of one of the vertices that were merged into it.
+ *
+ * destination must contain enough space for the resulting remap table (vertex_count elements)
+ * indices can be NULL if the input is unindexed
+ * tolerances must contain component_count non-negative values
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_generateVertexRemapTolerance(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertices, size_t vertex_count, size_t vertex_stride, const float* tolerances, size_t component_count);
+
+/**
+ * Experimental: Task dispatcher
+ * Runs task(task_context, i) for each i in [0..task_count); tasks are independent and can run concurrently and in any order, but all of them must complete before the dispatcher returns.
+ * context is the user-provided dispatch_context that was passed to the function that uses the dispatcher.
+ */
+typedef void (*meshopt_Dispatch)(void* context, void (*task)(void* task_context, size_t task_index), void* task_context, size_t task_count);
+
+/**
+ * Experimental: Parallel vertex remap generator
+ * Generates a vertex remap table that is identical to the output of meshopt_generateVertexRemap, splitting the work into tasks that are run via dispatch.
+ * Vertices are partitioned by hash so that each partition is deduplicated independently; inputs with at most 16384 vertices are processed serially on the calling thread.
+ * Inputs that meshopt_generateVertexRemap deduplicates by sorting are sorted here as well, with the same memory requirements; each radix bucket is sorted and deduplicated by a separate task.
+ *
+ * destination must contain enough space for the resulting remap table (vertex_count elements)
+ * indices can be NULL if the input is unindexed
+ * dispatch can be NULL, in which case all tasks run serially on the calling thread
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_generateVertexRemapParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_Dispatch dispatch, void* dispatch_context);
+
+/**
+ * Experimental: Out-of-core vertex remap generator
+ * Generates a vertex remap table for unindexed vertex data that doesn't need to fit in memory; the result is identical to meshopt_generateVertexRemap with indices = NULL.
+ * Vertices are read from source in small batches and spilled to partition_count hash partitions via storage; each partition is then read back and deduplicated on its own.
+ * The remap table is passed to remap_sink in consecutive ranges in vertex order, and unique vertices are passed to vertex_sink (which can be NULL) in the order of their new indices.
+ * Memory usage is about vertex_count/7 bytes plus 2-3x the size of the largest partition, which is (vertex_size + 4) * vertex_count / partition_count bytes on average.
+ * Returns 0 on success and writes the number of unique vertices to unique_vertex_count, or returns the first non-zero value returned by a callback.
+ *
+ * source must write vertex_count vertices starting from vertex_offset to destination; it's called for all vertices in order and then again while unique vertices are emitted
+ * storage partitions are numbered 0..partition_count*2-1; write appends data to a partition, read reads all data written to the partition so far, and is called once per partition after all writes to it
+ * partition_count must be <= 65536
+ */
+typedef int (*meshopt_VertexSource)(void* context, void* destination, size_t vertex_offset, size_t vertex_count);
+typedef int (*meshopt_RemapSink)(void* context, const unsigned int* remap, size_t vertex_offset, size_t vertex_count);
+typedef void (*meshopt_VertexSink)(void* context, const void* vertices, size_t vertex_offset, size_t vertex_count);
+
+struct meshopt_RemapStorage
+{
+	void* context;
+	int (*write)(void* context, size_t partition, const void* data, size_t size);
+	int (*read)(void* context, size_t partition, void* destination, size_t size);
+};
+
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_generateVertexRemapExternal(size_t* unique_vertex_count, size_t vertex_count, size_t vertex_size, meshopt_VertexSource source, void* source_context, size_t partition_count, const struct meshopt_RemapStorage* storage, meshopt_RemapSink remap_sink, meshopt_VertexSink vertex_sink, void* sink_context);
+
 /**
  * Vertex transform cache optimizer
  * Reorders indices to reduce the number of GPU vertex shader invocations
@@ -121,21 +209,64 @@ MESHOPTIMIZER_API size_t meshopt_optimizeVertexFetch(void* destination, unsigned
 MESHOPTIMIZER_API size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count);
 MESHOPTIMIZER_API size_t meshopt_encodeIndexBufferBound(size_t index_count, size_t vertex_count);
 
+/**
+ * Experimental: Index buffer encoder with compression level
+ * Encodes index data similarly to meshopt_encodeIndexBuffer; the output can be decoded with meshopt_decodeIndexBuffer.
+ * Level 0 matches meshopt_encodeIndexBuffer; level 1 encodes the data twice, gathering statistics during the first pass to build a mesh-specific encoding table, which is usually a little smaller.
+ * Returns encoded data size on success, 0 on error
+ *
+ * buffer must contain enough space for the encoded index buffer (use meshopt_encodeIndexBufferBound to estimate)
+ * level must be in [0..1] range
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeIndexBufferLevel(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count, int level);
+
 /**
  * Index buffer decoder
- * Decodes index data from an array of bytes generated by meshopt_encodeIndexBuffer
+ * Decodes index data from an array of bytes generated by meshopt_encodeIndexBuffer or meshopt_encodeIndexBufferChunked
  * Returns 0 if decoding was successful, and an error code otherwise
  *
  * destination must contain enough space for the resulting index buffer (index_count elements)
  */
 MESHOPTIMIZER_API int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size);
 
+/**
+ * Experimental: Rebasing index buffer decoder
+ * Decodes index data from an array of bytes generated by meshopt_encodeIndexBuffer or meshopt_encodeIndexBufferChunked into 16-bit indices relative to base_vertex, which is useful for rendering meshes with more than 65536 vertices using 16-bit indices and a base vertex offset.
+ * Returns 0 if decoding was successful, -4 if any index is outside of [base_vertex, base_vertex + 65535] range, and another error code otherwise
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements)
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeIndexBufferRebase(unsigned short* destination, size_t index_count, unsigned int base_vertex, const unsigned char* buffer, size_t buffer_size);
+
+/**
+ * Experimental: Index sequence encoder
+ * Encodes index sequences that aren't triangle lists, such as triangle strips, line lists or point lists, into an array of bytes that is generally smaller and compresses better compared to original.
+ * Restart indices (~0u) in triangle strips, such as the ones produced by meshopt_stripify, are encoded using a single byte; the C++ template for 16-bit indices treats 0xffff as a restart index.
+ * Returns encoded data size on success, 0 on error; the only error condition is if buffer doesn't have enough space
+ * Input index buffer must represent a sequence that is optimized for vertex cache and vertex fetch for best compression.
+ *
+ * buffer must contain enough space for the encoded index sequence (use meshopt_encodeIndexSequenceBound to estimate)
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeIndexSequence(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeIndexSequenceBound(size_t index_count, size_t vertex_count);
+
+/**
+ * Experimental: Index sequence decoder
+ * Decodes index data from an array of bytes generated by meshopt_encodeIndexSequence
+ * Returns 0 if decoding was successful, and an error code otherwise
+ * Restart indices are decoded as ~0u for 32-bit indices and 0xffff for 16-bit indices.
+ *
+ * destination must contain enough space for the resulting index sequence (index_count elements)
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeIndexSequence(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size);
+
 /**
  * Vertex buffer encoder
  * Encodes vertex data into an array of bytes that is generally smaller and compresses better compared to original.
  * Returns encoded data size on success, 0 on error
  *
  * buffer must contain enough space for the encoded vertex buffer (use meshopt_encodeVertexBufferBound to estimate)
+ * vertex_size must be in [1..512] range; sizes that are a multiple of 4 are encoded and decoded faster
  */
 MESHOPTIMIZER_API size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size);
 MESHOPTIMIZER_API size_t meshopt_encodeVertexBufferBound(size_t vertex_count, size_t vertex_size);
@@ -149,6 +280,234 @@ MESHOPTIMIZER_API size_t meshopt_encodeVertexBufferBound(size_t vertex_count, si
  */
 MESHOPTIMIZER_API int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size);
 
+/**
+ * Experimental: Vertex buffer decoder kernel
+ * Returns the name of the decoding kernel meshopt_decodeVertexBuffer uses on the current CPU: "scalar", "ssse3", "avx2" or "neon"
+ * On x86 with MSVC, GCC or Clang, SIMD kernels are selected at runtime so this doesn't depend on the instruction sets the library was compiled for.
+ * The "neon" kernel only accelerates format version 0; version 1 buffers are decoded with the scalar kernel on ARM.
+ */
+MESHOPTIMIZER_EXPERIMENTAL const char* meshopt_decodeVertexBufferKernel(void);
+
+/**
+ * Experimental: Vertex buffer format version
+ * meshopt_encodeVertexVersion sets the format version that all vertex buffer encoders use from now on; version must be 0 (default) or 1.
+ * Version 1 picks the best of several delta transforms (8-bit, 16-bit and 32-bit deltas, 32-bit xor) and delta distances for every 4 bytes of each block and uses a richer set of bit widths, which results in smaller output for 16-bit and 32-bit attributes at the cost of encoding time.
+ * Decoders accept both versions; version 1 streams can't be decoded by earlier versions of the library.
+ * meshopt_decodeVertexVersion returns the version of an encoded vertex buffer, or -1 if the buffer doesn't contain a vertex buffer.
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_encodeVertexVersion(int version);
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexVersion(const unsigned char* buffer, size_t buffer_size);
+
+/**
+ * Experimental: Vertex buffer encoder with compression level
+ * Encodes vertex data similarly to meshopt_encodeVertexBuffer, trading encoding speed for output size; the output can be decoded with meshopt_decodeVertexBuffer.
+ * Level 0 skips size estimation and is the fastest; level 2 matches meshopt_encodeVertexBuffer; level 3 is the slowest and produces the smallest output.
+ * For format version 0, only level 0 differs as there is nothing else to search for; for format version 1, level 1 searches bit widths, level 2 also searches delta transforms,
+ * and level 3 also searches the distance to the vertex each delta is computed against (1-4), which helps unindexed triangle and quad lists.
+ * Returns encoded data size on success, 0 on error
+ *
+ * buffer must contain enough space for the encoded vertex buffer (use meshopt_encodeVertexBufferBound to estimate)
+ * level must be in [0..3] range
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeVertexBufferLevel(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, int level);
+
+/**
+ * Experimental: Seekable vertex buffer encoder
+ * Encodes vertex data similarly to meshopt_encodeVertexBuffer, but also stores the offset and the initial vertex of each block so that blocks can be decoded independently.
+ * The result is slightly larger than the output of meshopt_encodeVertexBuffer and can be decoded with meshopt_decodeVertexBuffer or meshopt_decodeVertexBufferParallel.
+ * Returns encoded data size on success, 0 on error; the encoded data can't exceed 4 GB.
+ *
+ * buffer must contain enough space for the encoded vertex buffer (use meshopt_encodeVertexBufferSeekableBound to estimate)
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeVertexBufferSeekable(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeVertexBufferSeekableBound(size_t vertex_count, size_t vertex_size);
+
+/**
+ * Experimental: Parallel vertex buffer encoder
+ * Encodes vertex data into an array of bytes that is identical to the output of meshopt_encodeVertexBuffer, splitting the work into tasks that are run via dispatch.
+ * Returns encoded data size on success, 0 on error
+ *
+ * buffer must contain enough space for the encoded vertex buffer (use meshopt_encodeVertexBufferBound to estimate)
+ * dispatch can be NULL, in which case all tasks run serially on the calling thread
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeVertexBufferParallel(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_Dispatch dispatch, void* dispatch_context);
+
+/**
+ * Experimental: Parallel vertex buffer decoder
+ * Decodes vertex data from an array of bytes generated by meshopt_encodeVertexBufferSeekable, splitting the work into tasks that are run via dispatch.
+ * Streams generated by meshopt_encodeVertexBuffer are decoded serially on the calling thread.
+ * Returns 0 if decoding was successful, and an error code otherwise
+ *
+ * destination must contain enough space for the resulting vertex buffer (vertex_count * vertex_size bytes)
+ * dispatch can be NULL, in which case all tasks run serially on the calling thread
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexBufferParallel(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, meshopt_Dispatch dispatch, void* dispatch_context);
+
+/**
+ * Experimental: Chunked index buffer encoder
+ * Encodes index data similarly to meshopt_encodeIndexBuffer, but resets the codec state every 16384 triangles and stores a table with the offset of each chunk, so that chunks can be encoded and decoded independently.
+ * Chunks are encoded in parallel via dispatch when the buffer is at least meshopt_encodeIndexBufferChunkedBound bytes, and serially on the calling thread otherwise.
+ * The result is slightly larger than the output of meshopt_encodeIndexBuffer and can be decoded with meshopt_decodeIndexBuffer or meshopt_decodeIndexBufferParallel.
+ * Returns encoded data size on success, 0 on error; the encoded data can't exceed 4 GB.
+ *
+ * buffer must contain enough space for the encoded index buffer (use meshopt_encodeIndexBufferChunkedBound to estimate)
+ * dispatch can be NULL, in which case all tasks run serially on the calling thread
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeIndexBufferChunked(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count, meshopt_Dispatch dispatch, void* dispatch_context);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeIndexBufferChunkedBound(size_t index_count, size_t vertex_count);
+
+/**
+ * Experimental: Parallel index buffer decoder
+ * Decodes index data from an array of bytes generated by meshopt_encodeIndexBufferChunked, decoding each chunk in a separate task that is run via dispatch.
+ * Streams generated by meshopt_encodeIndexBuffer are decoded serially on the calling thread.
+ * Returns 0 if decoding was successful, and an error code otherwise
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements)
+ * dispatch can be NULL, in which case all tasks run serially on the calling thread
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeIndexBufferParallel(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size, meshopt_Dispatch dispatch, void* dispatch_context);
+
+/**
+ * Experimental: Partial vertex buffer decoder
+ * Decodes count vertices starting from vertex first out of vertex_count vertices encoded in an array of bytes generated by meshopt_encodeVertexBufferSeekable or meshopt_encodeVertexBuffer.
+ * Seekable streams only need to decode the blocks that cover the range; regular streams need to decode all blocks up to the end of the range.
+ * Returns 0 if decoding was successful, and an error code otherwise; data after the range isn't validated unless the range includes the last vertex.
+ *
+ * destination must contain enough space for the resulting vertex range (count * vertex_size bytes)
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexBufferRange(void* destination, size_t first, size_t count, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size);
+
+/**
+ * Experimental: Streaming vertex buffer decoder
+ * Decodes vertex data from an array of bytes generated by meshopt_encodeVertexBufferSeekable that is fed to the decoder in chunks of arbitrary size, e.g. as it is read from disk or network.
+ * Vertices are decoded one block (up to 8 KB) at a time and passed to sink along with the index of the first vertex in the block; the data is only valid until sink returns.
+ * Streams generated by meshopt_encodeVertexBuffer can't be decoded incrementally since they store the initial vertex at the end of the stream.
+ *
+ * meshopt_vertexDecoderSize returns the amount of memory the decoder needs; memory passed to meshopt_vertexDecoderInit must be at least this large and pointer-aligned
+ * meshopt_vertexDecoderFeed returns 0 if the data was consumed successfully, and an error code otherwise; once an error is returned, it is returned by all subsequent calls
+ * meshopt_vertexDecoderFinish must be called after all data has been fed; it returns 0 if the entire stream was decoded successfully, and an error code otherwise
+ */
+struct meshopt_VertexDecoder;
+
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_vertexDecoderSize(size_t vertex_count, size_t vertex_size);
+MESHOPTIMIZER_EXPERIMENTAL struct meshopt_VertexDecoder* meshopt_vertexDecoderInit(void* memory, size_t memory_size, size_t vertex_count, size_t vertex_size, meshopt_VertexSink sink, void* sink_context);
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_vertexDecoderFeed(struct meshopt_VertexDecoder* decoder, const unsigned char* data, size_t size);
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_vertexDecoderFinish(struct meshopt_VertexDecoder* decoder);
+
+/**
+ * Experimental: Attribute formats for meshopt_decodeVertexBufferDequantize
+ * Unorm/Snorm formats use the reconstruction functions described in meshopt_quantizeUnorm/meshopt_quantizeSnorm; Half uses meshopt_quantizeHalf encoding
+ * Oct formats store an octahedron-encoded unit vector as two snorm values and produce a normalized 3-component vector
+ */
+enum meshopt_AttributeFormat
+{
+	meshopt_AttributeFloat,
+	meshopt_AttributeHalf,
+	meshopt_AttributeUnorm8,
+	meshopt_AttributeSnorm8,
+	meshopt_AttributeUnorm16,
+	meshopt_AttributeSnorm16,
+	meshopt_AttributeOct8,
+	meshopt_AttributeOct16
+};
+
+struct meshopt_VertexAttribute
+{
+	int format;                /* meshopt_AttributeFormat */
+	size_t components;         /* 1-4; must be 2 for Oct formats */
+	size_t source_offset;      /* offset of the attribute in the encoded vertex; must be aligned to the component size */
+	size_t destination_offset; /* offset of the first float in the destination vertex; must be aligned to 4 bytes */
+	float scale[4];            /* each decoded component is computed as value * scale + bias; Oct formats use 3 components */
+	float bias[4];
+};
+
+/**
+ * Experimental: Dequantizing vertex buffer decoder
+ * Decodes vertex data from an array of bytes generated by meshopt_encodeVertexBuffer or meshopt_encodeVertexBufferSeekable and converts each attribute to floats.
+ * This is faster than decoding and converting the data separately since quantized vertices are converted in small blocks that stay in cache.
+ * Returns 0 if decoding was successful, and an error code otherwise
+ *
+ * destination must contain enough space for the resulting vertex buffer (vertex_count * destination_stride bytes); bytes not covered by attributes are left unchanged
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexBufferDequantize(void* destination, size_t destination_stride, size_t vertex_count, size_t vertex_size, const struct meshopt_VertexAttribute* attributes, size_t attribute_count, const unsigned char* buffer, size_t buffer_size);
+
+struct meshopt_VertexOutput
+{
+	size_t offset;     /* offset of the first byte to copy in the encoded vertex */
+	size_t size;       /* number of bytes to copy for each vertex */
+	void* destination; /* destination for the first vertex; must contain enough space for vertex_count elements that are stride bytes apart */
+	size_t stride;     /* distance between consecutive vertices in the destination; must be at least size */
+};
+
+/**
+ * Experimental: Splitting vertex buffer decoder
+ * Decodes vertex data from an array of bytes generated by meshopt_encodeVertexBuffer or meshopt_encodeVertexBufferSeekable and copies byte ranges of each vertex to separate strided destinations.
+ * This can be used to de-interleave vertex data into separate streams (e.g. positions and other attributes) without decoding the entire vertex buffer into temporary memory first.
+ * Returns 0 if decoding was successful, and an error code otherwise
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexBufferSplit(const struct meshopt_VertexOutput* outputs, size_t output_count, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size);
+
+/**
+ * Experimental: Entropy coder
+ * Compresses an array of bytes, such as the output of vertex and index codecs, using an order-0 entropy coder (rANS) that doesn't require external libraries.
+ * Data is split into 64 KB blocks that are coded independently; blocks that don't compress are stored as is.
+ * This doesn't exploit repeated byte sequences the way general purpose compressors do, but decoding is fast enough to be combined with vertex decoding, see meshopt_decodeEntropyStream.
+ * Returns encoded data size on success, 0 on error; the only error condition is if buffer doesn't have enough space
+ *
+ * buffer must contain enough space for the encoded data (use meshopt_encodeEntropyBound to estimate)
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeEntropy(unsigned char* buffer, size_t buffer_size, const unsigned char* data, size_t data_size);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeEntropyBound(size_t data_size);
+
+/**
+ * Experimental: Entropy decoder
+ * Decodes data_size bytes from an array of bytes generated by meshopt_encodeEntropy
+ * Returns 0 if decoding was successful, and an error code otherwise
+ *
+ * destination must contain enough space for the resulting data (data_size bytes)
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeEntropy(unsigned char* destination, size_t data_size, const unsigned char* buffer, size_t buffer_size);
+
+/**
+ * Experimental: Streaming entropy decoder
+ * Decodes data_size bytes from an array of bytes generated by meshopt_encodeEntropy one block (up to 64 KB) at a time and passes each block to sink; the data is only valid until sink returns.
+ * Feeding the blocks to meshopt_vertexDecoderFeed decodes entropy coded seekable vertex buffers in a single pass, since decoded blocks stay in cache.
+ * Returns 0 if decoding was successful, the first non-zero value returned by sink, or an error code otherwise
+ */
+typedef int (*meshopt_EntropySink)(void* context, const unsigned char* data, size_t size);
+
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeEntropyStream(size_t data_size, const unsigned char* buffer, size_t buffer_size, meshopt_EntropySink sink, void* sink_context);
+
+/**
+ * Experimental: Vertex attribute filters
+ * These functions can be used to transform vertex attributes before encoding with meshopt_encodeVertexBuffer to improve compression, and to reverse the transform in place after decoding.
+ * Filters operate on count elements that are stride bytes apart; each filter has specific stride requirements.
+ *
+ * meshopt_decodeFilterOct decodes octahedral encoding of a unit vector with K-bit (2 <= K <= 8 for stride 4, 2 <= K <= 16 for stride 8) signed X/Y as an input; Z must store 1.0f scale (encoded as 2^(K-1)-1).
+ * Each component is stored as an 8-bit or 16-bit normalized integer; stride must be equal to 4 or 8. W is preserved as is.
+ *
+ * meshopt_decodeFilterQuat decodes 3-component quaternion encoding with K-bit (4 <= K <= 16) component encoding and a 2-bit component index indicating which component to reconstruct.
+ * Each component is stored as a 16-bit integer; stride must be equal to 8.
+ *
+ * meshopt_decodeFilterExp decodes exponential encoding of floating-point data with 8-bit exponent and 24-bit integer mantissa as 2^E*M.
+ * Each 32-bit component is decoded in isolation; stride must be divisible by 4.
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeFilterOct(void* buffer, size_t count, size_t stride);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeFilterQuat(void* buffer, size_t count, size_t stride);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeFilterExp(void* buffer, size_t count, size_t stride);
+
+/**
+ * Experimental: Vertex attribute filter encoders
+ * These functions encode float data into the formats meshopt_decodeFilter* functions expect; input is count elements of float data and output uses stride as specified by the filter.
+ *
+ * meshopt_encodeFilterOct encodes unit vectors with K-bit (2 <= K <= 8 for stride 4, 2 <= K <= 16 for stride 8) octahedral encoding; input is 4 floats per element (xyz vector + w, which is quantized to 8 or 16 bits).
+ * meshopt_encodeFilterQuat encodes unit quaternions with K-bit (4 <= K <= 16) component encoding; input is 4 floats per element and stride must be equal to 8.
+ * meshopt_encodeFilterExp encodes arbitrary floats with K-bit (1 <= K <= 24) mantissa; all stride/4 components of each element share the exponent, so precision is relative to the largest component.
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_encodeFilterOct(void* destination, size_t count, size_t stride, int bits, const float* data);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_encodeFilterQuat(void* destination, size_t count, size_t stride, int bits, const float* data);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_encodeFilterExp(void* destination, size_t count, size_t stride, int bits, const float* data);
+
 /**
  * Experimental: Mesh simplifier
  * Reduces the number of triangles in the mesh, attempting to preserve mesh appearance as much as possible
@@ -402,6 +761,39 @@ void meshopt_generateShadowIndexBuffer(T* destination, const T* indices, size_t
 	meshopt_generateShadowIndexBuffer(out.data, in.data, index_count, vertices, vertex_count, vertex_size, vertex_stride);
 }
 
+template <typename T>
+inline size_t meshopt_generateVertexRemapMulti(unsigned int* destination, const T* indices, size_t index_count, size_t vertex_count, const meshopt_Stream* streams, size_t stream_count)
+{
+	meshopt_IndexAdapter<T> in(0, indices, indices ? index_count : 0);
+
+	return meshopt_generateVertexRemapMulti(destination, indices ? in.data : 0, index_count, vertex_count, streams, stream_count);
+}
+
+template <typename T>
+inline void meshopt_generateShadowIndexBufferMulti(T* destination, const T* indices, size_t index_count, size_t vertex_count, const meshopt_Stream* streams, size_t stream_count)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count);
+
+	meshopt_generateShadowIndexBufferMulti(out.data, in.data, index_count, vertex_count, streams, stream_count);
+}
+
+template <typename T>
+inline size_t meshopt_generateVertexRemapTolerance(unsigned int* destination, const T* indices, size_t index_count, const float* vertices, size_t vertex_count, size_t vertex_stride, const float* tolerances, size_t component_count)
+{
+	meshopt_IndexAdapter<T> in(0, indices, indices ? index_count : 0);
+
+	return meshopt_generateVertexRemapTolerance(destination, indices ? in.data : 0, index_count, vertices, vertex_count, vertex_stride, tolerances, component_count);
+}
+
+template <typename T>
+inline size_t meshopt_generateVertexRemapParallel(unsigned int* destination, const T* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_Dispatch dispatch, void* dispatch_context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, indices ? index_count : 0);
+
+	return meshopt_generateVertexRemapParallel(destination, indices ? in.data : 0, index_count, vertices, vertex_count, vertex_size, dispatch, dispatch_context);
+}
+
 template <typename T>
 inline void meshopt_optimizeVertexCache(T* destination, const T* indices, size_t index_count, size_t vertex_count)
 {
@@ -453,6 +845,14 @@ inline size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_siz
 	return meshopt_encodeIndexBuffer(buffer, buffer_size, in.data, index_count);
 }
 
+template <typename T>
+inline size_t meshopt_encodeIndexBufferLevel(unsigned char* buffer, size_t buffer_size, const T* indices, size_t index_count, int level)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_encodeIndexBufferLevel(buffer, buffer_size, in.data, index_count, level);
+}
+
 template <typename T>
 inline int meshopt_decodeIndexBuffer(T* destination, size_t index_count, const unsigned char* buffer, size_t buffer_size)
 {
@@ -462,6 +862,45 @@ inline int meshopt_decodeIndexBuffer(T* destination, size_t index_count, const u
 	return meshopt_decodeIndexBuffer(destination, index_count, sizeof(T), buffer, buffer_size);
 }
 
+template <typename T>
+inline size_t meshopt_encodeIndexSequence(unsigned char* buffer, size_t buffer_size, const T* indices, size_t index_count)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	// 16-bit restart indices are widened to 0xffff by the adapter and need to be mapped back to ~0u
+	if (sizeof(T) == 2)
+		for (size_t i = 0; i < index_count; ++i)
+			in.data[i] = (in.data[i] == 0xffff) ? ~0u : in.data[i];
+
+	return meshopt_encodeIndexSequence(buffer, buffer_size, in.data, index_count);
+}
+
+template <typename T>
+inline int meshopt_decodeIndexSequence(T* destination, size_t index_count, const unsigned char* buffer, size_t buffer_size)
+{
+	char index_size_valid[sizeof(T) == 2 || sizeof(T) == 4 ? 1 : -1];
+	(void)index_size_valid;
+
+	return meshopt_decodeIndexSequence(destination, index_count, sizeof(T), buffer, buffer_size);
+}
+
+template <typename T>
+inline size_t meshopt_encodeIndexBufferChunked(unsigned char* buffer, size_t buffer_size, const T* indices, size_t index_count, meshopt_Dispatch dispatch, void* dispatch_context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_encodeIndexBufferChunked(buffer, buffer_size, in.data, index_count, dispatch, dispatch_context);
+}
+
+template <typename T>
+inline int meshopt_decodeIndexBufferParallel(T* destination, size_t index_count, const unsigned char* buffer, size_t buffer_size, meshopt_Dispatch dispatch, void* dispatch_context)
+{
+	char index_size_valid[sizeof(T) == 2 || sizeof(T) == 4 ? 1 : -1];
+	(void)index_size_valid;
+
+	return meshopt_decodeIndexBufferParallel(destination, index_count, sizeof(T), buffer, buffer_size, dispatch, dispatch_context);
+}
+
 template <typename T>
 inline size_t meshopt_simplify(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error)
 {
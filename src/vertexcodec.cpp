@@ -2,6 +2,7 @@
 #include "meshoptimizer.h"
 
 #include <assert.h>
+#include <math.h>
 #include <string.h>
 
 #ifdef __ARM_NEON__
@@ -12,16 +13,52 @@
 #define SIMD_SSE
 #endif
 
-#if !defined(SIMD_SSE) && defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#ifdef __AVX2__
+#define SIMD_AVX
+#endif
+
+// MSVC and GCC/Clang can compile SSSE3/AVX2 kernels without enabling the instruction sets globally; these kernels are selected at runtime
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define SIMD_DISPATCH_SSE
+#if _MSC_VER >= 1800
+#define SIMD_DISPATCH_AVX
+#endif
+#endif
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define SIMD_DISPATCH_SSE
+#define SIMD_DISPATCH_AVX
+#define SIMD_TARGET_SSE __attribute__((target("ssse3")))
+#define SIMD_TARGET_AVX __attribute__((target("avx2,popcnt")))
+#endif
+
+#if !defined(SIMD_SSE) && defined(SIMD_DISPATCH_SSE)
 #define SIMD_SSE
 #define SIMD_FALLBACK
-#include <intrin.h>
+#endif
+
+#if !defined(SIMD_AVX) && defined(SIMD_DISPATCH_AVX)
+#define SIMD_AVX
+#define SIMD_AVX_FALLBACK
+#endif
+
+#ifndef SIMD_TARGET_SSE
+#define SIMD_TARGET_SSE
+#define SIMD_TARGET_AVX
 #endif
 
 #ifdef SIMD_SSE
 #include <tmmintrin.h>
 #endif
 
+#ifdef SIMD_AVX
+#include <immintrin.h>
+#endif
+
+#if (defined(SIMD_SSE) || defined(SIMD_AVX)) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #ifdef SIMD_NEON
 #include <arm_neon.h>
 #endif
@@ -30,12 +67,21 @@ namespace meshopt
 {
 
 const unsigned char kVertexHeader = 0xa0;
+const unsigned char kVertexHeaderSeekable = 0x08;
+const unsigned char kVertexHeaderVersion = 0x07;
+
+static int gEncodeVertexVersion = 0;
+
+const int kEncodeVertexLevelDefault = 2;
 
 const size_t kVertexBlockSizeBytes = 8192;
+const size_t kVertexSizeMax = 512;
 const size_t kVertexBlockMaxSize = 256;
 const size_t kByteGroupSize = 16;
 const size_t kTailMaxSize = 32;
 
+const size_t kVertexBlocksPerTask = 8;
+
 static size_t getVertexBlockSize(size_t vertex_size)
 {
 	// make sure the entire block fits into the scratch buffer
@@ -58,6 +104,35 @@ inline unsigned char unzigzag8(unsigned char v)
 	return -(v & 1) ^ (v >> 1);
 }
 
+static void encodeDeltas1(unsigned char* buffer, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char p)
+{
+	size_t vertex_offset = 0;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		buffer[i] = zigzag8(vertex_data[vertex_offset] - p);
+
+		p = vertex_data[vertex_offset];
+
+		vertex_offset += vertex_size;
+	}
+}
+
+static void decodeDeltas1(unsigned char* vertex_data, const unsigned char* buffer, size_t vertex_count, size_t vertex_size, unsigned char p)
+{
+	size_t vertex_offset = 0;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		unsigned char v = unzigzag8(buffer[i]) + p;
+
+		vertex_data[vertex_offset] = v;
+		p = v;
+
+		vertex_offset += vertex_size;
+	}
+}
+
 static bool encodeBytesGroupZero(const unsigned char* buffer)
 {
 	for (size_t i = 0; i < kByteGroupSize; ++i)
@@ -87,6 +162,17 @@ static size_t encodeBytesGroupMeasure(const unsigned char* buffer, int bits)
 	return result;
 }
 
+static int encodeBytesGroupFit(const unsigned char* buffer)
+{
+	unsigned char max = 0;
+
+	for (size_t i = 0; i < kByteGroupSize; ++i)
+		max = buffer[i] > max ? buffer[i] : max;
+
+	// smallest bit width that doesn't need sentinels; values equal to the sentinel need to be stored separately as well
+	return (max == 0) ? 1 : (max < 3) ? 2 : (max < 15) ? 4 : 8;
+}
+
 static unsigned char* encodeBytesGroup(unsigned char* data, const unsigned char* buffer, int bits)
 {
 	assert(bits >= 1 && bits <= 8);
@@ -133,7 +219,7 @@ static unsigned char* encodeBytesGroup(unsigned char* data, const unsigned char*
 	return data;
 }
 
-static unsigned char* encodeBytes(unsigned char* data, unsigned char* data_end, const unsigned char* buffer, size_t buffer_size)
+static unsigned char* encodeBytes(unsigned char* data, unsigned char* data_end, const unsigned char* buffer, size_t buffer_size, int level)
 {
 	assert(buffer_size % kByteGroupSize == 0);
 
@@ -157,14 +243,23 @@ static unsigned char* encodeBytes(unsigned char* data, unsigned char* data_end,
 		int best_bits = 8;
 		size_t best_size = encodeBytesGroupMeasure(buffer + i, 8);
 
-		for (int bits = 1; bits < 8; bits *= 2)
+		// level 0 skips the measurement passes and picks the smallest bit width that fits all values
+		if (level == 0)
 		{
-			size_t size = encodeBytesGroupMeasure(buffer + i, bits);
-
-			if (size < best_size)
+			best_bits = encodeBytesGroupFit(buffer + i);
+			best_size = encodeBytesGroupMeasure(buffer + i, best_bits);
+		}
+		else
+		{
+			for (int bits = 1; bits < 8; bits *= 2)
 			{
-				best_bits = bits;
-				best_size = size;
+				size_t size = encodeBytesGroupMeasure(buffer + i, bits);
+
+				if (size < best_size)
+				{
+					best_bits = bits;
+					best_size = size;
+				}
 			}
 		}
 
@@ -184,7 +279,7 @@ static unsigned char* encodeBytes(unsigned char* data, unsigned char* data_end,
 	return data;
 }
 
-static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data_end, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256])
+static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data_end, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[kVertexSizeMax], int level)
 {
 	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
 
@@ -196,20 +291,9 @@ static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data
 
 	for (size_t k = 0; k < vertex_size; ++k)
 	{
-		size_t vertex_offset = k;
+		encodeDeltas1(buffer, vertex_data + k, vertex_count, vertex_size, last_vertex[k]);
 
-		unsigned char p = last_vertex[k];
-
-		for (size_t i = 0; i < vertex_count; ++i)
-		{
-			buffer[i] = zigzag8(vertex_data[vertex_offset] - p);
-
-			p = vertex_data[vertex_offset];
-
-			vertex_offset += vertex_size;
-		}
-
-		data = encodeBytes(data, data_end, buffer, (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1));
+		data = encodeBytes(data, data_end, buffer, (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1), level);
 		if (!data)
 			return 0;
 	}
@@ -219,396 +303,461 @@ static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data
 	return data;
 }
 
-#if defined(SIMD_FALLBACK) || (!defined(SIMD_SSE) && !defined(SIMD_NEON))
-static const unsigned char* decodeBytesGroup(const unsigned char* data, unsigned char* buffer, int bitslog2)
+// format version 1 can use different bit widths for each byte stream; the 2-bit control of each stream selects one of these sets
+const int kBitsV1[3][4] = {
+    {0, 2, 4, 8},
+    {0, 1, 2, 4},
+    {0, 4, 6, 8},
+};
+
+// format version 1 stores each 4-byte word of a vertex using one of these transforms
+enum DeltaModeV1
 {
-#define READ() byte = *data++
-#define NEXT(bits) enc = byte >> (8 - bits), byte <<= bits, encv = *data_var, *buffer++ = (enc == (1 << bits) - 1) ? encv : enc, data_var += (enc == (1 << bits) - 1)
+	kDeltaByte,  // 8-bit deltas, same as version 0
+	kDeltaShort, // 16-bit deltas
+	kDeltaWord,  // 32-bit deltas
+	kDeltaXor,   // 32-bit xor with previous value
 
-	unsigned char byte, enc, encv;
-	const unsigned char* data_var;
+	kDeltaCount
+};
 
-	switch (bitslog2)
-	{
-	case 0:
-		memset(buffer, 0, kByteGroupSize);
-		return data;
-	case 1:
-		data_var = data + 4;
+// the mode byte of each word stores the transform in the low 2 bits and the distance to the vertex the deltas are computed against minus one in the next 2 bits
+// distances above one are useful for unindexed triangle (3) and quad (4) soups, where vertices correlate with the same corner of the previous primitive
+const int kDeltaStrideMax = 4;
 
-		// 4 groups with 4 2-bit values in each byte
-		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
-		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
-		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
-		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
+static size_t encodeBytesGroupMeasureV1(const unsigned char* buffer, int bits)
+{
+	if (bits == 0)
+		return encodeBytesGroupZero(buffer) ? 0 : size_t(-1);
 
-		return data_var;
-	case 2:
-		data_var = data + 8;
+	if (bits == 8)
+		return kByteGroupSize;
 
-		// 8 groups with 2 4-bit values in each byte
-		READ(), NEXT(4), NEXT(4);
-		READ(), NEXT(4), NEXT(4);
-		READ(), NEXT(4), NEXT(4);
-		READ(), NEXT(4), NEXT(4);
-		READ(), NEXT(4), NEXT(4);
-		READ(), NEXT(4), NEXT(4);
-		READ(), NEXT(4), NEXT(4);
-		READ(), NEXT(4), NEXT(4);
+	size_t result = kByteGroupSize * bits / 8;
 
-		return data_var;
-	case 3:
-		memcpy(buffer, data, kByteGroupSize);
-		return data + kByteGroupSize;
-	default:
-		assert(!"Unexpected bit length"); // This can never happen since bitslog2 is a 2-bit value
-		return data;
-	}
+	unsigned char sentinel = (unsigned char)((1 << bits) - 1);
 
-#undef READ
-#undef NEXT
+	for (size_t i = 0; i < kByteGroupSize; ++i)
+		result += buffer[i] >= sentinel;
+
+	return result;
 }
 
-static const unsigned char* decodeBytes(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size)
+static unsigned char* encodeBytesGroupV1(unsigned char* data, const unsigned char* buffer, int bits)
 {
-	assert(buffer_size % kByteGroupSize == 0);
-
-	const unsigned char* header = data;
+	if (bits == 0)
+		return data;
 
-	// round number of groups to 4 to get number of header bytes
-	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+	if (bits == 8)
+	{
+		memcpy(data, buffer, kByteGroupSize);
+		return data + kByteGroupSize;
+	}
 
-	if (size_t(data_end - data) < header_size)
-		return 0;
+	// fixed portion: bits bits for each value, first value in high bits; variable portion: full byte for each out-of-range value
+	unsigned char sentinel = (unsigned char)((1 << bits) - 1);
 
-	data += header_size;
+	unsigned int acc = 0;
+	int acc_bits = 0;
 
-	for (size_t i = 0; i < buffer_size; i += kByteGroupSize)
+	for (size_t i = 0; i < kByteGroupSize; ++i)
 	{
-		if (size_t(data_end - data) < kTailMaxSize)
-			return 0;
-
-		size_t header_offset = i / kByteGroupSize;
+		unsigned char enc = (buffer[i] >= sentinel) ? sentinel : buffer[i];
 
-		int bitslog2 = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+		acc = (acc << bits) | enc;
+		acc_bits += bits;
 
-		data = decodeBytesGroup(data, buffer + i, bitslog2);
+		while (acc_bits >= 8)
+		{
+			*data++ = (unsigned char)(acc >> (acc_bits - 8));
+			acc_bits -= 8;
+		}
 	}
 
+	assert(acc_bits == 0);
+
+	for (size_t i = 0; i < kByteGroupSize; ++i)
+		if (buffer[i] >= sentinel)
+			*data++ = buffer[i];
+
 	return data;
 }
 
-static const unsigned char* decodeVertexBlock(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256])
+static int encodeBytesGroupSelectV1(const unsigned char* buffer, int control, size_t* out_size)
 {
-	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+	// prefer smaller bit widths on ties, similarly to encodeBytes
+	int best = 3;
+	size_t best_size = encodeBytesGroupMeasureV1(buffer, kBitsV1[control][3]);
 
-	unsigned char buffer[kVertexBlockMaxSize];
-	unsigned char transposed[kVertexBlockSizeBytes];
+	for (int i = 0; i < 3; ++i)
+	{
+		size_t size = encodeBytesGroupMeasureV1(buffer, kBitsV1[control][i]);
 
-	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+		if (size < best_size)
+		{
+			best = i;
+			best_size = size;
+		}
+	}
 
-	for (size_t k = 0; k < vertex_size; ++k)
+	*out_size = best_size;
+	return best;
+}
+
+static int encodeBytesGroupFitV1(const unsigned char* buffer, int control)
+{
+	unsigned char max = 0;
+
+	for (size_t i = 0; i < kByteGroupSize; ++i)
+		max = buffer[i] > max ? buffer[i] : max;
+
+	for (int i = 0; i < 3; ++i)
 	{
-		data = decodeBytes(data, data_end, buffer, vertex_count_aligned);
-		if (!data)
-			return 0;
+		int bits = kBitsV1[control][i];
 
-		size_t vertex_offset = k;
+		if (max < (1 << bits) - 1 || (bits == 0 && max == 0))
+			return i;
+	}
 
-		unsigned char p = last_vertex[k];
+	return 3;
+}
 
-		for (size_t i = 0; i < vertex_count; ++i)
-		{
-			unsigned char v = unzigzag8(buffer[i]) + p;
+static size_t estimateBytesV1(const unsigned char* buffer, size_t buffer_size, int control)
+{
+	size_t result = (buffer_size / kByteGroupSize + 3) / 4;
 
-			transposed[vertex_offset] = v;
-			p = v;
+	for (size_t i = 0; i < buffer_size; i += kByteGroupSize)
+	{
+		size_t size = 0;
+		encodeBytesGroupSelectV1(buffer + i, control, &size);
 
-			vertex_offset += vertex_size;
-		}
+		result += size;
 	}
 
-	memcpy(vertex_data, transposed, vertex_count * vertex_size);
+	return result;
+}
 
-	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+static unsigned char* encodeBytesV1(unsigned char* data, unsigned char* data_end, const unsigned char* buffer, size_t buffer_size, int control, int level)
+{
+	assert(buffer_size % kByteGroupSize == 0);
 
-	return data;
-}
-#endif
+	unsigned char* header = data;
 
-#if defined(SIMD_SSE) || defined(SIMD_NEON)
-static unsigned char kDecodeBytesGroupShuffle[256][8];
-static unsigned char kDecodeBytesGroupCount[256];
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
 
-static bool decodeBytesGroupBuildTables()
-{
-	for (int mask = 0; mask < 256; ++mask)
+	if (size_t(data_end - data) < header_size)
+		return 0;
+
+	data += header_size;
+
+	memset(header, 0, header_size);
+
+	for (size_t i = 0; i < buffer_size; i += kByteGroupSize)
 	{
-		unsigned char shuffle[8];
-		unsigned char count = 0;
+		if (size_t(data_end - data) < kTailMaxSize)
+			return 0;
 
-		for (int i = 0; i < 8; ++i)
+		size_t best_size = 0;
+		int best = 0;
+
+		// level 0 skips the measurement passes and picks the smallest bit width that fits all values
+		if (level == 0)
 		{
-			int maski = (mask >> i) & 1;
-			shuffle[i] = maski ? count : 0x80;
-			count += char(maski);
+			best = encodeBytesGroupFitV1(buffer + i, control);
+			best_size = encodeBytesGroupMeasureV1(buffer + i, kBitsV1[control][best]);
 		}
+		else
+			best = encodeBytesGroupSelectV1(buffer + i, control, &best_size);
 
-		memcpy(kDecodeBytesGroupShuffle[mask], shuffle, 8);
-		kDecodeBytesGroupCount[mask] = count;
+		size_t header_offset = i / kByteGroupSize;
+
+		header[header_offset / 4] |= best << ((header_offset % 4) * 2);
+
+		unsigned char* next = encodeBytesGroupV1(data, buffer + i, kBitsV1[control][best]);
+
+		assert(data + best_size == next);
+		data = next;
 	}
 
-	return true;
+	return data;
 }
 
-static bool gDecodeBytesGroupInitialized = decodeBytesGroupBuildTables();
-#endif
+inline unsigned int readWord(const unsigned char* data)
+{
+	return data[0] | (data[1] << 8) | (data[2] << 16) | (unsigned(data[3]) << 24);
+}
 
-#ifdef SIMD_SSE
-static __m128i decodeShuffleMask(unsigned char mask0, unsigned char mask1)
+inline void writeWord(unsigned char* data, unsigned int v)
 {
-	__m128i sm0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kDecodeBytesGroupShuffle[mask0]));
-	__m128i sm1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kDecodeBytesGroupShuffle[mask1]));
-	__m128i sm1off = _mm_set1_epi8(kDecodeBytesGroupCount[mask0]);
+	data[0] = (unsigned char)(v);
+	data[1] = (unsigned char)(v >> 8);
+	data[2] = (unsigned char)(v >> 16);
+	data[3] = (unsigned char)(v >> 24);
+}
 
-	__m128i sm1r = _mm_add_epi8(sm1, sm1off);
+// the last word of vertices that aren't a multiple of 4 bytes has fewer bytes; missing bytes are treated as zero
+static unsigned int readWordPartial(const unsigned char* data, size_t size)
+{
+	unsigned int result = 0;
 
-	return _mm_unpacklo_epi64(sm0, sm1r);
+	for (size_t i = 0; i < size; ++i)
+		result |= unsigned(data[i]) << (i * 8);
+
+	return result;
 }
 
-static void transpose8(__m128i& x0, __m128i& x1, __m128i& x2, __m128i& x3)
+static void writeWordPartial(unsigned char* data, unsigned int v, size_t size)
 {
-	__m128i t0 = _mm_unpacklo_epi8(x0, x1);
-	__m128i t1 = _mm_unpackhi_epi8(x0, x1);
-	__m128i t2 = _mm_unpacklo_epi8(x2, x3);
-	__m128i t3 = _mm_unpackhi_epi8(x2, x3);
+	for (size_t i = 0; i < size; ++i)
+		data[i] = (unsigned char)(v >> (i * 8));
+}
 
-	x0 = _mm_unpacklo_epi16(t0, t2);
-	x1 = _mm_unpackhi_epi16(t0, t2);
-	x2 = _mm_unpacklo_epi16(t1, t3);
-	x3 = _mm_unpackhi_epi16(t1, t3);
+inline unsigned short zigzag16(unsigned short v)
+{
+	return (unsigned short)((short(v) >> 15) ^ (v << 1));
 }
 
-static __m128i unzigzag8(__m128i v)
+inline unsigned short unzigzag16(unsigned short v)
 {
-	__m128i xl = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi8(1)));
-	__m128i xr = _mm_and_si128(_mm_srli_epi16(v, 1), _mm_set1_epi8(127));
+	return (unsigned short)(-(v & 1) ^ (v >> 1));
+}
 
-	return _mm_xor_si128(xl, xr);
+inline unsigned int zigzag32(unsigned int v)
+{
+	return (unsigned int)(int(v) >> 31) ^ (v << 1);
 }
 
-static const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsigned char* buffer, int bitslog2)
+inline unsigned int unzigzag32(unsigned int v)
 {
-	switch (bitslog2)
-	{
-	case 0:
+	return (0u - (v & 1)) ^ (v >> 1);
+}
+
+static unsigned int encodeDeltaV1(unsigned int v, unsigned int p, int mode)
+{
+	switch (mode)
 	{
-		__m128i result = _mm_setzero_si128();
+	case kDeltaByte:
+		return zigzag8((unsigned char)(v - p)) | (zigzag8((unsigned char)((v >> 8) - (p >> 8))) << 8) | (zigzag8((unsigned char)((v >> 16) - (p >> 16))) << 16) | (unsigned(zigzag8((unsigned char)((v >> 24) - (p >> 24)))) << 24);
 
-		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+	case kDeltaShort:
+		return zigzag16((unsigned short)(v - p)) | (unsigned(zigzag16((unsigned short)((v >> 16) - (p >> 16)))) << 16);
 
-		return data;
+	case kDeltaWord:
+		return zigzag32(v - p);
+
+	default:
+		return v ^ p;
 	}
+}
 
-	case 1:
+static unsigned int decodeDeltaV1(unsigned int d, unsigned int p, int mode)
+{
+	switch (mode)
 	{
-#ifdef __GNUC__
-		typedef int __attribute__((aligned(1))) unaligned_int;
-#else
-		typedef int unaligned_int;
-#endif
+	case kDeltaByte:
+		return ((unzigzag8((unsigned char)d) + p) & 0xff) | (((unzigzag8((unsigned char)(d >> 8)) + (p >> 8)) & 0xff) << 8) | (((unzigzag8((unsigned char)(d >> 16)) + (p >> 16)) & 0xff) << 16) | ((unzigzag8((unsigned char)(d >> 24)) + (p >> 24)) << 24);
 
-		__m128i sel2 = _mm_cvtsi32_si128(*reinterpret_cast<const unaligned_int*>(data));
-		__m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4));
+	case kDeltaShort:
+		return ((unzigzag16((unsigned short)d) + p) & 0xffff) | ((unzigzag16((unsigned short)(d >> 16)) + (p >> 16)) << 16);
 
-		__m128i sel22 = _mm_unpacklo_epi8(_mm_srli_epi16(sel2, 4), sel2);
-		__m128i sel2222 = _mm_unpacklo_epi8(_mm_srli_epi16(sel22, 2), sel22);
-		__m128i sel = _mm_and_si128(sel2222, _mm_set1_epi8(3));
-
-		__m128i mask = _mm_cmpeq_epi8(sel, _mm_set1_epi8(3));
-		int mask16 = _mm_movemask_epi8(mask);
-		unsigned char mask0 = (unsigned char)(mask16 & 255);
-		unsigned char mask1 = (unsigned char)(mask16 >> 8);
+	case kDeltaWord:
+		return unzigzag32(d) + p;
 
-		__m128i shuf = decodeShuffleMask(mask0, mask1);
+	default:
+		return d ^ p;
+	}
+}
 
-		__m128i result = _mm_or_si128(_mm_shuffle_epi8(rest, shuf), _mm_andnot_si128(mask, sel));
+static void encodeDeltasV1(unsigned char buffer[4][kVertexBlockMaxSize], const unsigned char* vertex_data, size_t vertex_count, size_t vertex_count_aligned, size_t vertex_size, size_t offset, size_t word_size, const unsigned char* last_vertex, int mode, int stride)
+{
+	// vertices before the start of the block all use the last vertex of the previous block as a reference
+	unsigned int last = readWordPartial(last_vertex + offset, word_size);
 
-		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const unsigned char* vertex = vertex_data + i * vertex_size + offset;
 
-		return data + 4 + kDecodeBytesGroupCount[mask0] + kDecodeBytesGroupCount[mask1];
-	}
+		unsigned int v = (word_size == 4) ? readWord(vertex) : readWordPartial(vertex, word_size);
+		unsigned int p = last;
 
-	case 2:
-	{
-		__m128i sel4 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
-		__m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 8));
+		// the reference pointer is only formed when it's inside the block, as pointing before vertex_data is undefined
+		if (i >= size_t(stride))
+		{
+			const unsigned char* reference = vertex - stride * vertex_size;
+			p = (word_size == 4) ? readWord(reference) : readWordPartial(reference, word_size);
+		}
 
-		__m128i sel44 = _mm_unpacklo_epi8(_mm_srli_epi16(sel4, 4), sel4);
-		__m128i sel = _mm_and_si128(sel44, _mm_set1_epi8(15));
+		unsigned int d = encodeDeltaV1(v, p, mode);
 
-		__m128i mask = _mm_cmpeq_epi8(sel, _mm_set1_epi8(15));
-		int mask16 = _mm_movemask_epi8(mask);
-		unsigned char mask0 = (unsigned char)(mask16 & 255);
-		unsigned char mask1 = (unsigned char)(mask16 >> 8);
+		buffer[0][i] = (unsigned char)(d);
+		buffer[1][i] = (unsigned char)(d >> 8);
+		buffer[2][i] = (unsigned char)(d >> 16);
+		buffer[3][i] = (unsigned char)(d >> 24);
+	}
 
-		__m128i shuf = decodeShuffleMask(mask0, mask1);
+	// we sometimes encode elements we didn't fill when rounding to kByteGroupSize
+	for (size_t j = 0; j < 4; ++j)
+		memset(buffer[j] + vertex_count, 0, vertex_count_aligned - vertex_count);
+}
 
-		__m128i result = _mm_or_si128(_mm_shuffle_epi8(rest, shuf), _mm_andnot_si128(mask, sel));
+static unsigned char* encodeVertexBlockV1(unsigned char* data, unsigned char* data_end, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[kVertexSizeMax], int level)
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
 
-		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+	unsigned char buffer[4][kVertexBlockMaxSize];
 
-		return data + 8 + kDecodeBytesGroupCount[mask0] + kDecodeBytesGroupCount[mask1];
-	}
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
 
-	case 3:
-	{
-		__m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+	// each 4-byte word has a mode byte and a control byte with 2 bits for each byte stream; the last word may be partial
+	size_t word_count = (vertex_size + 3) / 4;
 
-		__m128i result = rest;
+	if (size_t(data_end - data) < word_count * 2)
+		return 0;
 
-		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+	unsigned char* modes = data;
+	data += word_count * 2;
 
-		return data + 16;
-	}
+	// level 0 uses 8-bit deltas with default bit widths, level 1 searches bit widths, level 2 also searches delta modes and level 3 also searches delta strides
+	int mode_count = (level >= 2) ? kDeltaCount : 1;
+	int stride_count = (level >= 3) ? kDeltaStrideMax : 1;
 
-	default:
-		assert(!"Unexpected bit length"); // This can never happen since bitslog2 is a 2-bit value
-		return data;
-	}
-}
-#endif
+	for (size_t k = 0; k < word_count; ++k)
+	{
+		size_t word_size = (k * 4 + 4 <= vertex_size) ? 4 : vertex_size - k * 4;
 
-#ifdef SIMD_NEON
-static uint8x16_t shuffleBytes(unsigned char mask0, unsigned char mask1, uint8x8_t rest0, uint8x8_t rest1)
-{
-	uint8x8_t sm0 = vld1_u8(kDecodeBytesGroupShuffle[mask0]);
-	uint8x8_t sm1 = vld1_u8(kDecodeBytesGroupShuffle[mask1]);
+		int best_mode = 0;
+		int best_stride = 1;
+		int best_controls = 0;
+		size_t best_size = ~size_t(0);
 
-	uint8x8_t r0 = vtbl1_u8(rest0, sm0);
-	uint8x8_t r1 = vtbl1_u8(rest1, sm1);
+		// level 0 doesn't estimate sizes since there's nothing to choose from
+		if (level >= 1)
+		{
+			// partial words only support 8-bit deltas since wider deltas would need the missing bytes
+			for (int mode = 0; mode < (word_size == 4 ? mode_count : 1); ++mode)
+				for (int stride = 1; stride <= stride_count; ++stride)
+				{
+					encodeDeltasV1(buffer, vertex_data, vertex_count, vertex_count_aligned, vertex_size, k * 4, word_size, last_vertex, mode, stride);
+
+					size_t size = 0;
+					int controls = 0;
+
+					for (int j = 0; j < int(word_size); ++j)
+					{
+						int best_control = 0;
+						size_t best_control_size = estimateBytesV1(buffer[j], vertex_count_aligned, 0);
+
+						for (int control = 1; control < 3; ++control)
+						{
+							size_t control_size = estimateBytesV1(buffer[j], vertex_count_aligned, control);
+
+							if (control_size < best_control_size)
+							{
+								best_control = control;
+								best_control_size = control_size;
+							}
+						}
+
+						size += best_control_size;
+						controls |= best_control << (j * 2);
+					}
+
+					if (size < best_size)
+					{
+						best_mode = mode;
+						best_stride = stride;
+						best_controls = controls;
+						best_size = size;
+					}
+				}
+		}
 
-	return vcombine_u8(r0, r1);
-}
+		modes[k * 2 + 0] = (unsigned char)(best_mode | ((best_stride - 1) << 2));
+		modes[k * 2 + 1] = (unsigned char)best_controls;
 
-static int neonMoveMask(uint8x16_t mask)
-{
-	static const uint8x16_t byte_mask = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+		encodeDeltasV1(buffer, vertex_data, vertex_count, vertex_count_aligned, vertex_size, k * 4, word_size, last_vertex, best_mode, best_stride);
 
-	uint8x16_t masked = vandq_u8(mask, byte_mask);
+		for (int j = 0; j < int(word_size); ++j)
+		{
+			data = encodeBytesV1(data, data_end, buffer[j], vertex_count_aligned, (best_controls >> (j * 2)) & 3, level);
+			if (!data)
+				return 0;
+		}
+	}
 
-	// we need horizontal sums of each half of masked
-	// the endianness of the platform determines the order of high/low in sum1 below
-	// we assume little endian here
-	uint8x8_t sum1 = vpadd_u8(vget_low_u8(masked), vget_high_u8(masked));
-	uint8x8_t sum2 = vpadd_u8(sum1, sum1);
-	uint8x8_t sum3 = vpadd_u8(sum2, sum2);
+	memcpy(last_vertex, &vertex_data[vertex_size * (vertex_count - 1)], vertex_size);
 
-	// note: here we treat 2b sum as a 16bit mask; this depends on endianness, see above
-	return vget_lane_u16(vreinterpret_u16_u8(sum3), 0);
+	return data;
 }
 
-static void transpose8(uint8x16_t& x0, uint8x16_t& x1, uint8x16_t& x2, uint8x16_t& x3)
+// the last word of a vertex can be partial, in which case only 8-bit deltas are supported and SIMD decoders use this as well
+static void decodeDeltasV1(unsigned char* vertex_data, const unsigned char* buffer, size_t buffer_stride, size_t vertex_count, size_t vertex_size, size_t word_size, unsigned int p, int mode, int stride)
 {
-	uint8x16x2_t t01 = vzipq_u8(x0, x1);
-	uint8x16x2_t t23 = vzipq_u8(x2, x3);
+	// last kDeltaStrideMax decoded values, indexed by vertex index modulo 4; vertices before the start of the block use p
+	unsigned int history[kDeltaStrideMax] = {p, p, p, p};
 
-	uint16x8x2_t x01 = vzipq_u16(vreinterpretq_u16_u8(t01.val[0]), vreinterpretq_u16_u8(t23.val[0]));
-	uint16x8x2_t x23 = vzipq_u16(vreinterpretq_u16_u8(t01.val[1]), vreinterpretq_u16_u8(t23.val[1]));
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		unsigned int d = buffer[i] | (buffer[i + buffer_stride] << 8) | (buffer[i + buffer_stride * 2] << 16) | (unsigned(buffer[i + buffer_stride * 3]) << 24);
+		unsigned int v = decodeDeltaV1(d, history[(i - stride) & 3], mode);
 
-	x0 = x01.val[0];
-	x1 = x01.val[1];
-	x2 = x23.val[0];
-	x3 = x23.val[1];
-}
+		unsigned char* vertex = vertex_data + i * vertex_size;
 
-static uint8x16_t unzigzag8(uint8x16_t v)
-{
-	uint8x16_t xl = vreinterpretq_u8_s8(vnegq_s8(vreinterpretq_s8_u8(vandq_u8(v, vdupq_n_u8(1)))));
-	uint8x16_t xr = vshrq_n_u8(v, 1);
+		if (word_size == 4)
+			writeWord(vertex, v);
+		else
+			writeWordPartial(vertex, v, word_size);
 
-	return veorq_u8(xl, xr);
+		history[i & 3] = v;
+	}
 }
 
-static const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsigned char* buffer, int bitslog2)
+#if defined(SIMD_FALLBACK) || !defined(SIMD_SSE)
+static const unsigned char* decodeBytesGroupV1(const unsigned char* data, unsigned char* buffer, int bits)
 {
-	switch (bitslog2)
+	if (bits == 0)
 	{
-	case 0:
-	{
-		uint8x16_t result = vdupq_n_u8(0);
-
-		vst1q_u8(buffer, result);
-
+		memset(buffer, 0, kByteGroupSize);
 		return data;
 	}
 
-	case 1:
+	if (bits == 8)
 	{
-		uint8x8_t sel2 = vld1_u8(data);
-		uint8x8_t sel22 = vzip_u8(vshr_n_u8(sel2, 4), sel2).val[0];
-		uint8x8x2_t sel2222 = vzip_u8(vshr_n_u8(sel22, 2), sel22);
-		uint8x16_t sel = vandq_u8(vcombine_u8(sel2222.val[0], sel2222.val[1]), vdupq_n_u8(3));
-
-		uint8x16_t mask = vceqq_u8(sel, vdupq_n_u8(3));
-		int mask16 = neonMoveMask(mask);
-		unsigned char mask0 = (unsigned char)(mask16 & 255);
-		unsigned char mask1 = (unsigned char)(mask16 >> 8);
-
-		uint8x8_t rest0 = vld1_u8(data + 4);
-		uint8x8_t rest1 = vld1_u8(data + 4 + kDecodeBytesGroupCount[mask0]);
-
-		uint8x16_t result = vbslq_u8(mask, shuffleBytes(mask0, mask1, rest0, rest1), sel);
-
-		vst1q_u8(buffer, result);
-
-		return data + 4 + kDecodeBytesGroupCount[mask0] + kDecodeBytesGroupCount[mask1];
+		memcpy(buffer, data, kByteGroupSize);
+		return data + kByteGroupSize;
 	}
 
-	case 2:
-	{
-		uint8x8_t sel4 = vld1_u8(data);
-		uint8x8x2_t sel44 = vzip_u8(vshr_n_u8(sel4, 4), vand_u8(sel4, vdup_n_u8(15)));
-		uint8x16_t sel = vcombine_u8(sel44.val[0], sel44.val[1]);
-
-		uint8x16_t mask = vceqq_u8(sel, vdupq_n_u8(15));
-		int mask16 = neonMoveMask(mask);
-		unsigned char mask0 = (unsigned char)(mask16 & 255);
-		unsigned char mask1 = (unsigned char)(mask16 >> 8);
-
-		uint8x8_t rest0 = vld1_u8(data + 8);
-		uint8x8_t rest1 = vld1_u8(data + 8 + kDecodeBytesGroupCount[mask0]);
-
-		uint8x16_t result = vbslq_u8(mask, shuffleBytes(mask0, mask1, rest0, rest1), sel);
+	const unsigned char* data_var = data + kByteGroupSize * bits / 8;
 
-		vst1q_u8(buffer, result);
+	unsigned int sentinel = (1 << bits) - 1;
 
-		return data + 8 + kDecodeBytesGroupCount[mask0] + kDecodeBytesGroupCount[mask1];
-	}
+	unsigned int acc = 0;
+	int acc_bits = 0;
 
-	case 3:
+	for (size_t i = 0; i < kByteGroupSize; ++i)
 	{
-		uint8x16_t rest = vld1q_u8(data);
-
-		uint8x16_t result = rest;
+		if (acc_bits < bits)
+		{
+			acc = (acc << 8) | *data++;
+			acc_bits += 8;
+		}
 
-		vst1q_u8(buffer, result);
+		unsigned int enc = (acc >> (acc_bits - bits)) & sentinel;
+		acc_bits -= bits;
 
-		return data + 16;
+		buffer[i] = (enc == sentinel) ? *data_var++ : (unsigned char)enc;
 	}
 
-	default:
-		assert(!"Unexpected bit length"); // This can never happen since bitslog2 is a 2-bit value
-		return data;
-	}
+	return data_var;
 }
-#endif
 
-#if defined(SIMD_SSE) || defined(SIMD_NEON)
-static const unsigned char* decodeBytesSimd(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size)
+static const unsigned char* decodeBytesV1(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size, int control)
 {
 	assert(buffer_size % kByteGroupSize == 0);
-	assert(kByteGroupSize == 16);
+
+	if (control > 2)
+		return 0;
 
 	const unsigned char* header = data;
 
@@ -620,37 +769,22 @@ static const unsigned char* decodeBytesSimd(const unsigned char* data, const uns
 
 	data += header_size;
 
-	size_t i = 0;
-
-	// fast-path: process 4 groups at a time, do a shared bounds check - each group reads <=32b
-	for (; i + kByteGroupSize * 4 <= buffer_size && size_t(data_end - data) >= kTailMaxSize * 4; i += kByteGroupSize * 4)
-	{
-		size_t header_offset = i / kByteGroupSize;
-		unsigned char header_byte = header[header_offset / 4];
-
-		data = decodeBytesGroupSimd(data, buffer + i + kByteGroupSize * 0, (header_byte >> 0) & 3);
-		data = decodeBytesGroupSimd(data, buffer + i + kByteGroupSize * 1, (header_byte >> 2) & 3);
-		data = decodeBytesGroupSimd(data, buffer + i + kByteGroupSize * 2, (header_byte >> 4) & 3);
-		data = decodeBytesGroupSimd(data, buffer + i + kByteGroupSize * 3, (header_byte >> 6) & 3);
-	}
-
-	// slow-path: process remaining groups
-	for (; i < buffer_size; i += kByteGroupSize)
+	for (size_t i = 0; i < buffer_size; i += kByteGroupSize)
 	{
 		if (size_t(data_end - data) < kTailMaxSize)
 			return 0;
 
 		size_t header_offset = i / kByteGroupSize;
 
-		int bitslog2 = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+		int index = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
 
-		data = decodeBytesGroupSimd(data, buffer + i, bitslog2);
+		data = decodeBytesGroupV1(data, buffer + i, kBitsV1[control][index]);
 	}
 
 	return data;
 }
 
-static const unsigned char* decodeVertexBlockSimd(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256])
+static const unsigned char* decodeVertexBlockV1(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[kVertexSizeMax])
 {
 	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
 
@@ -659,132 +793,2611 @@ static const unsigned char* decodeVertexBlockSimd(const unsigned char* data, con
 
 	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
 
-	for (size_t k = 0; k < vertex_size; k += 4)
+	size_t word_count = (vertex_size + 3) / 4;
+
+	if (size_t(data_end - data) < word_count * 2)
+		return 0;
+
+	const unsigned char* modes = data;
+	data += word_count * 2;
+
+	for (size_t k = 0; k < word_count; ++k)
 	{
-		for (size_t j = 0; j < 4; ++j)
+		size_t word_size = (k * 4 + 4 <= vertex_size) ? 4 : vertex_size - k * 4;
+
+		int mode = modes[k * 2 + 0] & 3;
+		int stride = ((modes[k * 2 + 0] >> 2) & 3) + 1;
+		int controls = modes[k * 2 + 1];
+
+		if ((modes[k * 2 + 0] & ~15) != 0 || (word_size < 4 && mode != kDeltaByte))
+			return 0;
+
+		for (int j = 0; j < 4; ++j)
 		{
-			data = decodeBytesSimd(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned);
+			if (j >= int(word_size))
+			{
+				memset(buffer + j * vertex_count_aligned, 0, vertex_count_aligned);
+				continue;
+			}
+
+			data = decodeBytesV1(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned, (controls >> (j * 2)) & 3);
 			if (!data)
 				return 0;
 		}
 
-#ifdef SIMD_SSE
-#define TEMP __m128i
-#define LOAD(i) __m128i r##i = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + i * vertex_count_aligned))
-#define GRP4(i) t0 = _mm_shuffle_epi32(r##i, 0), t1 = _mm_shuffle_epi32(r##i, 1), t2 = _mm_shuffle_epi32(r##i, 2), t3 = _mm_shuffle_epi32(r##i, 3)
-#define FIXD(i) t##i = pi = _mm_add_epi8(pi, t##i)
-#define SAVE(i) *reinterpret_cast<int*>(savep) = _mm_cvtsi128_si32(t##i), savep += vertex_size
-#endif
+		decodeDeltasV1(transposed + k * 4, buffer, vertex_count_aligned, vertex_count, vertex_size, word_size, readWordPartial(last_vertex + k * 4, word_size), mode, stride);
+	}
 
-#ifdef SIMD_NEON
-#define TEMP uint8x8_t
-#define LOAD(i) uint8x16_t r##i = vld1q_u8(buffer + j + i * vertex_count_aligned)
-#define GRP4(i) t0 = vget_low_u8(r##i), t1 = vreinterpret_u8_u32(vdup_lane_u32(vreinterpret_u32_u8(t0), 1)), t2 = vget_high_u8(r##i), t3 = vreinterpret_u8_u32(vdup_lane_u32(vreinterpret_u32_u8(t2), 1))
-#define FIXD(i) t##i = pi = vadd_u8(pi, t##i)
-#define SAVE(i) vst1_lane_u32(reinterpret_cast<uint32_t*>(savep), vreinterpret_u32_u8(t##i), 0), savep += vertex_size
+	memcpy(vertex_data, transposed, vertex_count * vertex_size);
+
+	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
 #endif
 
 #ifdef SIMD_SSE
-		__m128i pi = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(last_vertex + k));
-#endif
-#ifdef SIMD_NEON
-		uint8x8_t pi = vreinterpret_u8_u32(vld1_lane_u32(reinterpret_cast<uint32_t*>(last_vertex + k), vdup_n_u32(0), 0));
-#endif
+static unsigned char kEncodeBytesGroupShuffle[256][8];
+static unsigned char kEncodeBytesGroupCount[256];
 
-		unsigned char* savep = transposed + k;
+static bool encodeBytesGroupBuildTables()
+{
+	for (int mask = 0; mask < 256; ++mask)
+	{
+		unsigned char shuffle[8];
+		unsigned char count = 0;
 
-		for (size_t j = 0; j < vertex_count_aligned; j += 16)
-		{
-			LOAD(0);
-			LOAD(1);
-			LOAD(2);
-			LOAD(3);
+		// gather the bytes selected by mask to the front, filling the rest with zeroes
+		for (int i = 0; i < 8; ++i)
+			if ((mask >> i) & 1)
+				shuffle[count++] = (unsigned char)i;
 
-			r0 = unzigzag8(r0);
-			r1 = unzigzag8(r1);
-			r2 = unzigzag8(r2);
-			r3 = unzigzag8(r3);
+		for (int i = count; i < 8; ++i)
+			shuffle[i] = 0x80;
 
-			transpose8(r0, r1, r2, r3);
+		memcpy(kEncodeBytesGroupShuffle[mask], shuffle, 8);
+		kEncodeBytesGroupCount[mask] = count;
+	}
 
-			TEMP t0, t1, t2, t3;
+	return true;
+}
 
-			GRP4(0);
-			FIXD(0), FIXD(1), FIXD(2), FIXD(3);
-			SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+static bool gEncodeBytesGroupInitialized = encodeBytesGroupBuildTables();
 
-			GRP4(1);
-			FIXD(0), FIXD(1), FIXD(2), FIXD(3);
-			SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+static SIMD_TARGET_SSE int encodeSentinelMask(__m128i v, int bits)
+{
+	// values that don't fit into bits bits use a sentinel (all bits set) and are stored as full bytes after the group
+	__m128i over = _mm_subs_epu8(v, _mm_set1_epi8((char)((1 << bits) - 2)));
 
-			GRP4(2);
-			FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+	return ~_mm_movemask_epi8(_mm_cmpeq_epi8(over, _mm_setzero_si128())) & 0xffff;
+}
+
+static SIMD_TARGET_SSE unsigned char* encodeBytesGroupSimd(unsigned char* data, __m128i v, int bitslog2, int mask16)
+{
+#ifdef __GNUC__
+	typedef int __attribute__((aligned(1))) unaligned_int;
+#else
+	typedef int unaligned_int;
+#endif
+
+	switch (bitslog2)
+	{
+	case 0:
+		return data;
+
+	case 1:
+	{
+		__m128i enc = _mm_min_epu8(v, _mm_set1_epi8(3));
+
+		// 4 values per byte, first value in high bits
+		__m128i enc2 = _mm_maddubs_epi16(enc, _mm_set1_epi16(0x0104));
+		__m128i enc4 = _mm_madd_epi16(enc2, _mm_set1_epi32(0x00010010));
+		__m128i sel = _mm_packus_epi16(_mm_packs_epi32(enc4, enc4), _mm_setzero_si128());
+
+		*reinterpret_cast<unaligned_int*>(data) = _mm_cvtsi128_si32(sel);
+		data += 4;
+		break;
+	}
+
+	case 2:
+	{
+		__m128i enc = _mm_min_epu8(v, _mm_set1_epi8(15));
+
+		// 2 values per byte, first value in high bits
+		__m128i enc2 = _mm_maddubs_epi16(enc, _mm_set1_epi16(0x0110));
+		__m128i sel = _mm_packus_epi16(enc2, enc2);
+
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(data), sel);
+		data += 8;
+		break;
+	}
+
+	case 3:
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data), v);
+		return data + 16;
+
+	default:
+		assert(!"Unexpected bit length"); // This can never happen since bitslog2 is a 2-bit value
+		return data;
+	}
+
+	// out-of-range values are written in order; note that each half writes 8 bytes even if fewer bytes are selected, which is safe since callers guarantee kTailMaxSize bytes of space
+	unsigned char mask0 = (unsigned char)(mask16 & 255);
+	unsigned char mask1 = (unsigned char)(mask16 >> 8);
+
+	__m128i sm0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kEncodeBytesGroupShuffle[mask0]));
+	__m128i sm1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kEncodeBytesGroupShuffle[mask1]));
+
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(data), _mm_shuffle_epi8(v, sm0));
+	data += kEncodeBytesGroupCount[mask0];
+
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(data), _mm_shuffle_epi8(v, _mm_add_epi8(sm1, _mm_set1_epi8(8))));
+	data += kEncodeBytesGroupCount[mask1];
+
+	return data;
+}
+
+static SIMD_TARGET_SSE unsigned char* encodeBytesSimd(unsigned char* data, unsigned char* data_end, const unsigned char* buffer, size_t buffer_size, int level)
+{
+	assert(buffer_size % kByteGroupSize == 0);
+
+	unsigned char* header = data;
+
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+	if (size_t(data_end - data) < header_size)
+		return 0;
+
+	data += header_size;
+
+	memset(header, 0, header_size);
+
+	for (size_t i = 0; i < buffer_size; i += kByteGroupSize)
+	{
+		if (size_t(data_end - data) < kTailMaxSize)
+			return 0;
+
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + i));
+
+		int mask2 = encodeSentinelMask(v, 2);
+		int mask4 = encodeSentinelMask(v, 4);
+
+		size_t size2 = 4 + kEncodeBytesGroupCount[mask2 & 255] + kEncodeBytesGroupCount[mask2 >> 8];
+		size_t size4 = 8 + kEncodeBytesGroupCount[mask4 & 255] + kEncodeBytesGroupCount[mask4 >> 8];
+
+		// pick the smallest encoding, preferring fewer bits on ties to match encodeBytes
+		int bitslog2 = 3;
+		size_t best_size = kByteGroupSize;
+		int mask16 = 0;
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) == 0xffff)
+			bitslog2 = 0, best_size = 0;
+
+		if (level == 0)
+		{
+			// pick the smallest bit width that fits all values to match encodeBytes
+			if (bitslog2 != 0 && mask2 == 0)
+				bitslog2 = 1, best_size = size2;
+			else if (bitslog2 != 0 && mask4 == 0)
+				bitslog2 = 2, best_size = size4;
+		}
+		else
+		{
+			if (size2 < best_size)
+				bitslog2 = 1, best_size = size2, mask16 = mask2;
+
+			if (size4 < best_size)
+				bitslog2 = 2, best_size = size4, mask16 = mask4;
+		}
+
+		size_t header_offset = i / kByteGroupSize;
+
+		header[header_offset / 4] |= bitslog2 << ((header_offset % 4) * 2);
+
+		unsigned char* next = encodeBytesGroupSimd(data, v, bitslog2, mask16);
+
+		assert(data + best_size == next);
+		data = next;
+	}
+
+	return data;
+}
+
+static SIMD_TARGET_SSE __m128i zigzag8(__m128i v)
+{
+	__m128i xl = _mm_cmpgt_epi8(_mm_setzero_si128(), v);
+	__m128i xr = _mm_add_epi8(v, v);
+
+	return _mm_xor_si128(xl, xr);
+}
+
+static SIMD_TARGET_SSE unsigned char* encodeVertexBlockSimd(unsigned char* data, unsigned char* data_end, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[kVertexSizeMax], int level)
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+#ifdef __GNUC__
+	typedef int __attribute__((aligned(1))) unaligned_int;
+#else
+	typedef int unaligned_int;
+#endif
+
+	unsigned char buffer[kVertexBlockMaxSize * 4];
+
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+	// groups bytes of 4 vertices by channel: 4 bytes of channel 0, 4 bytes of channel 1, etc.
+	const __m128i channels = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+
+	for (size_t k = 0; k + 4 <= vertex_size; k += 4)
+	{
+		// previous channel values are kept in the first byte
+		__m128i p0 = _mm_cvtsi32_si128(last_vertex[k + 0]);
+		__m128i p1 = _mm_cvtsi32_si128(last_vertex[k + 1]);
+		__m128i p2 = _mm_cvtsi32_si128(last_vertex[k + 2]);
+		__m128i p3 = _mm_cvtsi32_si128(last_vertex[k + 3]);
+
+		for (size_t j = 0; j < vertex_count_aligned; j += 16)
+		{
+			// vertices past the end of the block repeat the last vertex, which results in zero deltas just like encodeVertexBlock
+#define LOAD(i) _mm_cvtsi32_si128(*reinterpret_cast<const unaligned_int*>(vertex_data + (j + i < vertex_count ? j + i : vertex_count - 1) * vertex_size + k))
+#define LOAD4(i) _mm_unpacklo_epi64(_mm_unpacklo_epi32(LOAD(i + 0), LOAD(i + 1)), _mm_unpacklo_epi32(LOAD(i + 2), LOAD(i + 3)))
+
+			__m128i r0 = _mm_shuffle_epi8(LOAD4(0), channels);
+			__m128i r1 = _mm_shuffle_epi8(LOAD4(4), channels);
+			__m128i r2 = _mm_shuffle_epi8(LOAD4(8), channels);
+			__m128i r3 = _mm_shuffle_epi8(LOAD4(12), channels);
+
+#undef LOAD4
+#undef LOAD
+
+			__m128i t0 = _mm_unpacklo_epi32(r0, r1);
+			__m128i t1 = _mm_unpackhi_epi32(r0, r1);
+			__m128i t2 = _mm_unpacklo_epi32(r2, r3);
+			__m128i t3 = _mm_unpackhi_epi32(r2, r3);
+
+			__m128i c0 = _mm_unpacklo_epi64(t0, t2);
+			__m128i c1 = _mm_unpackhi_epi64(t0, t2);
+			__m128i c2 = _mm_unpacklo_epi64(t1, t3);
+			__m128i c3 = _mm_unpackhi_epi64(t1, t3);
+
+#define SAVE(i) \
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + i * vertex_count_aligned + j), zigzag8(_mm_sub_epi8(c##i, _mm_or_si128(_mm_slli_si128(c##i, 1), p##i)))), \
+	    p##i = _mm_srli_si128(c##i, 15)
+
+			SAVE(0);
+			SAVE(1);
+			SAVE(2);
+			SAVE(3);
+
+#undef SAVE
+		}
+
+		for (size_t j = 0; j < 4; ++j)
+		{
+			data = encodeBytesSimd(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned, level);
+			if (!data)
+				return 0;
+		}
+	}
+
+	// remaining bytes of vertices that aren't a multiple of 4 bytes are encoded one byte stream at a time
+	for (size_t k = vertex_size & ~3; k < vertex_size; ++k)
+	{
+		memset(buffer, 0, vertex_count_aligned);
+		encodeDeltas1(buffer, vertex_data + k, vertex_count, vertex_size, last_vertex[k]);
+
+		data = encodeBytesSimd(data, data_end, buffer, vertex_count_aligned, level);
+		if (!data)
+			return 0;
+	}
+
+	memcpy(last_vertex, &vertex_data[vertex_size * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
+#endif
+
+#if defined(SIMD_FALLBACK) || (!defined(SIMD_SSE) && !defined(SIMD_NEON))
+static const unsigned char* decodeBytesGroup(const unsigned char* data, unsigned char* buffer, int bitslog2)
+{
+#define READ() byte = *data++
+#define NEXT(bits) enc = byte >> (8 - bits), byte <<= bits, encv = *data_var, *buffer++ = (enc == (1 << bits) - 1) ? encv : enc, data_var += (enc == (1 << bits) - 1)
+
+	unsigned char byte, enc, encv;
+	const unsigned char* data_var;
+
+	switch (bitslog2)
+	{
+	case 0:
+		memset(buffer, 0, kByteGroupSize);
+		return data;
+	case 1:
+		data_var = data + 4;
+
+		// 4 groups with 4 2-bit values in each byte
+		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
+		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
+		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
+		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
+
+		return data_var;
+	case 2:
+		data_var = data + 8;
+
+		// 8 groups with 2 4-bit values in each byte
+		READ(), NEXT(4), NEXT(4);
+		READ(), NEXT(4), NEXT(4);
+		READ(), NEXT(4), NEXT(4);
+		READ(), NEXT(4), NEXT(4);
+		READ(), NEXT(4), NEXT(4);
+		READ(), NEXT(4), NEXT(4);
+		READ(), NEXT(4), NEXT(4);
+		READ(), NEXT(4), NEXT(4);
+
+		return data_var;
+	case 3:
+		memcpy(buffer, data, kByteGroupSize);
+		return data + kByteGroupSize;
+	default:
+		assert(!"Unexpected bit length"); // This can never happen since bitslog2 is a 2-bit value
+		return data;
+	}
+
+#undef READ
+#undef NEXT
+}
+
+static const unsigned char* decodeBytes(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size)
+{
+	assert(buffer_size % kByteGroupSize == 0);
+
+	const unsigned char* header = data;
+
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+	if (size_t(data_end - data) < header_size)
+		return 0;
+
+	data += header_size;
+
+	for (size_t i = 0; i < buffer_size; i += kByteGroupSize)
+	{
+		if (size_t(data_end - data) < kTailMaxSize)
+			return 0;
+
+		size_t header_offset = i / kByteGroupSize;
+
+		int bitslog2 = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+
+		data = decodeBytesGroup(data, buffer + i, bitslog2);
+	}
+
+	return data;
+}
+
+static const unsigned char* decodeVertexBlock(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[kVertexSizeMax])
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+	unsigned char buffer[kVertexBlockMaxSize];
+	unsigned char transposed[kVertexBlockSizeBytes];
+
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+	for (size_t k = 0; k < vertex_size; ++k)
+	{
+		data = decodeBytes(data, data_end, buffer, vertex_count_aligned);
+		if (!data)
+			return 0;
+
+		decodeDeltas1(transposed + k, buffer, vertex_count, vertex_size, last_vertex[k]);
+	}
+
+	memcpy(vertex_data, transposed, vertex_count * vertex_size);
+
+	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
+#endif
+
+#if defined(SIMD_SSE) || defined(SIMD_NEON)
+static unsigned char kDecodeBytesGroupShuffle[256][8];
+static unsigned char kDecodeBytesGroupCount[256];
+
+#ifdef SIMD_SSE
+// byte shuffles for prefix sums over 4 vertex deltas with a given delta stride; the first two shift each delta to the next vertex with the same phase,
+// the last one selects the reference vertex for each element from the previous 4 vertices (0x80 yields zero, which is the identity for all delta modes)
+static unsigned char kDecodeStrideShuffle[kDeltaStrideMax][3][16];
+#endif
+
+static bool decodeBytesGroupBuildTables()
+{
+	for (int mask = 0; mask < 256; ++mask)
+	{
+		unsigned char shuffle[8];
+		unsigned char count = 0;
+
+		for (int i = 0; i < 8; ++i)
+		{
+			int maski = (mask >> i) & 1;
+			shuffle[i] = maski ? count : 0x80;
+			count += char(maski);
+		}
+
+		memcpy(kDecodeBytesGroupShuffle[mask], shuffle, 8);
+		kDecodeBytesGroupCount[mask] = count;
+	}
+
+#ifdef SIMD_SSE
+	for (int stride = 1; stride <= kDeltaStrideMax; ++stride)
+	{
+		for (int i = 0; i < 16; ++i)
+		{
+			int e = i / 4;
+
+			kDecodeStrideShuffle[stride - 1][0][i] = (unsigned char)(i >= stride * 4 ? i - stride * 4 : 0x80);
+			kDecodeStrideShuffle[stride - 1][1][i] = (unsigned char)(stride == 1 && i >= 8 ? i - 8 : 0x80);
+			kDecodeStrideShuffle[stride - 1][2][i] = (unsigned char)((4 - stride + e % stride) * 4 + i % 4);
+		}
+	}
+#endif
+
+	return true;
+}
+
+static bool gDecodeBytesGroupInitialized = decodeBytesGroupBuildTables();
+#endif
+
+#ifdef SIMD_SSE
+static SIMD_TARGET_SSE __m128i decodeShuffleMask(unsigned char mask0, unsigned char mask1)
+{
+	__m128i sm0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kDecodeBytesGroupShuffle[mask0]));
+	__m128i sm1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kDecodeBytesGroupShuffle[mask1]));
+	__m128i sm1off = _mm_set1_epi8(kDecodeBytesGroupCount[mask0]);
+
+	__m128i sm1r = _mm_add_epi8(sm1, sm1off);
+
+	return _mm_unpacklo_epi64(sm0, sm1r);
+}
+
+static SIMD_TARGET_SSE void transpose8(__m128i& x0, __m128i& x1, __m128i& x2, __m128i& x3)
+{
+	__m128i t0 = _mm_unpacklo_epi8(x0, x1);
+	__m128i t1 = _mm_unpackhi_epi8(x0, x1);
+	__m128i t2 = _mm_unpacklo_epi8(x2, x3);
+	__m128i t3 = _mm_unpackhi_epi8(x2, x3);
+
+	x0 = _mm_unpacklo_epi16(t0, t2);
+	x1 = _mm_unpackhi_epi16(t0, t2);
+	x2 = _mm_unpacklo_epi16(t1, t3);
+	x3 = _mm_unpackhi_epi16(t1, t3);
+}
+
+static SIMD_TARGET_SSE __m128i unzigzag8(__m128i v)
+{
+	__m128i xl = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi8(1)));
+	__m128i xr = _mm_and_si128(_mm_srli_epi16(v, 1), _mm_set1_epi8(127));
+
+	return _mm_xor_si128(xl, xr);
+}
+#endif
+
+#if defined(SIMD_SSE) && (defined(SIMD_AVX_FALLBACK) || !defined(SIMD_AVX))
+static SIMD_TARGET_SSE const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsigned char* buffer, int bitslog2)
+{
+	switch (bitslog2)
+	{
+	case 0:
+	{
+		__m128i result = _mm_setzero_si128();
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+		return data;
+	}
+
+	case 1:
+	{
+#ifdef __GNUC__
+		typedef int __attribute__((aligned(1))) unaligned_int;
+#else
+		typedef int unaligned_int;
+#endif
+
+		__m128i sel2 = _mm_cvtsi32_si128(*reinterpret_cast<const unaligned_int*>(data));
+		__m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4));
+
+		__m128i sel22 = _mm_unpacklo_epi8(_mm_srli_epi16(sel2, 4), sel2);
+		__m128i sel2222 = _mm_unpacklo_epi8(_mm_srli_epi16(sel22, 2), sel22);
+		__m128i sel = _mm_and_si128(sel2222, _mm_set1_epi8(3));
+
+		__m128i mask = _mm_cmpeq_epi8(sel, _mm_set1_epi8(3));
+		int mask16 = _mm_movemask_epi8(mask);
+		unsigned char mask0 = (unsigned char)(mask16 & 255);
+		unsigned char mask1 = (unsigned char)(mask16 >> 8);
+
+		__m128i shuf = decodeShuffleMask(mask0, mask1);
+
+		__m128i result = _mm_or_si128(_mm_shuffle_epi8(rest, shuf), _mm_andnot_si128(mask, sel));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+		return data + 4 + kDecodeBytesGroupCount[mask0] + kDecodeBytesGroupCount[mask1];
+	}
+
+	case 2:
+	{
+		__m128i sel4 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+		__m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 8));
+
+		__m128i sel44 = _mm_unpacklo_epi8(_mm_srli_epi16(sel4, 4), sel4);
+		__m128i sel = _mm_and_si128(sel44, _mm_set1_epi8(15));
+
+		__m128i mask = _mm_cmpeq_epi8(sel, _mm_set1_epi8(15));
+		int mask16 = _mm_movemask_epi8(mask);
+		unsigned char mask0 = (unsigned char)(mask16 & 255);
+		unsigned char mask1 = (unsigned char)(mask16 >> 8);
+
+		__m128i shuf = decodeShuffleMask(mask0, mask1);
+
+		__m128i result = _mm_or_si128(_mm_shuffle_epi8(rest, shuf), _mm_andnot_si128(mask, sel));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+		return data + 8 + kDecodeBytesGroupCount[mask0] + kDecodeBytesGroupCount[mask1];
+	}
+
+	case 3:
+	{
+		__m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+
+		__m128i result = rest;
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+		return data + 16;
+	}
+
+	default:
+		assert(!"Unexpected bit length"); // This can never happen since bitslog2 is a 2-bit value
+		return data;
+	}
+}
+#endif
+
+#ifdef SIMD_NEON
+static uint8x16_t shuffleBytes(unsigned char mask0, unsigned char mask1, uint8x8_t rest0, uint8x8_t rest1)
+{
+	uint8x8_t sm0 = vld1_u8(kDecodeBytesGroupShuffle[mask0]);
+	uint8x8_t sm1 = vld1_u8(kDecodeBytesGroupShuffle[mask1]);
+
+	uint8x8_t r0 = vtbl1_u8(rest0, sm0);
+	uint8x8_t r1 = vtbl1_u8(rest1, sm1);
+
+	return vcombine_u8(r0, r1);
+}
+
+static int neonMoveMask(uint8x16_t mask)
+{
+	static const uint8x16_t byte_mask = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+
+	uint8x16_t masked = vandq_u8(mask, byte_mask);
+
+	// we need horizontal sums of each half of masked
+	// the endianness of the platform determines the order of high/low in sum1 below
+	// we assume little endian here
+	uint8x8_t sum1 = vpadd_u8(vget_low_u8(masked), vget_high_u8(masked));
+	uint8x8_t sum2 = vpadd_u8(sum1, sum1);
+	uint8x8_t sum3 = vpadd_u8(sum2, sum2);
+
+	// note: here we treat 2b sum as a 16bit mask; this depends on endianness, see above
+	return vget_lane_u16(vreinterpret_u16_u8(sum3), 0);
+}
+
+static void transpose8(uint8x16_t& x0, uint8x16_t& x1, uint8x16_t& x2, uint8x16_t& x3)
+{
+	uint8x16x2_t t01 = vzipq_u8(x0, x1);
+	uint8x16x2_t t23 = vzipq_u8(x2, x3);
+
+	uint16x8x2_t x01 = vzipq_u16(vreinterpretq_u16_u8(t01.val[0]), vreinterpretq_u16_u8(t23.val[0]));
+	uint16x8x2_t x23 = vzipq_u16(vreinterpretq_u16_u8(t01.val[1]), vreinterpretq_u16_u8(t23.val[1]));
+
+	x0 = x01.val[0];
+	x1 = x01.val[1];
+	x2 = x23.val[0];
+	x3 = x23.val[1];
+}
+
+static uint8x16_t unzigzag8(uint8x16_t v)
+{
+	uint8x16_t xl = vreinterpretq_u8_s8(vnegq_s8(vreinterpretq_s8_u8(vandq_u8(v, vdupq_n_u8(1)))));
+	uint8x16_t xr = vshrq_n_u8(v, 1);
+
+	return veorq_u8(xl, xr);
+}
+
+static const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsigned char* buffer, int bitslog2)
+{
+	switch (bitslog2)
+	{
+	case 0:
+	{
+		uint8x16_t result = vdupq_n_u8(0);
+
+		vst1q_u8(buffer, result);
+
+		return data;
+	}
+
+	case 1:
+	{
+		uint8x8_t sel2 = vld1_u8(data);
+		uint8x8_t sel22 = vzip_u8(vshr_n_u8(sel2, 4), sel2).val[0];
+		uint8x8x2_t sel2222 = vzip_u8(vshr_n_u8(sel22, 2), sel22);
+		uint8x16_t sel = vandq_u8(vcombine_u8(sel2222.val[0], sel2222.val[1]), vdupq_n_u8(3));
+
+		uint8x16_t mask = vceqq_u8(sel, vdupq_n_u8(3));
+		int mask16 = neonMoveMask(mask);
+		unsigned char mask0 = (unsigned char)(mask16 & 255);
+		unsigned char mask1 = (unsigned char)(mask16 >> 8);
+
+		uint8x8_t rest0 = vld1_u8(data + 4);
+		uint8x8_t rest1 = vld1_u8(data + 4 + kDecodeBytesGroupCount[mask0]);
+
+		uint8x16_t result = vbslq_u8(mask, shuffleBytes(mask0, mask1, rest0, rest1), sel);
+
+		vst1q_u8(buffer, result);
+
+		return data + 4 + kDecodeBytesGroupCount[mask0] + kDecodeBytesGroupCount[mask1];
+	}
+
+	case 2:
+	{
+		uint8x8_t sel4 = vld1_u8(data);
+		uint8x8x2_t sel44 = vzip_u8(vshr_n_u8(sel4, 4), vand_u8(sel4, vdup_n_u8(15)));
+		uint8x16_t sel = vcombine_u8(sel44.val[0], sel44.val[1]);
+
+		uint8x16_t mask = vceqq_u8(sel, vdupq_n_u8(15));
+		int mask16 = neonMoveMask(mask);
+		unsigned char mask0 = (unsigned char)(mask16 & 255);
+		unsigned char mask1 = (unsigned char)(mask16 >> 8);
+
+		uint8x8_t rest0 = vld1_u8(data + 8);
+		uint8x8_t rest1 = vld1_u8(data + 8 + kDecodeBytesGroupCount[mask0]);
+
+		uint8x16_t result = vbslq_u8(mask, shuffleBytes(mask0, mask1, rest0, rest1), sel);
+
+		vst1q_u8(buffer, result);
+
+		return data + 8 + kDecodeBytesGroupCount[mask0] + kDecodeBytesGroupCount[mask1];
+	}
+
+	case 3:
+	{
+		uint8x16_t rest = vld1q_u8(data);
+
+		uint8x16_t result = rest;
+
+		vst1q_u8(buffer, result);
+
+		return data + 16;
+	}
+
+	default:
+		assert(!"Unexpected bit length"); // This can never happen since bitslog2 is a 2-bit value
+		return data;
+	}
+}
+#endif
+
+#if (defined(SIMD_SSE) && (defined(SIMD_AVX_FALLBACK) || !defined(SIMD_AVX))) || defined(SIMD_NEON)
+static SIMD_TARGET_SSE const unsigned char* decodeBytesSimd(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size)
+{
+	assert(buffer_size % kByteGroupSize == 0);
+	assert(kByteGroupSize == 16);
+
+	const unsigned char* header = data;
+
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+	if (size_t(data_end - data) < header_size)
+		return 0;
+
+	data += header_size;
+
+	size_t i = 0;
+
+	// fast-path: process 4 groups at a time, do a shared bounds check - each group reads <=32b
+	for (; i + kByteGroupSize * 4 <= buffer_size && size_t(data_end - data) >= kTailMaxSize * 4; i += kByteGroupSize * 4)
+	{
+		size_t header_offset = i / kByteGroupSize;
+		unsigned char header_byte = header[header_offset / 4];
+
+		data = decodeBytesGroupSimd(data, buffer + i + kByteGroupSize * 0, (header_byte >> 0) & 3);
+		data = decodeBytesGroupSimd(data, buffer + i + kByteGroupSize * 1, (header_byte >> 2) & 3);
+		data = decodeBytesGroupSimd(data, buffer + i + kByteGroupSize * 2, (header_byte >> 4) & 3);
+		data = decodeBytesGroupSimd(data, buffer + i + kByteGroupSize * 3, (header_byte >> 6) & 3);
+	}
+
+	// slow-path: process remaining groups
+	for (; i < buffer_size; i += kByteGroupSize)
+	{
+		if (size_t(data_end - data) < kTailMaxSize)
+			return 0;
+
+		size_t header_offset = i / kByteGroupSize;
+
+		int bitslog2 = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+
+		data = decodeBytesGroupSimd(data, buffer + i, bitslog2);
+	}
+
+	return data;
+}
+
+static SIMD_TARGET_SSE const unsigned char* decodeVertexBlockSimd(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[kVertexSizeMax])
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+#if defined(SIMD_SSE) && defined(__GNUC__)
+	typedef int __attribute__((aligned(1))) unaligned_int;
+#elif defined(SIMD_SSE)
+	typedef int unaligned_int;
+#endif
+
+	unsigned char buffer[kVertexBlockMaxSize * 4];
+	unsigned char transposed[kVertexBlockSizeBytes];
+
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+	for (size_t k = 0; k + 4 <= vertex_size; k += 4)
+	{
+		for (size_t j = 0; j < 4; ++j)
+		{
+			data = decodeBytesSimd(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned);
+			if (!data)
+				return 0;
+		}
+
+#ifdef SIMD_SSE
+#define TEMP __m128i
+#define LOAD(i) __m128i r##i = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + i * vertex_count_aligned))
+#define GRP4(i) t0 = _mm_shuffle_epi32(r##i, 0), t1 = _mm_shuffle_epi32(r##i, 1), t2 = _mm_shuffle_epi32(r##i, 2), t3 = _mm_shuffle_epi32(r##i, 3)
+#define FIXD(i) t##i = pi = _mm_add_epi8(pi, t##i)
+#define SAVE(i) *reinterpret_cast<unaligned_int*>(savep) = _mm_cvtsi128_si32(t##i), savep += vertex_size
+#endif
+
+#ifdef SIMD_NEON
+#define TEMP uint8x8_t
+#define LOAD(i) uint8x16_t r##i = vld1q_u8(buffer + j + i * vertex_count_aligned)
+#define GRP4(i) t0 = vget_low_u8(r##i), t1 = vreinterpret_u8_u32(vdup_lane_u32(vreinterpret_u32_u8(t0), 1)), t2 = vget_high_u8(r##i), t3 = vreinterpret_u8_u32(vdup_lane_u32(vreinterpret_u32_u8(t2), 1))
+#define FIXD(i) t##i = pi = vadd_u8(pi, t##i)
+#define SAVE(i) vst1_lane_u32(reinterpret_cast<uint32_t*>(savep), vreinterpret_u32_u8(t##i), 0), savep += vertex_size
+#endif
+
+#ifdef SIMD_SSE
+		__m128i pi = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(last_vertex + k));
+#endif
+#ifdef SIMD_NEON
+		uint8x8_t pi = vreinterpret_u8_u32(vld1_lane_u32(reinterpret_cast<uint32_t*>(last_vertex + k), vdup_n_u32(0), 0));
+#endif
+
+		unsigned char* savep = transposed + k;
+
+		for (size_t j = 0; j < vertex_count_aligned; j += 16)
+		{
+			LOAD(0);
+			LOAD(1);
+			LOAD(2);
+			LOAD(3);
+
+			r0 = unzigzag8(r0);
+			r1 = unzigzag8(r1);
+			r2 = unzigzag8(r2);
+			r3 = unzigzag8(r3);
+
+			transpose8(r0, r1, r2, r3);
+
+			TEMP t0, t1, t2, t3;
+
+			GRP4(0);
+			FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+			SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+
+			GRP4(1);
+			FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+			SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+
+			GRP4(2);
+			FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+			SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+
+			GRP4(3);
+			FIXD(0), FIXD(1), FIXD(2), FIXD(3);
 			SAVE(0), SAVE(1), SAVE(2), SAVE(3);
 
-			GRP4(3);
-			FIXD(0), FIXD(1), FIXD(2), FIXD(3);
-			SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+#undef TEMP
+#undef LOAD
+#undef GRP4
+#undef FIXD
+#undef SAVE
+		}
+	}
+
+	// remaining bytes of vertices that aren't a multiple of 4 bytes are decoded one byte stream at a time
+	for (size_t k = vertex_size & ~3; k < vertex_size; ++k)
+	{
+		data = decodeBytesSimd(data, data_end, buffer, vertex_count_aligned);
+		if (!data)
+			return 0;
+
+		decodeDeltas1(transposed + k, buffer, vertex_count, vertex_size, last_vertex[k]);
+	}
+
+	memcpy(vertex_data, transposed, vertex_count * vertex_size);
+
+	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
+#endif
+
+#if defined(SIMD_SSE) && (defined(SIMD_AVX_FALLBACK) || !defined(SIMD_AVX))
+static SIMD_TARGET_SSE __m128i decodeBitsV1(const unsigned char* data, int bits)
+{
+#ifdef __GNUC__
+	typedef int __attribute__((aligned(1))) unaligned_int;
+#else
+	typedef int unaligned_int;
+#endif
+
+	if (bits == 1)
+	{
+		// every set bit is a sentinel, so we only need to turn bits into 0/1 bytes; first value is in the high bit
+		__m128i sel1 = _mm_shuffle_epi8(_mm_cvtsi32_si128(data[0] | (data[1] << 8)), _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1));
+		__m128i bit = _mm_setr_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+
+		return _mm_min_epu8(_mm_and_si128(sel1, bit), _mm_set1_epi8(1));
+	}
+	else if (bits == 2)
+	{
+		__m128i sel2 = _mm_cvtsi32_si128(*reinterpret_cast<const unaligned_int*>(data));
+		__m128i sel22 = _mm_unpacklo_epi8(_mm_srli_epi16(sel2, 4), sel2);
+		__m128i sel2222 = _mm_unpacklo_epi8(_mm_srli_epi16(sel22, 2), sel22);
+
+		return _mm_and_si128(sel2222, _mm_set1_epi8(3));
+	}
+	else if (bits == 4)
+	{
+		__m128i sel4 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+		__m128i sel44 = _mm_unpacklo_epi8(_mm_srli_epi16(sel4, 4), sel4);
+
+		return _mm_and_si128(sel44, _mm_set1_epi8(15));
+	}
+	else
+	{
+		assert(bits == 6);
+
+		// each 3 bytes hold 4 values; 16-bit multiplies move each value into its own byte, similarly to SIMD base64 encoders
+		__m128i sel6 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+		__m128i sel02 = _mm_mulhi_epu16(_mm_and_si128(sel6, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+		__m128i sel13 = _mm_mullo_epi16(_mm_and_si128(sel6, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+
+		return _mm_or_si128(sel02, sel13);
+	}
+}
+
+template <int Mode>
+static SIMD_TARGET_SSE __m128i unzigzagV1(__m128i v)
+{
+	if (Mode == kDeltaByte)
+		return unzigzag8(v);
+	else if (Mode == kDeltaShort)
+		return _mm_xor_si128(_mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi16(1))), _mm_srli_epi16(v, 1));
+	else if (Mode == kDeltaWord)
+		return _mm_xor_si128(_mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi32(1))), _mm_srli_epi32(v, 1));
+	else
+		return v;
+}
+
+template <int Mode>
+static SIMD_TARGET_SSE __m128i addDeltaV1(__m128i v, __m128i d)
+{
+	if (Mode == kDeltaByte)
+		return _mm_add_epi8(v, d);
+	else if (Mode == kDeltaShort)
+		return _mm_add_epi16(v, d);
+	else if (Mode == kDeltaWord)
+		return _mm_add_epi32(v, d);
+	else
+		return _mm_xor_si128(v, d);
+}
+
+template <int Mode>
+static SIMD_TARGET_SSE __m128i prefixSumV1(__m128i v, __m128i shuf0, __m128i shuf1)
+{
+	// each 32-bit element is a vertex delta; after this each element holds the combination of all deltas of the same phase up to and including it
+	v = addDeltaV1<Mode>(v, _mm_shuffle_epi8(v, shuf0));
+	v = addDeltaV1<Mode>(v, _mm_shuffle_epi8(v, shuf1));
+
+	return v;
+}
+
+static SIMD_TARGET_SSE const unsigned char* decodeBytesGroupV1Simd(const unsigned char* data, unsigned char* buffer, int bits)
+{
+	if (bits == 0)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), _mm_setzero_si128());
+		return data;
+	}
+
+	if (bits == 8)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+		return data + 16;
+	}
+
+	// fixed portion takes 2 bytes for each bit of width, followed by a full byte for each sentinel value
+	int header_size = bits * 2;
+
+	__m128i sel = decodeBitsV1(data, bits);
+	__m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + header_size));
+
+	__m128i mask = _mm_cmpeq_epi8(sel, _mm_set1_epi8(char((1 << bits) - 1)));
+	int mask16 = _mm_movemask_epi8(mask);
+	unsigned char mask0 = (unsigned char)(mask16 & 255);
+	unsigned char mask1 = (unsigned char)(mask16 >> 8);
+
+	__m128i shuf = decodeShuffleMask(mask0, mask1);
+
+	__m128i result = _mm_or_si128(_mm_shuffle_epi8(rest, shuf), _mm_andnot_si128(mask, sel));
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+	return data + header_size + kDecodeBytesGroupCount[mask0] + kDecodeBytesGroupCount[mask1];
+}
+
+template <int Mode>
+static SIMD_TARGET_SSE void decodeDeltasV1Simd(unsigned char* vertex_data, const unsigned char* buffer, size_t vertex_count_aligned, size_t vertex_size, const unsigned char* last_word, int stride)
+{
+#ifdef __GNUC__
+	typedef int __attribute__((aligned(1))) unaligned_int;
+#else
+	typedef int unaligned_int;
+#endif
+
+	__m128i pi = _mm_set1_epi32(int(readWord(last_word)));
+
+	__m128i shuf0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kDecodeStrideShuffle[stride - 1][0]));
+	__m128i shuf1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kDecodeStrideShuffle[stride - 1][1]));
+	__m128i shufp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kDecodeStrideShuffle[stride - 1][2]));
+
+	unsigned char* savep = vertex_data;
+
+	for (size_t j = 0; j < vertex_count_aligned; j += 16)
+	{
+		__m128i r[4];
+
+		r[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 0 * vertex_count_aligned));
+		r[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 1 * vertex_count_aligned));
+		r[2] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 2 * vertex_count_aligned));
+		r[3] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 3 * vertex_count_aligned));
+
+		transpose8(r[0], r[1], r[2], r[3]);
+
+		for (int i = 0; i < 4; ++i)
+		{
+			// pi holds the last 4 decoded vertices
+			__m128i v = addDeltaV1<Mode>(prefixSumV1<Mode>(unzigzagV1<Mode>(r[i]), shuf0, shuf1), _mm_shuffle_epi8(pi, shufp));
+			pi = v;
+
+			*reinterpret_cast<unaligned_int*>(savep) = _mm_cvtsi128_si32(v), savep += vertex_size;
+			*reinterpret_cast<unaligned_int*>(savep) = _mm_cvtsi128_si32(_mm_shuffle_epi32(v, 1)), savep += vertex_size;
+			*reinterpret_cast<unaligned_int*>(savep) = _mm_cvtsi128_si32(_mm_shuffle_epi32(v, 2)), savep += vertex_size;
+			*reinterpret_cast<unaligned_int*>(savep) = _mm_cvtsi128_si32(_mm_shuffle_epi32(v, 3)), savep += vertex_size;
+		}
+	}
+}
+#endif
+
+#if defined(SIMD_SSE) && (defined(SIMD_AVX_FALLBACK) || !defined(SIMD_AVX))
+static SIMD_TARGET_SSE const unsigned char* decodeBytesV1Simd(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size, int control)
+{
+	assert(buffer_size % kByteGroupSize == 0);
+	assert(kByteGroupSize == 16);
+
+	if (control > 2)
+		return 0;
+
+	const int* bits = kBitsV1[control];
+
+	const unsigned char* header = data;
+
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+	if (size_t(data_end - data) < header_size)
+		return 0;
+
+	data += header_size;
+
+	size_t i = 0;
+
+	// fast-path: process 4 groups at a time, do a shared bounds check - each group reads <=32b
+	for (; i + kByteGroupSize * 4 <= buffer_size && size_t(data_end - data) >= kTailMaxSize * 4; i += kByteGroupSize * 4)
+	{
+		size_t header_offset = i / kByteGroupSize;
+		unsigned char header_byte = header[header_offset / 4];
+
+		data = decodeBytesGroupV1Simd(data, buffer + i + kByteGroupSize * 0, bits[(header_byte >> 0) & 3]);
+		data = decodeBytesGroupV1Simd(data, buffer + i + kByteGroupSize * 1, bits[(header_byte >> 2) & 3]);
+		data = decodeBytesGroupV1Simd(data, buffer + i + kByteGroupSize * 2, bits[(header_byte >> 4) & 3]);
+		data = decodeBytesGroupV1Simd(data, buffer + i + kByteGroupSize * 3, bits[(header_byte >> 6) & 3]);
+	}
+
+	// slow-path: process remaining groups
+	for (; i < buffer_size; i += kByteGroupSize)
+	{
+		if (size_t(data_end - data) < kTailMaxSize)
+			return 0;
+
+		size_t header_offset = i / kByteGroupSize;
+
+		int index = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+
+		data = decodeBytesGroupV1Simd(data, buffer + i, bits[index]);
+	}
+
+	return data;
+}
+
+static SIMD_TARGET_SSE const unsigned char* decodeVertexBlockV1Simd(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[kVertexSizeMax])
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+	unsigned char buffer[kVertexBlockMaxSize * 4];
+	unsigned char transposed[kVertexBlockSizeBytes];
+
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+	size_t word_count = (vertex_size + 3) / 4;
+
+	if (size_t(data_end - data) < word_count * 2)
+		return 0;
+
+	const unsigned char* modes = data;
+	data += word_count * 2;
+
+	for (size_t k = 0; k < word_count; ++k)
+	{
+		size_t word_size = (k * 4 + 4 <= vertex_size) ? 4 : vertex_size - k * 4;
+
+		int mode = modes[k * 2 + 0] & 3;
+		int stride = ((modes[k * 2 + 0] >> 2) & 3) + 1;
+		int controls = modes[k * 2 + 1];
+
+		if ((modes[k * 2 + 0] & ~15) != 0 || (word_size < 4 && mode != kDeltaByte))
+			return 0;
+
+		for (int j = 0; j < 4; ++j)
+		{
+			if (j >= int(word_size))
+			{
+				memset(buffer + j * vertex_count_aligned, 0, vertex_count_aligned);
+				continue;
+			}
+
+			data = decodeBytesV1Simd(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned, (controls >> (j * 2)) & 3);
+			if (!data)
+				return 0;
+		}
+
+		// full words are decoded 16 vertices at a time, which may write garbage past vertex_count; transposed has room for that
+		if (word_size < 4)
+			decodeDeltasV1(transposed + k * 4, buffer, vertex_count_aligned, vertex_count, vertex_size, word_size, readWordPartial(last_vertex + k * 4, word_size), mode, stride);
+		else if (mode == kDeltaByte)
+			decodeDeltasV1Simd<kDeltaByte>(transposed + k * 4, buffer, vertex_count_aligned, vertex_size, last_vertex + k * 4, stride);
+		else if (mode == kDeltaShort)
+			decodeDeltasV1Simd<kDeltaShort>(transposed + k * 4, buffer, vertex_count_aligned, vertex_size, last_vertex + k * 4, stride);
+		else if (mode == kDeltaWord)
+			decodeDeltasV1Simd<kDeltaWord>(transposed + k * 4, buffer, vertex_count_aligned, vertex_size, last_vertex + k * 4, stride);
+		else
+			decodeDeltasV1Simd<kDeltaXor>(transposed + k * 4, buffer, vertex_count_aligned, vertex_size, last_vertex + k * 4, stride);
+	}
+
+	memcpy(vertex_data, transposed, vertex_count * vertex_size);
+
+	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
+#endif
+
+#ifdef SIMD_AVX
+static SIMD_TARGET_AVX int popcount16(int mask16)
+{
+#ifdef _MSC_VER
+	return __popcnt(mask16);
+#else
+	return __builtin_popcount(mask16);
+#endif
+}
+
+static SIMD_TARGET_AVX const unsigned char* decodeBytesGroupAvx(const unsigned char* data, unsigned char* buffer, int bitslog2)
+{
+#ifdef __GNUC__
+	typedef int __attribute__((aligned(1))) unaligned_int;
+#else
+	typedef int unaligned_int;
+#endif
+
+	__m128i sel, rest, sentinel;
+	int header_size;
+
+	switch (bitslog2)
+	{
+	case 0:
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), _mm_setzero_si128());
+		return data;
+
+	case 1:
+	{
+		__m128i sel2 = _mm_cvtsi32_si128(*reinterpret_cast<const unaligned_int*>(data));
+		__m128i sel22 = _mm_unpacklo_epi8(_mm_srli_epi16(sel2, 4), sel2);
+		__m128i sel2222 = _mm_unpacklo_epi8(_mm_srli_epi16(sel22, 2), sel22);
+
+		sentinel = _mm_set1_epi8(3);
+		sel = _mm_and_si128(sel2222, sentinel);
+		rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4));
+		header_size = 4;
+		break;
+	}
+
+	case 2:
+	{
+		__m128i sel4 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+		__m128i sel44 = _mm_unpacklo_epi8(_mm_srli_epi16(sel4, 4), sel4);
+
+		sentinel = _mm_set1_epi8(15);
+		sel = _mm_and_si128(sel44, sentinel);
+		rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 8));
+		header_size = 8;
+		break;
+	}
+
+	case 3:
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+		return data + 16;
+
+	default:
+		assert(!"Unexpected bit length"); // This can never happen since bitslog2 is a 2-bit value
+		return data;
+	}
+
+	__m128i mask = _mm_cmpeq_epi8(sel, sentinel);
+	int mask16 = _mm_movemask_epi8(mask);
+	unsigned char mask0 = (unsigned char)(mask16 & 255);
+	unsigned char mask1 = (unsigned char)(mask16 >> 8);
+
+	__m128i shuf = decodeShuffleMask(mask0, mask1);
+
+	__m128i result = _mm_or_si128(_mm_shuffle_epi8(rest, shuf), _mm_andnot_si128(mask, sel));
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+	// popcnt is shorter on the critical path than two table lookups, which matters since each group's data offset depends on the previous group
+	return data + header_size + popcount16(mask16);
+}
+
+static SIMD_TARGET_AVX const unsigned char* decodeBytesAvx(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size)
+{
+	assert(buffer_size % kByteGroupSize == 0);
+	assert(kByteGroupSize == 16);
+
+	const unsigned char* header = data;
+
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+	if (size_t(data_end - data) < header_size)
+		return 0;
+
+	data += header_size;
+
+	size_t i = 0;
+
+	// fast-path: process 4 groups at a time, do a shared bounds check - each group reads <=32b
+	for (; i + kByteGroupSize * 4 <= buffer_size && size_t(data_end - data) >= kTailMaxSize * 4; i += kByteGroupSize * 4)
+	{
+		size_t header_offset = i / kByteGroupSize;
+		unsigned char header_byte = header[header_offset / 4];
+
+		data = decodeBytesGroupAvx(data, buffer + i + kByteGroupSize * 0, (header_byte >> 0) & 3);
+		data = decodeBytesGroupAvx(data, buffer + i + kByteGroupSize * 1, (header_byte >> 2) & 3);
+		data = decodeBytesGroupAvx(data, buffer + i + kByteGroupSize * 2, (header_byte >> 4) & 3);
+		data = decodeBytesGroupAvx(data, buffer + i + kByteGroupSize * 3, (header_byte >> 6) & 3);
+	}
+
+	// slow-path: process remaining groups
+	for (; i < buffer_size; i += kByteGroupSize)
+	{
+		if (size_t(data_end - data) < kTailMaxSize)
+			return 0;
+
+		size_t header_offset = i / kByteGroupSize;
+
+		int bitslog2 = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+
+		data = decodeBytesGroupAvx(data, buffer + i, bitslog2);
+	}
+
+	return data;
+}
+
+static SIMD_TARGET_AVX void transpose8(__m256i& x0, __m256i& x1, __m256i& x2, __m256i& x3)
+{
+	__m256i t0 = _mm256_unpacklo_epi8(x0, x1);
+	__m256i t1 = _mm256_unpackhi_epi8(x0, x1);
+	__m256i t2 = _mm256_unpacklo_epi8(x2, x3);
+	__m256i t3 = _mm256_unpackhi_epi8(x2, x3);
+
+	x0 = _mm256_unpacklo_epi16(t0, t2);
+	x1 = _mm256_unpackhi_epi16(t0, t2);
+	x2 = _mm256_unpacklo_epi16(t1, t3);
+	x3 = _mm256_unpackhi_epi16(t1, t3);
+}
+
+static SIMD_TARGET_AVX __m256i unzigzag8(__m256i v)
+{
+	__m256i xl = _mm256_sub_epi8(_mm256_setzero_si256(), _mm256_and_si256(v, _mm256_set1_epi8(1)));
+	__m256i xr = _mm256_and_si256(_mm256_srli_epi16(v, 1), _mm256_set1_epi8(127));
+
+	return _mm256_xor_si256(xl, xr);
+}
+
+static SIMD_TARGET_AVX __m256i prefixSum4(__m256i v)
+{
+	// each 32-bit element is a vertex delta; after this each element holds the sum of all deltas up to and including it within a 128-bit lane
+	v = _mm256_add_epi8(v, _mm256_slli_si256(v, 4));
+	v = _mm256_add_epi8(v, _mm256_slli_si256(v, 8));
+
+	return v;
+}
+
+static SIMD_TARGET_AVX __m128i prefixSum4(__m128i v)
+{
+	v = _mm_add_epi8(v, _mm_slli_si128(v, 4));
+	v = _mm_add_epi8(v, _mm_slli_si128(v, 8));
+
+	return v;
+}
+
+static SIMD_TARGET_AVX void saveVertices4(__m128i v, __m128i& pi, unsigned char*& savep, size_t vertex_size)
+{
+#ifdef __GNUC__
+	typedef int __attribute__((aligned(1))) unaligned_int;
+#else
+	typedef int unaligned_int;
+#endif
+
+	// pi holds the last decoded vertex in the top 32-bit element
+	v = _mm_add_epi8(v, _mm_shuffle_epi32(pi, 0xff));
+	pi = v;
+
+	*reinterpret_cast<unaligned_int*>(savep) = _mm_cvtsi128_si32(v), savep += vertex_size;
+	*reinterpret_cast<unaligned_int*>(savep) = _mm_extract_epi32(v, 1), savep += vertex_size;
+	*reinterpret_cast<unaligned_int*>(savep) = _mm_extract_epi32(v, 2), savep += vertex_size;
+	*reinterpret_cast<unaligned_int*>(savep) = _mm_extract_epi32(v, 3), savep += vertex_size;
+}
+
+static SIMD_TARGET_AVX const unsigned char* decodeVertexBlockAvx(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[kVertexSizeMax])
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+	unsigned char buffer[kVertexBlockMaxSize * 4];
+	unsigned char transposed[kVertexBlockSizeBytes];
+
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+	for (size_t k = 0; k + 4 <= vertex_size; k += 4)
+	{
+		for (size_t j = 0; j < 4; ++j)
+		{
+			data = decodeBytesAvx(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned);
+			if (!data)
+				return 0;
+		}
+
+		__m128i pi = _mm_set1_epi32(*reinterpret_cast<const int*>(last_vertex + k));
+
+		unsigned char* savep = transposed + k;
+
+		size_t j = 0;
+
+		// fast-path: process 32 vertices at a time; low 128-bit lanes hold the first 16 vertices, high lanes hold the next 16
+		for (; j + 32 <= vertex_count_aligned; j += 32)
+		{
+			__m256i r0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + j + 0 * vertex_count_aligned));
+			__m256i r1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + j + 1 * vertex_count_aligned));
+			__m256i r2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + j + 2 * vertex_count_aligned));
+			__m256i r3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + j + 3 * vertex_count_aligned));
+
+			r0 = unzigzag8(r0);
+			r1 = unzigzag8(r1);
+			r2 = unzigzag8(r2);
+			r3 = unzigzag8(r3);
+
+			transpose8(r0, r1, r2, r3);
+
+			r0 = prefixSum4(r0);
+			r1 = prefixSum4(r1);
+			r2 = prefixSum4(r2);
+			r3 = prefixSum4(r3);
+
+			saveVertices4(_mm256_castsi256_si128(r0), pi, savep, vertex_size);
+			saveVertices4(_mm256_castsi256_si128(r1), pi, savep, vertex_size);
+			saveVertices4(_mm256_castsi256_si128(r2), pi, savep, vertex_size);
+			saveVertices4(_mm256_castsi256_si128(r3), pi, savep, vertex_size);
+
+			saveVertices4(_mm256_extracti128_si256(r0, 1), pi, savep, vertex_size);
+			saveVertices4(_mm256_extracti128_si256(r1, 1), pi, savep, vertex_size);
+			saveVertices4(_mm256_extracti128_si256(r2, 1), pi, savep, vertex_size);
+			saveVertices4(_mm256_extracti128_si256(r3, 1), pi, savep, vertex_size);
+		}
+
+		// slow-path: process remaining 16 vertices
+		if (j < vertex_count_aligned)
+		{
+			__m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 0 * vertex_count_aligned));
+			__m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 1 * vertex_count_aligned));
+			__m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 2 * vertex_count_aligned));
+			__m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 3 * vertex_count_aligned));
+
+			r0 = unzigzag8(r0);
+			r1 = unzigzag8(r1);
+			r2 = unzigzag8(r2);
+			r3 = unzigzag8(r3);
+
+			transpose8(r0, r1, r2, r3);
+
+			saveVertices4(prefixSum4(r0), pi, savep, vertex_size);
+			saveVertices4(prefixSum4(r1), pi, savep, vertex_size);
+			saveVertices4(prefixSum4(r2), pi, savep, vertex_size);
+			saveVertices4(prefixSum4(r3), pi, savep, vertex_size);
+		}
+	}
+
+	// remaining bytes of vertices that aren't a multiple of 4 bytes are decoded one byte stream at a time
+	for (size_t k = vertex_size & ~3; k < vertex_size; ++k)
+	{
+		data = decodeBytesAvx(data, data_end, buffer, vertex_count_aligned);
+		if (!data)
+			return 0;
+
+		decodeDeltas1(transposed + k, buffer, vertex_count, vertex_size, last_vertex[k]);
+	}
+
+	memcpy(vertex_data, transposed, vertex_count * vertex_size);
+
+	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
+
+static SIMD_TARGET_AVX const unsigned char* decodeBytesGroupV1Avx(const unsigned char* data, unsigned char* buffer, int bits)
+{
+	if (bits == 0)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), _mm_setzero_si128());
+		return data;
+	}
+
+	if (bits == 8)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+		return data + 16;
+	}
+
+#ifdef __GNUC__
+	typedef int __attribute__((aligned(1))) unaligned_int;
+#else
+	typedef int unaligned_int;
+#endif
+
+	__m128i sel;
+
+	if (bits == 1)
+	{
+		__m128i sel1 = _mm_shuffle_epi8(_mm_cvtsi32_si128(data[0] | (data[1] << 8)), _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1));
+		__m128i bit = _mm_setr_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+
+		sel = _mm_min_epu8(_mm_and_si128(sel1, bit), _mm_set1_epi8(1));
+	}
+	else if (bits == 2)
+	{
+		__m128i sel2 = _mm_cvtsi32_si128(*reinterpret_cast<const unaligned_int*>(data));
+		__m128i sel22 = _mm_unpacklo_epi8(_mm_srli_epi16(sel2, 4), sel2);
+		__m128i sel2222 = _mm_unpacklo_epi8(_mm_srli_epi16(sel22, 2), sel22);
+
+		sel = _mm_and_si128(sel2222, _mm_set1_epi8(3));
+	}
+	else if (bits == 4)
+	{
+		__m128i sel4 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+		__m128i sel44 = _mm_unpacklo_epi8(_mm_srli_epi16(sel4, 4), sel4);
+
+		sel = _mm_and_si128(sel44, _mm_set1_epi8(15));
+	}
+	else
+	{
+		// each 3 bytes hold 4 values; 16-bit multiplies move each value into its own byte, similarly to SIMD base64 encoders
+		__m128i sel6 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+		__m128i sel02 = _mm_mulhi_epu16(_mm_and_si128(sel6, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+		__m128i sel13 = _mm_mullo_epi16(_mm_and_si128(sel6, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+
+		sel = _mm_or_si128(sel02, sel13);
+	}
+
+	// fixed portion takes 2 bytes for each bit of width, followed by a full byte for each sentinel value
+	int header_size = bits * 2;
+
+	__m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + header_size));
+
+	__m128i mask = _mm_cmpeq_epi8(sel, _mm_set1_epi8(char((1 << bits) - 1)));
+	int mask16 = _mm_movemask_epi8(mask);
+	unsigned char mask0 = (unsigned char)(mask16 & 255);
+	unsigned char mask1 = (unsigned char)(mask16 >> 8);
+
+	__m128i shuf = decodeShuffleMask(mask0, mask1);
+
+	__m128i result = _mm_or_si128(_mm_shuffle_epi8(rest, shuf), _mm_andnot_si128(mask, sel));
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+	return data + header_size + popcount16(mask16);
+}
+
+static SIMD_TARGET_AVX const unsigned char* decodeBytesV1Avx(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size, int control)
+{
+	assert(buffer_size % kByteGroupSize == 0);
+	assert(kByteGroupSize == 16);
+
+	if (control > 2)
+		return 0;
+
+	const int* bits = kBitsV1[control];
+
+	const unsigned char* header = data;
+
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+	if (size_t(data_end - data) < header_size)
+		return 0;
+
+	data += header_size;
+
+	size_t i = 0;
+
+	// fast-path: process 4 groups at a time, do a shared bounds check - each group reads <=32b
+	for (; i + kByteGroupSize * 4 <= buffer_size && size_t(data_end - data) >= kTailMaxSize * 4; i += kByteGroupSize * 4)
+	{
+		size_t header_offset = i / kByteGroupSize;
+		unsigned char header_byte = header[header_offset / 4];
+
+		data = decodeBytesGroupV1Avx(data, buffer + i + kByteGroupSize * 0, bits[(header_byte >> 0) & 3]);
+		data = decodeBytesGroupV1Avx(data, buffer + i + kByteGroupSize * 1, bits[(header_byte >> 2) & 3]);
+		data = decodeBytesGroupV1Avx(data, buffer + i + kByteGroupSize * 2, bits[(header_byte >> 4) & 3]);
+		data = decodeBytesGroupV1Avx(data, buffer + i + kByteGroupSize * 3, bits[(header_byte >> 6) & 3]);
+	}
+
+	// slow-path: process remaining groups
+	for (; i < buffer_size; i += kByteGroupSize)
+	{
+		if (size_t(data_end - data) < kTailMaxSize)
+			return 0;
+
+		size_t header_offset = i / kByteGroupSize;
+
+		int index = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+
+		data = decodeBytesGroupV1Avx(data, buffer + i, bits[index]);
+	}
+
+	return data;
+}
+
+template <int Mode>
+static SIMD_TARGET_AVX __m256i unzigzagV1(__m256i v)
+{
+	if (Mode == kDeltaByte)
+		return unzigzag8(v);
+	else if (Mode == kDeltaShort)
+		return _mm256_xor_si256(_mm256_sub_epi16(_mm256_setzero_si256(), _mm256_and_si256(v, _mm256_set1_epi16(1))), _mm256_srli_epi16(v, 1));
+	else if (Mode == kDeltaWord)
+		return _mm256_xor_si256(_mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(v, _mm256_set1_epi32(1))), _mm256_srli_epi32(v, 1));
+	else
+		return v;
+}
+
+template <int Mode>
+static SIMD_TARGET_AVX __m256i addDeltaV1(__m256i v, __m256i d)
+{
+	if (Mode == kDeltaByte)
+		return _mm256_add_epi8(v, d);
+	else if (Mode == kDeltaShort)
+		return _mm256_add_epi16(v, d);
+	else if (Mode == kDeltaWord)
+		return _mm256_add_epi32(v, d);
+	else
+		return _mm256_xor_si256(v, d);
+}
+
+template <int Mode>
+static SIMD_TARGET_AVX __m256i prefixSumV1(__m256i v, __m256i shuf0, __m256i shuf1)
+{
+	// each 32-bit element is a vertex delta; after this each element holds the combination of all deltas of the same phase up to and including it within a 128-bit lane
+	v = addDeltaV1<Mode>(v, _mm256_shuffle_epi8(v, shuf0));
+	v = addDeltaV1<Mode>(v, _mm256_shuffle_epi8(v, shuf1));
+
+	return v;
+}
+
+static SIMD_TARGET_AVX __m256i loadBytesV1(const unsigned char* data, bool full)
+{
+	return full ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)) : _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+}
+
+template <int Mode>
+static SIMD_TARGET_AVX void saveVerticesV1(__m128i v, __m128i& pi, __m128i shufp, unsigned char*& savep, size_t vertex_size)
+{
+#ifdef __GNUC__
+	typedef int __attribute__((aligned(1))) unaligned_int;
+#else
+	typedef int unaligned_int;
+#endif
+
+	// pi holds the last 4 decoded vertices; upper 128 bits are ignored
+	v = _mm256_castsi256_si128(addDeltaV1<Mode>(_mm256_castsi128_si256(v), _mm256_castsi128_si256(_mm_shuffle_epi8(pi, shufp))));
+	pi = v;
+
+	*reinterpret_cast<unaligned_int*>(savep) = _mm_cvtsi128_si32(v), savep += vertex_size;
+	*reinterpret_cast<unaligned_int*>(savep) = _mm_extract_epi32(v, 1), savep += vertex_size;
+	*reinterpret_cast<unaligned_int*>(savep) = _mm_extract_epi32(v, 2), savep += vertex_size;
+	*reinterpret_cast<unaligned_int*>(savep) = _mm_extract_epi32(v, 3), savep += vertex_size;
+}
+
+template <int Mode>
+static SIMD_TARGET_AVX void decodeDeltasV1Avx(unsigned char* vertex_data, const unsigned char* buffer, size_t vertex_count_aligned, size_t vertex_size, const unsigned char* last_word, int stride)
+{
+	__m128i pi = _mm_set1_epi32(int(readWord(last_word)));
+
+	__m256i shuf0 = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kDecodeStrideShuffle[stride - 1][0])));
+	__m256i shuf1 = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kDecodeStrideShuffle[stride - 1][1])));
+	__m128i shufp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kDecodeStrideShuffle[stride - 1][2]));
+
+	unsigned char* savep = vertex_data;
+
+	// process 32 vertices at a time; low 128-bit lanes hold the first 16 vertices, high lanes hold the next 16
+	for (size_t j = 0; j < vertex_count_aligned; j += 32)
+	{
+		// the last 16 vertices only use low lanes
+		bool full = j + 32 <= vertex_count_aligned;
+
+		__m256i r0 = loadBytesV1(buffer + j + 0 * vertex_count_aligned, full);
+		__m256i r1 = loadBytesV1(buffer + j + 1 * vertex_count_aligned, full);
+		__m256i r2 = loadBytesV1(buffer + j + 2 * vertex_count_aligned, full);
+		__m256i r3 = loadBytesV1(buffer + j + 3 * vertex_count_aligned, full);
+
+		transpose8(r0, r1, r2, r3);
+
+		r0 = prefixSumV1<Mode>(unzigzagV1<Mode>(r0), shuf0, shuf1);
+		r1 = prefixSumV1<Mode>(unzigzagV1<Mode>(r1), shuf0, shuf1);
+		r2 = prefixSumV1<Mode>(unzigzagV1<Mode>(r2), shuf0, shuf1);
+		r3 = prefixSumV1<Mode>(unzigzagV1<Mode>(r3), shuf0, shuf1);
+
+		saveVerticesV1<Mode>(_mm256_castsi256_si128(r0), pi, shufp, savep, vertex_size);
+		saveVerticesV1<Mode>(_mm256_castsi256_si128(r1), pi, shufp, savep, vertex_size);
+		saveVerticesV1<Mode>(_mm256_castsi256_si128(r2), pi, shufp, savep, vertex_size);
+		saveVerticesV1<Mode>(_mm256_castsi256_si128(r3), pi, shufp, savep, vertex_size);
+
+		if (!full)
+			break;
+
+		saveVerticesV1<Mode>(_mm256_extracti128_si256(r0, 1), pi, shufp, savep, vertex_size);
+		saveVerticesV1<Mode>(_mm256_extracti128_si256(r1, 1), pi, shufp, savep, vertex_size);
+		saveVerticesV1<Mode>(_mm256_extracti128_si256(r2, 1), pi, shufp, savep, vertex_size);
+		saveVerticesV1<Mode>(_mm256_extracti128_si256(r3, 1), pi, shufp, savep, vertex_size);
+	}
+}
+
+static SIMD_TARGET_AVX const unsigned char* decodeVertexBlockV1Avx(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[kVertexSizeMax])
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+	unsigned char buffer[kVertexBlockMaxSize * 4];
+	unsigned char transposed[kVertexBlockSizeBytes];
+
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+	size_t word_count = (vertex_size + 3) / 4;
+
+	if (size_t(data_end - data) < word_count * 2)
+		return 0;
+
+	const unsigned char* modes = data;
+	data += word_count * 2;
+
+	for (size_t k = 0; k < word_count; ++k)
+	{
+		size_t word_size = (k * 4 + 4 <= vertex_size) ? 4 : vertex_size - k * 4;
+
+		int mode = modes[k * 2 + 0] & 3;
+		int stride = ((modes[k * 2 + 0] >> 2) & 3) + 1;
+		int controls = modes[k * 2 + 1];
+
+		if ((modes[k * 2 + 0] & ~15) != 0 || (word_size < 4 && mode != kDeltaByte))
+			return 0;
+
+		for (int j = 0; j < 4; ++j)
+		{
+			if (j >= int(word_size))
+			{
+				memset(buffer + j * vertex_count_aligned, 0, vertex_count_aligned);
+				continue;
+			}
+
+			data = decodeBytesV1Avx(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned, (controls >> (j * 2)) & 3);
+			if (!data)
+				return 0;
+		}
+
+		// full words are decoded 16 vertices at a time, which may write garbage past vertex_count; transposed has room for that
+		if (word_size < 4)
+			decodeDeltasV1(transposed + k * 4, buffer, vertex_count_aligned, vertex_count, vertex_size, word_size, readWordPartial(last_vertex + k * 4, word_size), mode, stride);
+		else if (mode == kDeltaByte)
+			decodeDeltasV1Avx<kDeltaByte>(transposed + k * 4, buffer, vertex_count_aligned, vertex_size, last_vertex + k * 4, stride);
+		else if (mode == kDeltaShort)
+			decodeDeltasV1Avx<kDeltaShort>(transposed + k * 4, buffer, vertex_count_aligned, vertex_size, last_vertex + k * 4, stride);
+		else if (mode == kDeltaWord)
+			decodeDeltasV1Avx<kDeltaWord>(transposed + k * 4, buffer, vertex_count_aligned, vertex_size, last_vertex + k * 4, stride);
+		else
+			decodeDeltasV1Avx<kDeltaXor>(transposed + k * 4, buffer, vertex_count_aligned, vertex_size, last_vertex + k * 4, stride);
+	}
+
+	memcpy(vertex_data, transposed, vertex_count * vertex_size);
+
+	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
+#endif
+
+typedef const unsigned char* (*DecodeVertexBlockFn)(const unsigned char*, const unsigned char*, unsigned char*, size_t, size_t, unsigned char[kVertexSizeMax]);
+typedef unsigned char* (*EncodeVertexBlockFn)(unsigned char*, unsigned char*, const unsigned char*, size_t, size_t, unsigned char[kVertexSizeMax], int);
+
+struct DecodeVertexKernel
+{
+	const char* name;
+	DecodeVertexBlockFn decode;
+	DecodeVertexBlockFn decode_v1;
+};
+
+#ifdef SIMD_FALLBACK
+static bool cpuSupportsSsse3()
+{
+#ifdef _MSC_VER
+	int cpuinfo[4] = {};
+	__cpuid(cpuinfo, 1);
+
+	return (cpuinfo[2] & (1 << 9)) != 0;
+#else
+	__builtin_cpu_init();
+
+	return __builtin_cpu_supports("ssse3") != 0;
+#endif
+}
+#endif
+
+#ifdef SIMD_AVX_FALLBACK
+static bool cpuSupportsAvx2()
+{
+#ifdef _MSC_VER
+	int cpuinfo[4] = {};
+	__cpuid(cpuinfo, 1);
+
+	// AVX2 requires OS support for saving YMM registers (OSXSAVE + XCR0) in addition to the CPUID feature bit; the kernel also uses POPCNT
+	if ((cpuinfo[2] & (1 << 23)) == 0 || (cpuinfo[2] & (1 << 27)) == 0 || (cpuinfo[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+		return false;
+
+	int cpuinfo7[4] = {};
+	__cpuidex(cpuinfo7, 7, 0);
+
+	return (cpuinfo7[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif
+}
+#endif
+
+static DecodeVertexKernel getDecodeVertexKernel()
+{
+	DecodeVertexKernel result = {"scalar", 0, 0};
+
+#if defined(SIMD_FALLBACK) || (!defined(SIMD_SSE) && !defined(SIMD_NEON))
+	result.decode = decodeVertexBlock;
+#endif
+
+#if defined(SIMD_FALLBACK) || !defined(SIMD_SSE)
+	// NEON only accelerates format v0 for now; v1 blocks use the scalar decoder
+	result.decode_v1 = decodeVertexBlockV1;
+#endif
+
+#if defined(SIMD_SSE) && (defined(SIMD_AVX_FALLBACK) || !defined(SIMD_AVX))
+#ifdef SIMD_FALLBACK
+	if (cpuSupportsSsse3())
+#endif
+	{
+		result.name = "ssse3";
+		result.decode = decodeVertexBlockSimd;
+		result.decode_v1 = decodeVertexBlockV1Simd;
+	}
+#endif
+
+#ifdef SIMD_AVX
+#ifdef SIMD_AVX_FALLBACK
+	if (cpuSupportsAvx2())
+#endif
+	{
+		result.name = "avx2";
+		result.decode = decodeVertexBlockAvx;
+		result.decode_v1 = decodeVertexBlockV1Avx;
+	}
+#endif
+
+#ifdef SIMD_NEON
+	result.name = "neon";
+	result.decode = decodeVertexBlockSimd;
+#endif
+
+	return result;
+}
+
+static EncodeVertexBlockFn getEncodeVertexBlock()
+{
+	EncodeVertexBlockFn result = encodeVertexBlock;
+
+#ifdef SIMD_SSE
+#ifdef SIMD_FALLBACK
+	if (cpuSupportsSsse3())
+#endif
+		result = encodeVertexBlockSimd;
+#endif
+
+	return result;
+}
+
+// kernels are selected once on startup; codec functions fall back to selecting them on the fly if they are called before static initialization
+static DecodeVertexKernel gDecodeVertexKernel = getDecodeVertexKernel();
+static EncodeVertexBlockFn gEncodeVertexBlock = getEncodeVertexBlock();
+
+static EncodeVertexBlockFn getEncodeVertexBlock(int version)
+{
+	if (version == 1)
+		return encodeVertexBlockV1;
+
+	return gEncodeVertexBlock ? gEncodeVertexBlock : getEncodeVertexBlock();
+}
+
+static DecodeVertexBlockFn getDecodeVertexBlock(unsigned char header)
+{
+	if ((header & ~(kVertexHeaderSeekable | kVertexHeaderVersion)) != kVertexHeader)
+		return 0;
+
+	switch (header & kVertexHeaderVersion)
+	{
+	case 0:
+		return gDecodeVertexKernel.decode ? gDecodeVertexKernel.decode : getDecodeVertexKernel().decode;
+
+	case 1:
+		return gDecodeVertexKernel.decode_v1 ? gDecodeVertexKernel.decode_v1 : getDecodeVertexKernel().decode_v1;
+
+	default:
+		return 0;
+	}
+}
+
+static void writeOffset(unsigned char* data, size_t offset)
+{
+	data[0] = (unsigned char)(offset >> 0);
+	data[1] = (unsigned char)(offset >> 8);
+	data[2] = (unsigned char)(offset >> 16);
+	data[3] = (unsigned char)(offset >> 24);
+}
+
+static size_t readOffset(const unsigned char* data)
+{
+	return size_t(data[0]) | (size_t(data[1]) << 8) | (size_t(data[2]) << 16) | (size_t(data[3]) << 24);
+}
+
+static size_t encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, bool seekable, int level)
+{
+	int version = gEncodeVertexVersion;
+
+	unsigned char* data = buffer;
+	unsigned char* data_end = buffer + buffer_size;
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	// seekable streams store a 4-byte offset for each block followed by a seed vertex for each block
+	size_t table_size = seekable ? vertex_block_count * (4 + vertex_size) : 0;
+
+	if (size_t(data_end - data) < 1 + table_size + vertex_size)
+		return 0;
+
+	*data++ = (unsigned char)(kVertexHeader | version | (seekable ? kVertexHeaderSeekable : 0));
+
+	unsigned char* offsets = data;
+	unsigned char* seeds = data + vertex_block_count * 4;
+
+	data += table_size;
+
+	EncodeVertexBlockFn encode = getEncodeVertexBlock(version);
+
+#ifdef SIMD_SSE
+	assert(gEncodeBytesGroupInitialized);
+#endif
+
+	unsigned char last_vertex[kVertexSizeMax] = {};
+	if (vertex_count > 0)
+		memcpy(last_vertex, vertex_data, vertex_size);
+
+	size_t vertex_offset = 0;
+
+	for (size_t i = 0; vertex_offset < vertex_count; ++i)
+	{
+		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+		if (seekable)
+		{
+			// offsets are 32-bit so seekable streams are limited to 4 GB
+			if (size_t(data - buffer) > 0xffffffff)
+				return 0;
+
+			writeOffset(offsets + i * 4, data - buffer);
+			memcpy(seeds + i * vertex_size, last_vertex, vertex_size);
+		}
+
+		data = encode(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex, level);
+		if (!data)
+			return 0;
+
+		vertex_offset += block_size;
+	}
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	if (size_t(data_end - data) < tail_size)
+		return 0;
+
+	// write first vertex to the end of the stream and pad it to 32 bytes; this is important to simplify bounds checks in decoder
+	if (vertex_size < kTailMaxSize)
+	{
+		memset(data, 0, kTailMaxSize - vertex_size);
+		data += kTailMaxSize - vertex_size;
+	}
+
+	memcpy(data, vertex_data, vertex_size);
+	data += vertex_size;
+
+	assert(data >= buffer + tail_size);
+	assert(data <= buffer + buffer_size);
+
+	return data - buffer;
+}
+
+static int decodeVertexBuffer(unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, meshopt_VertexSink sink, void* sink_context)
+{
+	// when sink is specified, blocks are decoded into scratch memory and passed to the sink; scratch is padded to allow over-reading the last vertex
+	unsigned char scratch[kVertexBlockSizeBytes + 16];
+
+	const unsigned char* data = buffer;
+	const unsigned char* data_end = buffer + buffer_size;
+
+	if (size_t(data_end - data) < 1 + vertex_size)
+		return -2;
+
+	unsigned char header = *data++;
+
+	DecodeVertexBlockFn decode = getDecodeVertexBlock(header);
+	if (!decode)
+		return -1;
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	// seekable streams have the offset table and seed vertices before block data; we only need the first seed when decoding serially
+	size_t table_size = (header & kVertexHeaderSeekable) ? vertex_block_count * (4 + vertex_size) : 0;
+
+	if (size_t(data_end - data) < table_size + vertex_size)
+		return -2;
+
+	const unsigned char* offsets = data;
+
+	data += table_size;
+
+	unsigned char last_vertex[kVertexSizeMax];
+	memcpy(last_vertex, data_end - vertex_size, vertex_size);
+
+	size_t vertex_offset = 0;
+
+	for (size_t i = 0; vertex_offset < vertex_count; ++i)
+	{
+		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+		if (table_size && readOffset(offsets + i * 4) != size_t(data - buffer))
+			return -2;
+
+		data = decode(data, data_end, sink ? scratch : vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
+		if (!data)
+			return -2;
+
+		if (sink)
+			sink(sink_context, scratch, vertex_offset, block_size);
+
+		vertex_offset += block_size;
+	}
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	if (size_t(data_end - data) != tail_size)
+		return -3;
+
+	return 0;
+}
+
+struct EncodeVertexTasks
+{
+	const unsigned char* vertex_data;
+	size_t vertex_count;
+	size_t vertex_size;
+
+	EncodeVertexBlockFn encode;
+	int level;
+
+	// each task encodes its blocks into a separate scratch region; sizes are 0 on failure
+	unsigned char* scratch;
+	size_t scratch_size;
+	size_t* sizes;
+};
+
+static size_t getEncodeTaskScratchSize(size_t vertex_size)
+{
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_header_size = (vertex_block_size / kByteGroupSize + 3) / 4;
+
+	// block encoders require kTailMaxSize bytes of space before each byte group; version 1 blocks also store 2 mode bytes for each 4 bytes of vertex data
+	return kVertexBlocksPerTask * (vertex_size * (vertex_block_header_size + vertex_block_size) + (vertex_size + 3) / 4 * 2) + kTailMaxSize;
+}
+
+static void encodeVertexTask(void* context, size_t task_index)
+{
+	const EncodeVertexTasks& tasks = *static_cast<const EncodeVertexTasks*>(context);
+
+	size_t vertex_size = tasks.vertex_size;
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+
+	size_t vertex_begin = task_index * kVertexBlocksPerTask * vertex_block_size;
+	size_t vertex_end = (vertex_begin + kVertexBlocksPerTask * vertex_block_size < tasks.vertex_count) ? vertex_begin + kVertexBlocksPerTask * vertex_block_size : tasks.vertex_count;
+
+	unsigned char* data = tasks.scratch + task_index * tasks.scratch_size;
+	unsigned char* data_end = data + tasks.scratch_size;
+
+	// each block is encoded relative to the last vertex of the previous block, or the first vertex for the first block
+	unsigned char last_vertex[kVertexSizeMax];
+	memcpy(last_vertex, tasks.vertex_data + (vertex_begin > 0 ? vertex_begin - 1 : 0) * vertex_size, vertex_size);
+
+	for (size_t vertex_offset = vertex_begin; vertex_offset < vertex_end; vertex_offset += vertex_block_size)
+	{
+		size_t block_size = (vertex_offset + vertex_block_size < vertex_end) ? vertex_block_size : vertex_end - vertex_offset;
+
+		data = tasks.encode(data, data_end, tasks.vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex, tasks.level);
+		if (!data)
+		{
+			tasks.sizes[task_index] = 0;
+			return;
+		}
+	}
+
+	tasks.sizes[task_index] = data - (tasks.scratch + task_index * tasks.scratch_size);
+}
+
+struct DecodeVertexTasks
+{
+	unsigned char* vertex_data;
+	size_t vertex_count;
+	size_t vertex_size;
+
+	const unsigned char* buffer;
+	size_t buffer_size;
+
+	const unsigned char* offsets;
+	const unsigned char* seeds;
+	size_t block_count;
+
+	DecodeVertexBlockFn decode;
+	int* results;
+};
+
+static void decodeVertexTask(void* context, size_t task_index)
+{
+	const DecodeVertexTasks& tasks = *static_cast<const DecodeVertexTasks*>(context);
+
+	const unsigned char* data_end = tasks.buffer + tasks.buffer_size;
+
+	size_t vertex_size = tasks.vertex_size;
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	size_t block_begin = task_index * kVertexBlocksPerTask;
+	size_t block_end = (block_begin + kVertexBlocksPerTask < tasks.block_count) ? block_begin + kVertexBlocksPerTask : tasks.block_count;
+
+	unsigned char last_vertex[kVertexSizeMax];
+	memcpy(last_vertex, tasks.seeds + block_begin * vertex_size, vertex_size);
+
+	for (size_t i = block_begin; i < block_end; ++i)
+	{
+		size_t vertex_offset = i * vertex_block_size;
+		size_t block_size = (vertex_offset + vertex_block_size < tasks.vertex_count) ? vertex_block_size : tasks.vertex_count - vertex_offset;
+
+		// block data has to end where the next block starts, or where the tail starts for the last block
+		size_t block_data_begin = readOffset(tasks.offsets + i * 4);
+		size_t block_data_end = (i + 1 < tasks.block_count) ? readOffset(tasks.offsets + (i + 1) * 4) : tasks.buffer_size - tail_size;
+
+		if (block_data_begin > block_data_end || block_data_end > tasks.buffer_size - tail_size)
+		{
+			tasks.results[task_index] = -2;
+			return;
+		}
+
+		// note that decoders may read past the block data but never past data_end - they rely on the tail for bounds checks
+		const unsigned char* data = tasks.decode(tasks.buffer + block_data_begin, data_end, tasks.vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
+
+		if (!data || data != tasks.buffer + block_data_end)
+		{
+			// the last block is followed by the tail, so stopping short of it means the stream has trailing data
+			bool trailing = data && i + 1 == tasks.block_count && data < tasks.buffer + block_data_end;
+
+			tasks.results[task_index] = trailing ? -3 : -2;
+			return;
+		}
+	}
+
+	tasks.results[task_index] = 0;
+}
+
+} // namespace meshopt
+
+namespace meshopt
+{
+
+static float dequantizeHalf(unsigned short h)
+{
+	unsigned int sign = (h & 0x8000) << 16;
+	int exp = (h >> 10) & 31;
+	unsigned int mant = h & 1023;
+
+	// denormals are scaled directly; inf/NaN keep the mantissa
+	if (exp == 0)
+	{
+		float r = float(mant) * (1.f / 16777216.f);
+		return sign ? -r : r;
+	}
+
+	union { unsigned int ui; float f; } u;
+	u.ui = sign | ((exp == 31) ? 0x7f800000 | (mant << 13) : (unsigned(exp + 112) << 23) | (mant << 13));
+
+	return u.f;
+}
+
+static float dequantizeComponent(const unsigned char* data, int format, size_t index)
+{
+	switch (format)
+	{
+	case meshopt_AttributeFloat:
+	{
+		float r;
+		memcpy(&r, data + index * 4, 4);
+		return r;
+	}
+
+	case meshopt_AttributeHalf:
+	{
+		unsigned short h;
+		memcpy(&h, data + index * 2, 2);
+		return dequantizeHalf(h);
+	}
+
+	case meshopt_AttributeUnorm8:
+		return float(data[index]) * (1.f / 255);
+
+	case meshopt_AttributeSnorm8:
+	case meshopt_AttributeOct8:
+	{
+		float r = float((signed char)data[index]) * (1.f / 127);
+		return r < -1 ? -1 : r;
+	}
+
+	case meshopt_AttributeUnorm16:
+	{
+		unsigned short q;
+		memcpy(&q, data + index * 2, 2);
+		return float(q) * (1.f / 65535);
+	}
+
+	case meshopt_AttributeSnorm16:
+	case meshopt_AttributeOct16:
+	{
+		short q;
+		memcpy(&q, data + index * 2, 2);
+		float r = float(q) * (1.f / 32767);
+		return r < -1 ? -1 : r;
+	}
+
+	default:
+		assert(!"Unknown attribute format");
+		return 0;
+	}
+}
+
+static void dequantizeAttribute(unsigned char* destination, size_t destination_stride, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, const meshopt_VertexAttribute& attribute)
+{
+	bool oct = attribute.format == meshopt_AttributeOct8 || attribute.format == meshopt_AttributeOct16;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const unsigned char* data = vertex_data + i * vertex_size + attribute.source_offset;
+		float* result = reinterpret_cast<float*>(destination + i * destination_stride + attribute.destination_offset);
+
+		float v[4];
+		size_t components = attribute.components;
+
+		for (size_t k = 0; k < components; ++k)
+			v[k] = dequantizeComponent(data, attribute.format, k);
+
+		if (oct)
+		{
+			// octahedral decoding: points outside of the center diamond are folded back into the lower hemisphere
+			float x = v[0], y = v[1];
+			float z = 1 - fabsf(x) - fabsf(y);
+			float t = z < 0 ? -z : 0;
+
+			x += x >= 0 ? -t : t;
+			y += y >= 0 ? -t : t;
+
+			float l = sqrtf(x * x + y * y + z * z);
+			float rl = l == 0 ? 0 : 1 / l;
+
+			v[0] = x * rl;
+			v[1] = y * rl;
+			v[2] = z * rl;
+			components = 3;
+		}
+
+		for (size_t k = 0; k < components; ++k)
+			result[k] = v[k] * attribute.scale[k] + attribute.bias[k];
+	}
+}
+
+#ifdef SIMD_SSE
+static SIMD_TARGET_SSE void dequantizeAttributeSimd(unsigned char* destination, size_t destination_stride, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, const meshopt_VertexAttribute& attribute)
+{
+#ifdef __GNUC__
+	typedef int __attribute__((aligned(1))) unaligned_int;
+#else
+	typedef int unaligned_int;
+#endif
+
+	int format = attribute.format;
+
+	// other formats need special handling for each component and use the scalar path
+	if (format != meshopt_AttributeUnorm8 && format != meshopt_AttributeSnorm8 && format != meshopt_AttributeUnorm16 && format != meshopt_AttributeSnorm16)
+	{
+		dequantizeAttribute(destination, destination_stride, vertex_data, vertex_count, vertex_size, attribute);
+		return;
+	}
+
+	size_t components = attribute.components;
+
+	float norm = (format == meshopt_AttributeUnorm8) ? 1.f / 255 : (format == meshopt_AttributeSnorm8) ? 1.f / 127 : (format == meshopt_AttributeUnorm16) ? 1.f / 65535 : 1.f / 32767;
+	bool snorm = format == meshopt_AttributeSnorm8 || format == meshopt_AttributeSnorm16;
+
+	__m128 normv = _mm_set1_ps(norm);
+	__m128 minv = _mm_set1_ps(snorm ? -1.f : 0.f);
+	__m128 scale = _mm_loadu_ps(attribute.scale);
+	__m128 bias = _mm_loadu_ps(attribute.bias);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const unsigned char* data = vertex_data + i * vertex_size + attribute.source_offset;
+		float* result = reinterpret_cast<float*>(destination + i * destination_stride + attribute.destination_offset);
+
+		// note: this reads up to 6 bytes past the attribute, which callers accommodate by padding the source
+		__m128i q;
+
+		switch (format)
+		{
+		case meshopt_AttributeUnorm8:
+			q = _mm_cvtsi32_si128(*reinterpret_cast<const unaligned_int*>(data));
+			q = _mm_unpacklo_epi16(_mm_unpacklo_epi8(q, _mm_setzero_si128()), _mm_setzero_si128());
+			break;
+
+		case meshopt_AttributeSnorm8:
+			q = _mm_cvtsi32_si128(*reinterpret_cast<const unaligned_int*>(data));
+			q = _mm_unpacklo_epi8(q, q);
+			q = _mm_srai_epi32(_mm_unpacklo_epi16(q, q), 24);
+			break;
+
+		case meshopt_AttributeUnorm16:
+			q = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+			q = _mm_unpacklo_epi16(q, _mm_setzero_si128());
+			break;
+
+		default:
+			q = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+			q = _mm_srai_epi32(_mm_unpacklo_epi16(q, q), 16);
+			break;
+		}
+
+		// same operation order as dequantizeAttribute to get identical results
+		__m128 v = _mm_mul_ps(_mm_cvtepi32_ps(q), normv);
+		v = snorm ? _mm_max_ps(v, minv) : v;
+		v = _mm_add_ps(_mm_mul_ps(v, scale), bias);
+
+		switch (components)
+		{
+		case 1:
+			_mm_store_ss(result, v);
+			break;
+
+		case 2:
+			_mm_storel_pi(reinterpret_cast<__m64*>(result), v);
+			break;
+
+		case 3:
+			_mm_storel_pi(reinterpret_cast<__m64*>(result), v);
+			_mm_store_ss(result + 2, _mm_movehl_ps(v, v));
+			break;
+
+		default:
+			_mm_storeu_ps(result, v);
+		}
+	}
+}
+#endif
+
+typedef void (*DequantizeAttributeFn)(unsigned char*, size_t, const unsigned char*, size_t, size_t, const meshopt_VertexAttribute&);
+
+static DequantizeAttributeFn getDequantizeAttribute()
+{
+	DequantizeAttributeFn result = dequantizeAttribute;
+
+#ifdef SIMD_SSE
+#ifdef SIMD_FALLBACK
+	if (cpuSupportsSsse3())
+#endif
+		result = dequantizeAttributeSimd;
+#endif
+
+	return result;
+}
+
+static DequantizeAttributeFn gDequantizeAttribute = getDequantizeAttribute();
+
+struct DequantizeContext
+{
+	unsigned char* destination;
+	size_t destination_stride;
+	size_t vertex_size;
+
+	const meshopt_VertexAttribute* attributes;
+	size_t attribute_count;
+
+	DequantizeAttributeFn dequantize;
+};
+
+static void dequantizeBlock(void* context, const void* vertices, size_t vertex_offset, size_t vertex_count)
+{
+	const DequantizeContext& ctx = *static_cast<const DequantizeContext*>(context);
+
+	for (size_t i = 0; i < ctx.attribute_count; ++i)
+		ctx.dequantize(ctx.destination + vertex_offset * ctx.destination_stride, ctx.destination_stride, static_cast<const unsigned char*>(vertices), vertex_count, ctx.vertex_size, ctx.attributes[i]);
+}
+
+struct ScatterContext
+{
+	size_t vertex_size;
+
+	const meshopt_VertexOutput* outputs;
+	size_t output_count;
+};
+
+template <size_t Size>
+static void scatterVertices(unsigned char* destination, size_t stride, const unsigned char* source, size_t vertex_size, size_t vertex_count, size_t size)
+{
+	for (size_t i = 0; i < vertex_count; ++i)
+		memcpy(destination + i * stride, source + i * vertex_size, Size ? Size : size);
+}
+
+static void scatterBlock(void* context, const void* vertices, size_t vertex_offset, size_t vertex_count)
+{
+	const ScatterContext& ctx = *static_cast<const ScatterContext*>(context);
+
+	size_t vertex_size = ctx.vertex_size;
+
+	for (size_t i = 0; i < ctx.output_count; ++i)
+	{
+		const meshopt_VertexOutput& output = ctx.outputs[i];
+
+		const unsigned char* source = static_cast<const unsigned char*>(vertices) + output.offset;
+		unsigned char* destination = static_cast<unsigned char*>(output.destination) + vertex_offset * output.stride;
+
+		// common attribute sizes use a fixed-size copy since a variable-size memcpy for each vertex is much slower
+		switch (output.size)
+		{
+		case 4:
+			scatterVertices<4>(destination, output.stride, source, vertex_size, vertex_count, 4);
+			break;
+		case 6:
+			scatterVertices<6>(destination, output.stride, source, vertex_size, vertex_count, 6);
+			break;
+		case 8:
+			scatterVertices<8>(destination, output.stride, source, vertex_size, vertex_count, 8);
+			break;
+		case 12:
+			scatterVertices<12>(destination, output.stride, source, vertex_size, vertex_count, 12);
+			break;
+		case 16:
+			scatterVertices<16>(destination, output.stride, source, vertex_size, vertex_count, 16);
+			break;
+		default:
+			scatterVertices<0>(destination, output.stride, source, vertex_size, vertex_count, output.size);
+		}
+	}
+}
+
+} // namespace meshopt
+
+struct meshopt_VertexDecoder
+{
+	size_t vertex_count;
+	size_t vertex_size;
+
+	meshopt_VertexSink sink;
+	void* sink_context;
+
+	meshopt::DecodeVertexBlockFn decode;
+
+	// stream prefix contains the header, block offsets and block seed vertices
+	size_t prefix_size;
+	size_t position;
+
+	// block data that has been fed but not decoded yet; data_offset is the position of the first buffered byte in the stream
+	unsigned char* data;
+	size_t data_size;
+	size_t data_capacity;
+	size_t data_offset;
+
+	unsigned char* offsets;
+	unsigned char* scratch;
+
+	size_t vertex_offset;
+	size_t block_index;
+
+	int error;
+
+	unsigned char last_vertex[meshopt::kVertexSizeMax];
+};
+
+namespace meshopt
+{
+
+static size_t getVertexDecoderCapacity(size_t vertex_size)
+{
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_header_size = (vertex_block_size / kByteGroupSize + 3) / 4;
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	// a full buffer always contains the entire next block along with enough padding for the block decoder bounds checks
+	return vertex_size * (vertex_block_header_size + vertex_block_size) + (vertex_size + 3) / 4 * 2 + tail_size;
+}
+
+static int decodeStreamBlocks(meshopt_VertexDecoder* decoder, bool final)
+{
+	size_t vertex_size = decoder->vertex_size;
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (decoder->vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	while (decoder->vertex_offset < decoder->vertex_count)
+	{
+		if (readOffset(decoder->offsets + decoder->block_index * 4) != decoder->data_offset)
+			return -2;
+
+		// the next block offset tells us where the block ends, and decoders only need kTailMaxSize bytes past that for bounds checks
+		// the last block is followed by the tail instead, so we wait until the buffer has enough data for any block
+		size_t required = decoder->data_capacity;
+
+		if (decoder->block_index + 1 < vertex_block_count)
+		{
+			size_t block_data_end = readOffset(decoder->offsets + (decoder->block_index + 1) * 4);
+
+			if (block_data_end < decoder->data_offset || block_data_end - decoder->data_offset + kTailMaxSize > decoder->data_capacity)
+				return -2;
+
+			required = block_data_end - decoder->data_offset + kTailMaxSize;
+		}
+
+		if (!final && decoder->data_size < required)
+			break;
+
+		size_t block_size = (decoder->vertex_offset + vertex_block_size < decoder->vertex_count) ? vertex_block_size : decoder->vertex_count - decoder->vertex_offset;
+
+		const unsigned char* data = decoder->decode(decoder->data, decoder->data + decoder->data_size, decoder->scratch, block_size, vertex_size, decoder->last_vertex);
+		if (!data)
+			return -2;
+
+		decoder->sink(decoder->sink_context, decoder->scratch, decoder->vertex_offset, block_size);
+
+		size_t consumed = data - decoder->data;
+
+		memmove(decoder->data, data, decoder->data_size - consumed);
+		decoder->data_size -= consumed;
+		decoder->data_offset += consumed;
+
+		decoder->vertex_offset += block_size;
+		decoder->block_index++;
+	}
+
+	// once all blocks are decoded, the buffer can only contain the tail
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	if (decoder->vertex_offset == decoder->vertex_count && decoder->data_size > tail_size)
+		return -3;
+
+	return 0;
+}
+
+} // namespace meshopt
+
+size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= kVertexSizeMax);
+
+	return encodeVertexBuffer(buffer, buffer_size, static_cast<const unsigned char*>(vertices), vertex_count, vertex_size, /* seekable= */ false, kEncodeVertexLevelDefault);
+}
+
+size_t meshopt_encodeVertexBufferLevel(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, int level)
+{
+	using namespace meshopt;
 
-#undef TEMP
-#undef LOAD
-#undef GRP4
-#undef FIXD
-#undef SAVE
-		}
-	}
+	assert(vertex_size > 0 && vertex_size <= kVertexSizeMax);
+	assert(level >= 0 && level <= 3);
 
-	memcpy(vertex_data, transposed, vertex_count * vertex_size);
+	return encodeVertexBuffer(buffer, buffer_size, static_cast<const unsigned char*>(vertices), vertex_count, vertex_size, /* seekable= */ false, level);
+}
 
-	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+size_t meshopt_encodeVertexBufferBound(size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
 
-	return data;
+	assert(vertex_size > 0 && vertex_size <= kVertexSizeMax);
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	size_t vertex_block_header_size = (vertex_block_size / kByteGroupSize + 3) / 4;
+	size_t vertex_block_data_size = vertex_block_size;
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	// version 1 blocks store 2 mode bytes for each 4 bytes of vertex data; we don't know the version so the bound covers both
+	size_t vertex_block_mode_size = (vertex_size + 3) / 4 * 2;
+
+	return 1 + vertex_block_count * (vertex_size * (vertex_block_header_size + vertex_block_data_size) + vertex_block_mode_size) + tail_size;
 }
-#endif
 
-} // namespace meshopt
+size_t meshopt_encodeVertexBufferSeekable(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
 
-size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size)
+	assert(vertex_size > 0 && vertex_size <= kVertexSizeMax);
+
+	return encodeVertexBuffer(buffer, buffer_size, static_cast<const unsigned char*>(vertices), vertex_count, vertex_size, /* seekable= */ true, kEncodeVertexLevelDefault);
+}
+
+size_t meshopt_encodeVertexBufferSeekableBound(size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	return meshopt_encodeVertexBufferBound(vertex_count, vertex_size) + vertex_block_count * (4 + vertex_size);
+}
+
+size_t meshopt_encodeVertexBufferParallel(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_Dispatch dispatch, void* dispatch_context)
 {
 	using namespace meshopt;
 
-	assert(vertex_size > 0 && vertex_size <= 256);
-	assert(vertex_size % 4 == 0);
+	assert(vertex_size > 0 && vertex_size <= kVertexSizeMax);
 
 	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+	int version = gEncodeVertexVersion;
 
-	unsigned char* data = buffer;
-	unsigned char* data_end = buffer + buffer_size;
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
 
-	if (size_t(data_end - data) < 1 + vertex_size)
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	if (buffer_size < 1 + tail_size)
 		return 0;
 
-	*data++ = kVertexHeader;
+	meshopt_Allocator allocator;
 
-	unsigned char last_vertex[256] = {};
-	if (vertex_count > 0)
-		memcpy(last_vertex, vertex_data, vertex_size);
+	size_t task_count = (vertex_block_count + kVertexBlocksPerTask - 1) / kVertexBlocksPerTask;
+	size_t scratch_size = getEncodeTaskScratchSize(vertex_size);
 
-	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	EncodeVertexTasks tasks = {};
+	tasks.vertex_data = vertex_data;
+	tasks.vertex_count = vertex_count;
+	tasks.vertex_size = vertex_size;
+	tasks.encode = getEncodeVertexBlock(version);
+	tasks.level = kEncodeVertexLevelDefault;
+	tasks.scratch = allocator.allocate<unsigned char>(task_count * scratch_size + 1);
+	tasks.scratch_size = scratch_size;
+	tasks.sizes = allocator.allocate<size_t>(task_count + 1);
 
-	size_t vertex_offset = 0;
+#ifdef SIMD_SSE
+	assert(gEncodeBytesGroupInitialized);
+#endif
 
-	while (vertex_offset < vertex_count)
+	if (dispatch)
 	{
-		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+		dispatch(dispatch_context, encodeVertexTask, &tasks, task_count);
+	}
+	else
+	{
+		for (size_t i = 0; i < task_count; ++i)
+			encodeVertexTask(&tasks, i);
+	}
 
-		data = encodeVertexBlock(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
-		if (!data)
-			return 0;
+	unsigned char* data = buffer;
 
-		vertex_offset += block_size;
-	}
+	*data++ = (unsigned char)(kVertexHeader | version);
 
-	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+	// concatenating the tasks results in the same output as serial encoding since blocks only depend on the preceding vertex
+	for (size_t i = 0; i < task_count; ++i)
+	{
+		size_t size = tasks.sizes[i];
 
-	if (size_t(data_end - data) < tail_size)
-		return 0;
+		if (size == 0 || size_t(buffer + buffer_size - data) < size + tail_size)
+			return 0;
 
-	// write first vertex to the end of the stream and pad it to 32 bytes; this is important to simplify bounds checks in decoder
+		memcpy(data, tasks.scratch + i * scratch_size, size);
+		data += size;
+	}
+
+	// write first vertex to the end of the stream and pad it to 32 bytes, see encodeVertexBuffer
 	if (vertex_size < kTailMaxSize)
 	{
 		memset(data, 0, kTailMaxSize - vertex_size);
@@ -794,48 +3407,122 @@ size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, con
 	memcpy(data, vertex_data, vertex_size);
 	data += vertex_size;
 
-	assert(data >= buffer + tail_size);
 	assert(data <= buffer + buffer_size);
 
 	return data - buffer;
 }
 
-size_t meshopt_encodeVertexBufferBound(size_t vertex_count, size_t vertex_size)
+int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= kVertexSizeMax);
+
+#if defined(SIMD_SSE) || defined(SIMD_NEON)
+	assert(gDecodeBytesGroupInitialized);
+#endif
+
+	return decodeVertexBuffer(static_cast<unsigned char*>(destination), vertex_count, vertex_size, buffer, buffer_size, 0, 0);
+}
+
+int meshopt_decodeVertexBufferParallel(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, meshopt_Dispatch dispatch, void* dispatch_context)
 {
 	using namespace meshopt;
 
-	assert(vertex_size > 0 && vertex_size <= 256);
-	assert(vertex_size % 4 == 0);
+	assert(vertex_size > 0 && vertex_size <= kVertexSizeMax);
+
+#if defined(SIMD_SSE) || defined(SIMD_NEON)
+	assert(gDecodeBytesGroupInitialized);
+#endif
+
+	// regular streams can only be decoded serially since block boundaries and seed vertices are only known after decoding preceding blocks
+	if (buffer_size < 1 || (buffer[0] & kVertexHeaderSeekable) == 0)
+		return decodeVertexBuffer(static_cast<unsigned char*>(destination), vertex_count, vertex_size, buffer, buffer_size, 0, 0);
+
+	DecodeVertexBlockFn decode = getDecodeVertexBlock(buffer[0]);
+	if (!decode)
+		return -1;
 
 	size_t vertex_block_size = getVertexBlockSize(vertex_size);
 	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
 
-	size_t vertex_block_header_size = (vertex_block_size / kByteGroupSize + 3) / 4;
-	size_t vertex_block_data_size = vertex_block_size;
-
 	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
 
-	return 1 + vertex_block_count * vertex_size * (vertex_block_header_size + vertex_block_data_size) + tail_size;
+	if (buffer_size < 1 + vertex_block_count * (4 + vertex_size) + tail_size)
+		return -2;
+
+	if (vertex_block_count == 0)
+		return buffer_size == 1 + tail_size ? 0 : -3;
+
+	// the first block has to start right after the table and the blocks have to cover the stream until the tail
+	if (readOffset(buffer + 1) != 1 + vertex_block_count * (4 + vertex_size))
+		return -2;
+
+	meshopt_Allocator allocator;
+
+	size_t task_count = (vertex_block_count + kVertexBlocksPerTask - 1) / kVertexBlocksPerTask;
+
+	int* results = allocator.allocate<int>(task_count);
+
+	DecodeVertexTasks tasks = {};
+	tasks.vertex_data = static_cast<unsigned char*>(destination);
+	tasks.vertex_count = vertex_count;
+	tasks.vertex_size = vertex_size;
+	tasks.buffer = buffer;
+	tasks.buffer_size = buffer_size;
+	tasks.offsets = buffer + 1;
+	tasks.seeds = buffer + 1 + vertex_block_count * 4;
+	tasks.block_count = vertex_block_count;
+	tasks.decode = decode;
+	tasks.results = results;
+
+	if (dispatch)
+	{
+		dispatch(dispatch_context, decodeVertexTask, &tasks, task_count);
+	}
+	else
+	{
+		for (size_t i = 0; i < task_count; ++i)
+			decodeVertexTask(&tasks, i);
+	}
+
+	for (size_t i = 0; i < task_count; ++i)
+		if (results[i] != 0)
+			return results[i];
+
+	return 0;
 }
 
-int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size)
+const char* meshopt_decodeVertexBufferKernel()
 {
 	using namespace meshopt;
 
-	assert(vertex_size > 0 && vertex_size <= 256);
-	assert(vertex_size % 4 == 0);
+	return gDecodeVertexKernel.decode ? gDecodeVertexKernel.name : getDecodeVertexKernel().name;
+}
 
-	const unsigned char* (*decode)(const unsigned char*, const unsigned char*, unsigned char*, size_t, size_t, unsigned char[256]) = 0;
+void meshopt_encodeVertexVersion(int version)
+{
+	assert(unsigned(version) <= 1);
 
-#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
-	int cpuinfo[4] = {};
-	__cpuid(cpuinfo, 1);
-	decode = (cpuinfo[2] & (1 << 9)) ? decodeVertexBlockSimd : decodeVertexBlock;
-#elif defined(SIMD_SSE) || defined(SIMD_NEON)
-	decode = decodeVertexBlockSimd;
-#else
-	decode = decodeVertexBlock;
-#endif
+	meshopt::gEncodeVertexVersion = version;
+}
+
+int meshopt_decodeVertexVersion(const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	if (buffer_size < 1 || !getDecodeVertexBlock(buffer[0]))
+		return -1;
+
+	return buffer[0] & kVertexHeaderVersion;
+}
+
+int meshopt_decodeVertexBufferRange(void* destination, size_t first, size_t count, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= kVertexSizeMax);
+	assert(first <= vertex_count && count <= vertex_count - first);
 
 #if defined(SIMD_SSE) || defined(SIMD_NEON)
 	assert(gDecodeBytesGroupInitialized);
@@ -843,37 +3530,273 @@ int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t ve
 
 	unsigned char* vertex_data = static_cast<unsigned char*>(destination);
 
-	const unsigned char* data = buffer;
 	const unsigned char* data_end = buffer + buffer_size;
 
-	if (size_t(data_end - data) < 1 + vertex_size)
+	if (buffer_size < 1 + vertex_size)
 		return -2;
 
-	if (*data++ != kVertexHeader)
+	DecodeVertexBlockFn decode = getDecodeVertexBlock(buffer[0]);
+	if (!decode)
 		return -1;
 
-	unsigned char last_vertex[256];
-	memcpy(last_vertex, data_end - vertex_size, vertex_size);
+	bool seekable = (buffer[0] & kVertexHeaderSeekable) != 0;
 
 	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
 
-	size_t vertex_offset = 0;
+	size_t table_size = seekable ? vertex_block_count * (4 + vertex_size) : 0;
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	if (buffer_size < 1 + table_size + tail_size)
+		return -2;
+
+	if (count == 0)
+		return 0;
+
+	const unsigned char* offsets = buffer + 1;
+	const unsigned char* seeds = buffer + 1 + vertex_block_count * 4;
 
-	while (vertex_offset < vertex_count)
+	size_t first_block = first / vertex_block_size;
+	size_t last_block = (first + count - 1) / vertex_block_size;
+
+	// seekable streams can start decoding from the first block of the range; regular streams have to decode all preceding blocks
+	size_t block = seekable ? first_block : 0;
+
+	const unsigned char* data = seekable ? buffer + readOffset(offsets + block * 4) : buffer + 1 + table_size;
+
+	if (data < buffer + 1 + table_size || data > data_end - tail_size)
+		return -2;
+
+	unsigned char last_vertex[kVertexSizeMax];
+	memcpy(last_vertex, seekable ? seeds + block * vertex_size : data_end - vertex_size, vertex_size);
+
+	unsigned char scratch[kVertexBlockSizeBytes];
+
+	for (; block <= last_block; ++block)
 	{
+		size_t vertex_offset = block * vertex_block_size;
 		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
 
-		data = decode(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
+		if (seekable && readOffset(offsets + block * 4) != size_t(data - buffer))
+			return -2;
+
+		// blocks that are entirely inside the range are decoded directly into destination
+		bool inside = vertex_offset >= first && vertex_offset + block_size <= first + count;
+
+		data = decode(data, data_end, inside ? vertex_data + (vertex_offset - first) * vertex_size : scratch, block_size, vertex_size, last_vertex);
 		if (!data)
 			return -2;
 
-		vertex_offset += block_size;
+		size_t copy_begin = vertex_offset > first ? vertex_offset : first;
+		size_t copy_end = vertex_offset + block_size < first + count ? vertex_offset + block_size : first + count;
+
+		if (!inside && copy_begin < copy_end)
+			memcpy(vertex_data + (copy_begin - first) * vertex_size, scratch + (copy_begin - vertex_offset) * vertex_size, (copy_end - copy_begin) * vertex_size);
 	}
 
-	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+	// the last decoded block has to end where the next block starts, or where the tail starts
+	if (block == vertex_block_count)
+	{
+		if (size_t(data_end - data) != tail_size)
+			return -3;
+	}
+	else if (seekable && readOffset(offsets + block * 4) != size_t(data - buffer))
+	{
+		return -2;
+	}
 
-	if (size_t(data_end - data) != tail_size)
-		return -3;
+	return 0;
+}
+
+size_t meshopt_vertexDecoderSize(size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= kVertexSizeMax);
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	return sizeof(meshopt_VertexDecoder) + vertex_block_count * 4 + getVertexDecoderCapacity(vertex_size) + vertex_block_size * vertex_size;
+}
+
+meshopt_VertexDecoder* meshopt_vertexDecoderInit(void* memory, size_t memory_size, size_t vertex_count, size_t vertex_size, meshopt_VertexSink sink, void* sink_context)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= kVertexSizeMax);
+	assert(memory_size >= meshopt_vertexDecoderSize(vertex_count, vertex_size));
+	assert(size_t(memory) % sizeof(void*) == 0);
+	assert(sink);
+	(void)memory_size;
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	meshopt_VertexDecoder* decoder = static_cast<meshopt_VertexDecoder*>(memory);
+	memset(decoder, 0, sizeof(meshopt_VertexDecoder));
+
+	decoder->vertex_count = vertex_count;
+	decoder->vertex_size = vertex_size;
+	decoder->sink = sink;
+	decoder->sink_context = sink_context;
+
+	decoder->prefix_size = 1 + vertex_block_count * (4 + vertex_size);
+
+	unsigned char* data = reinterpret_cast<unsigned char*>(decoder + 1);
+
+	decoder->offsets = data;
+	data += vertex_block_count * 4;
+
+	decoder->data = data;
+	decoder->data_capacity = getVertexDecoderCapacity(vertex_size);
+	data += decoder->data_capacity;
+
+	decoder->scratch = data;
+
+#if defined(SIMD_SSE) || defined(SIMD_NEON)
+	assert(gDecodeBytesGroupInitialized);
+#endif
+
+	return decoder;
+}
+
+int meshopt_vertexDecoderFeed(meshopt_VertexDecoder* decoder, const unsigned char* data, size_t size)
+{
+	using namespace meshopt;
+
+	while (size > 0 && decoder->error == 0)
+	{
+		size_t count = 0;
+
+		if (decoder->position < decoder->prefix_size)
+		{
+			size_t vertex_block_count = (decoder->prefix_size - 1) / (4 + decoder->vertex_size);
+			size_t seeds_offset = 1 + vertex_block_count * 4;
+
+			count = (size < decoder->prefix_size - decoder->position) ? size : decoder->prefix_size - decoder->position;
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				size_t position = decoder->position + i;
+
+				// the header selects the block decoder; the first block seed is the first vertex and we don't need seeds for other blocks since blocks are decoded in order
+				if (position == 0)
+				{
+					decoder->decode = getDecodeVertexBlock(data[i]);
+					decoder->error = (decoder->decode && (data[i] & kVertexHeaderSeekable)) ? 0 : -1;
+				}
+				else if (position < seeds_offset)
+					decoder->offsets[position - 1] = data[i];
+				else if (position < seeds_offset + decoder->vertex_size)
+					decoder->last_vertex[position - seeds_offset] = data[i];
+			}
+
+			decoder->data_offset = decoder->position + count;
+		}
+		else
+		{
+			count = (size < decoder->data_capacity - decoder->data_size) ? size : decoder->data_capacity - decoder->data_size;
+
+			memcpy(decoder->data + decoder->data_size, data, count);
+			decoder->data_size += count;
+
+			decoder->error = decodeStreamBlocks(decoder, /* final= */ false);
+		}
+
+		decoder->position += count;
+		data += count;
+		size -= count;
+	}
+
+	return decoder->error;
+}
+
+int meshopt_vertexDecoderFinish(meshopt_VertexDecoder* decoder)
+{
+	using namespace meshopt;
+
+	if (decoder->error)
+		return decoder->error;
+
+	if (decoder->position < decoder->prefix_size)
+		return decoder->error = -2;
+
+	decoder->error = decodeStreamBlocks(decoder, /* final= */ true);
+	if (decoder->error)
+		return decoder->error;
+
+	size_t tail_size = decoder->vertex_size < kTailMaxSize ? kTailMaxSize : decoder->vertex_size;
+
+	if (decoder->data_size != tail_size)
+		return decoder->error = decoder->data_size < tail_size ? -2 : -3;
 
 	return 0;
 }
+
+int meshopt_decodeVertexBufferDequantize(void* destination, size_t destination_stride, size_t vertex_count, size_t vertex_size, const meshopt_VertexAttribute* attributes, size_t attribute_count, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= kVertexSizeMax);
+	assert(destination_stride % 4 == 0);
+
+	for (size_t i = 0; i < attribute_count; ++i)
+	{
+		const meshopt_VertexAttribute& attribute = attributes[i];
+		(void)attribute;
+
+		bool oct = attribute.format == meshopt_AttributeOct8 || attribute.format == meshopt_AttributeOct16;
+		(void)oct;
+
+		size_t component_size = (attribute.format == meshopt_AttributeFloat) ? 4 : (attribute.format == meshopt_AttributeUnorm8 || attribute.format == meshopt_AttributeSnorm8 || attribute.format == meshopt_AttributeOct8) ? 1 : 2;
+		(void)component_size;
+
+		assert(attribute.format >= meshopt_AttributeFloat && attribute.format <= meshopt_AttributeOct16);
+		assert(attribute.components >= 1 && attribute.components <= 4);
+		assert(!oct || attribute.components == 2);
+		assert(attribute.source_offset % component_size == 0 && attribute.source_offset + attribute.components * component_size <= vertex_size);
+		assert(attribute.destination_offset % 4 == 0 && attribute.destination_offset + (oct ? 3 : attribute.components) * 4 <= destination_stride);
+	}
+
+#if defined(SIMD_SSE) || defined(SIMD_NEON)
+	assert(gDecodeBytesGroupInitialized);
+#endif
+
+	DequantizeContext context = {};
+	context.destination = static_cast<unsigned char*>(destination);
+	context.destination_stride = destination_stride;
+	context.vertex_size = vertex_size;
+	context.attributes = attributes;
+	context.attribute_count = attribute_count;
+	context.dequantize = gDequantizeAttribute ? gDequantizeAttribute : getDequantizeAttribute();
+
+	return decodeVertexBuffer(0, vertex_count, vertex_size, buffer, buffer_size, dequantizeBlock, &context);
+}
+
+int meshopt_decodeVertexBufferSplit(const meshopt_VertexOutput* outputs, size_t output_count, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= kVertexSizeMax);
+
+	for (size_t i = 0; i < output_count; ++i)
+	{
+		const meshopt_VertexOutput& output = outputs[i];
+		(void)output;
+
+		assert(output.size > 0 && output.offset + output.size <= vertex_size);
+		assert(output.stride >= output.size);
+	}
+
+#if defined(SIMD_SSE) || defined(SIMD_NEON)
+	assert(gDecodeBytesGroupInitialized);
+#endif
+
+	ScatterContext context = {};
+	context.vertex_size = vertex_size;
+	context.outputs = outputs;
+	context.output_count = output_count;
+
+	return decodeVertexBuffer(0, vertex_count, vertex_size, buffer, buffer_size, scatterBlock, &context);
+}
@@ -0,0 +1,474 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#include "meshoptimizer.h"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+// SSE2 is part of the x86-64 baseline, so unlike the vertex codec kernels the filters don't need runtime dispatch
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE
+#endif
+
+#ifdef SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+namespace meshopt
+{
+
+inline float copysign1(float v, float s)
+{
+	return s >= 0 ? v : -v;
+}
+
+inline int roundSigned(float v)
+{
+	// same rounding as the SIMD paths: round half away from zero
+	return int(v + (v >= 0 ? 0.5f : -0.5f));
+}
+
+inline float exp2i(int e)
+{
+	assert(e >= -126 && e <= 127);
+
+	union { unsigned int ui; float f; } u;
+	u.ui = unsigned(e + 127) << 23;
+
+	return u.f;
+}
+
+template <typename T>
+static void decodeOct(T* data, size_t count)
+{
+	const float max = float((1 << (sizeof(T) * 8 - 1)) - 1);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		// octahedral coordinates are stored with the scale of the encoding in the third component, so any bit count up to the storage size works
+		float x = float(data[i * 4 + 0]);
+		float y = float(data[i * 4 + 1]);
+		float one = float(data[i * 4 + 2]);
+
+		// unfold the lower hemisphere
+		float z = one - fabsf(x) - fabsf(y);
+		float t = z < 0 ? -z : 0;
+
+		x -= copysign1(t, x);
+		y -= copysign1(t, y);
+
+		float l = sqrtf(x * x + y * y + z * z);
+		float s = max / l;
+
+		data[i * 4 + 0] = T(roundSigned(x * s));
+		data[i * 4 + 1] = T(roundSigned(y * s));
+		data[i * 4 + 2] = T(roundSigned(z * s));
+	}
+}
+
+static void decodeQuat(short* data, size_t count)
+{
+	const float scale = 1.f / sqrtf(2.f);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		// the scale of the encoding has all low bits set, so the low 2 bits of the fourth component store the index of the largest component
+		int qc = data[i * 4 + 3] & 3;
+		float s = scale / float(data[i * 4 + 3] | 3);
+
+		float x = float(data[i * 4 + 0]) * s;
+		float y = float(data[i * 4 + 1]) * s;
+		float z = float(data[i * 4 + 2]) * s;
+
+		// largest component is reconstructed from unit length and is always positive
+		float ww = 1.f - x * x - y * y - z * z;
+		float w = sqrtf(ww >= 0.f ? ww : 0.f);
+
+		data[i * 4 + ((qc + 1) & 3)] = short(roundSigned(x * 32767.f));
+		data[i * 4 + ((qc + 2) & 3)] = short(roundSigned(y * 32767.f));
+		data[i * 4 + ((qc + 3) & 3)] = short(roundSigned(z * 32767.f));
+		data[i * 4 + qc] = short(roundSigned(w * 32767.f));
+	}
+}
+
+static void decodeExp(unsigned int* data, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		unsigned int v = data[i];
+
+		// 8-bit signed exponent in the top byte, 24-bit signed mantissa in the rest
+		int e = int(v) >> 24;
+		int m = int(v << 8) >> 8;
+
+		// construct 2^e directly in the exponent field; the encoder never produces exponents that aren't representable
+		union { float f; unsigned int ui; } s;
+		s.ui = unsigned(e + 127) << 23;
+
+		union { float f; unsigned int ui; } u;
+		u.f = float(m) * s.f;
+
+		data[i] = u.ui;
+	}
+}
+
+#ifdef SIMD_SSE
+static __m128 absSimd(__m128 v)
+{
+	return _mm_andnot_ps(_mm_set1_ps(-0.f), v);
+}
+
+static __m128 copysignSimd(__m128 v, __m128 s)
+{
+	return _mm_or_ps(absSimd(v), _mm_and_ps(s, _mm_set1_ps(-0.f)));
+}
+
+static __m128i roundSignedSimd(__m128 v)
+{
+	return _mm_cvttps_epi32(_mm_add_ps(v, copysignSimd(_mm_set1_ps(0.5f), v)));
+}
+
+static void decodeOctSimd(__m128& x, __m128& y, __m128& z, __m128 one, float max)
+{
+	z = _mm_sub_ps(_mm_sub_ps(one, absSimd(x)), absSimd(y));
+
+	__m128 t = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), z), _mm_setzero_ps());
+
+	x = _mm_sub_ps(x, copysignSimd(t, x));
+	y = _mm_sub_ps(y, copysignSimd(t, y));
+
+	__m128 l = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+	__m128 s = _mm_div_ps(_mm_set1_ps(max), l);
+
+	x = _mm_mul_ps(x, s);
+	y = _mm_mul_ps(y, s);
+	z = _mm_mul_ps(z, s);
+}
+
+static void decodeOct8Simd(signed char* data, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i n4 = _mm_loadu_si128(reinterpret_cast<__m128i*>(&data[i * 4]));
+
+		// sign-extend each of the 4 components
+		__m128 x = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(n4, 24), 24));
+		__m128 y = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(n4, 16), 24));
+		__m128 one = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(n4, 8), 24));
+		__m128 z;
+
+		decodeOctSimd(x, y, z, one, 127.f);
+
+		__m128i xr = _mm_and_si128(roundSignedSimd(x), _mm_set1_epi32(0xff));
+		__m128i yr = _mm_and_si128(roundSignedSimd(y), _mm_set1_epi32(0xff));
+		__m128i zr = _mm_and_si128(roundSignedSimd(z), _mm_set1_epi32(0xff));
+
+		// fourth component is preserved
+		__m128i res = _mm_or_si128(_mm_and_si128(n4, _mm_set1_epi32(0xff000000)), _mm_or_si128(xr, _mm_or_si128(_mm_slli_epi32(yr, 8), _mm_slli_epi32(zr, 16))));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&data[i * 4]), res);
+	}
+
+	decodeOct(data + i * 4, count - i);
+}
+
+static void loadShort4x4(const short* data, __m128i& xy, __m128i& zw)
+{
+	// each vertex has 2 dwords, xy and zw; split them into separate registers
+	__m128 n4_0 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&data[0])));
+	__m128 n4_1 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&data[8])));
+
+	xy = _mm_castps_si128(_mm_shuffle_ps(n4_0, n4_1, _MM_SHUFFLE(2, 0, 2, 0)));
+	zw = _mm_castps_si128(_mm_shuffle_ps(n4_0, n4_1, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+static void storeShort4x4(short* data, __m128i xy, __m128i zw)
+{
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&data[0]), _mm_unpacklo_epi32(xy, zw));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&data[8]), _mm_unpackhi_epi32(xy, zw));
+}
+
+static __m128i packShort2(__m128i lo, __m128i hi)
+{
+	return _mm_or_si128(_mm_and_si128(lo, _mm_set1_epi32(0xffff)), _mm_slli_epi32(hi, 16));
+}
+
+static void decodeOct16Simd(short* data, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i xy, zw;
+		loadShort4x4(&data[i * 4], xy, zw);
+
+		__m128 x = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(xy, 16), 16));
+		__m128 y = _mm_cvtepi32_ps(_mm_srai_epi32(xy, 16));
+		__m128 one = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(zw, 16), 16));
+		__m128 z;
+
+		decodeOctSimd(x, y, z, one, 32767.f);
+
+		// fourth component is preserved
+		__m128i xyr = packShort2(roundSignedSimd(x), roundSignedSimd(y));
+		__m128i zwr = _mm_or_si128(_mm_and_si128(roundSignedSimd(z), _mm_set1_epi32(0xffff)), _mm_and_si128(zw, _mm_set1_epi32(0xffff0000)));
+
+		storeShort4x4(&data[i * 4], xyr, zwr);
+	}
+
+	decodeOct(data + i * 4, count - i);
+}
+
+static void decodeQuatSimd(short* data, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i xy, zw;
+		loadShort4x4(&data[i * 4], xy, zw);
+
+		__m128i wi = _mm_srai_epi32(zw, 16);
+		__m128i qc = _mm_and_si128(wi, _mm_set1_epi32(3));
+
+		__m128 s = _mm_div_ps(_mm_set1_ps(1.f / sqrtf(2.f)), _mm_cvtepi32_ps(_mm_or_si128(wi, _mm_set1_epi32(3))));
+
+		__m128 x = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(xy, 16), 16)), s);
+		__m128 y = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(xy, 16)), s);
+		__m128 z = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(zw, 16), 16)), s);
+
+		__m128 ww = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1.f), _mm_mul_ps(x, x)), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		__m128 w = _mm_sqrt_ps(_mm_max_ps(ww, _mm_setzero_ps()));
+
+		__m128i xr = roundSignedSimd(_mm_mul_ps(x, _mm_set1_ps(32767.f)));
+		__m128i yr = roundSignedSimd(_mm_mul_ps(y, _mm_set1_ps(32767.f)));
+		__m128i zr = roundSignedSimd(_mm_mul_ps(z, _mm_set1_ps(32767.f)));
+		__m128i wr = roundSignedSimd(_mm_mul_ps(w, _mm_set1_ps(32767.f)));
+
+		// decoded components are rotated so that the largest component ends up at index qc
+		__m128i m0 = _mm_cmpeq_epi32(qc, _mm_setzero_si128());
+		__m128i m1 = _mm_cmpeq_epi32(qc, _mm_set1_epi32(1));
+		__m128i m2 = _mm_cmpeq_epi32(qc, _mm_set1_epi32(2));
+		__m128i m3 = _mm_cmpeq_epi32(qc, _mm_set1_epi32(3));
+
+#define SELECT(c0, c1, c2, c3) _mm_or_si128(_mm_or_si128(_mm_and_si128(m0, c0), _mm_and_si128(m1, c1)), _mm_or_si128(_mm_and_si128(m2, c2), _mm_and_si128(m3, c3)))
+
+		__m128i rx = SELECT(wr, zr, yr, xr);
+		__m128i ry = SELECT(xr, wr, zr, yr);
+		__m128i rz = SELECT(yr, xr, wr, zr);
+		__m128i rw = SELECT(zr, yr, xr, wr);
+
+#undef SELECT
+
+		storeShort4x4(&data[i * 4], packShort2(rx, ry), packShort2(rz, rw));
+	}
+
+	decodeQuat(data + i * 4, count - i);
+}
+
+static void decodeExpSimd(unsigned int* data, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<__m128i*>(&data[i]));
+
+		__m128i e = _mm_srai_epi32(v, 24);
+		__m128i m = _mm_srai_epi32(_mm_slli_epi32(v, 8), 8);
+
+		// construct 2^e directly in the exponent field
+		__m128 s = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(e, _mm_set1_epi32(127)), 23));
+		__m128 r = _mm_mul_ps(_mm_cvtepi32_ps(m), s);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&data[i]), _mm_castps_si128(r));
+	}
+
+	decodeExp(data + i, count - i);
+}
+#endif
+
+} // namespace meshopt
+
+void meshopt_decodeFilterOct(void* buffer, size_t count, size_t stride)
+{
+	using namespace meshopt;
+
+	assert(stride == 4 || stride == 8);
+
+#ifdef SIMD_SSE
+	if (stride == 4)
+		decodeOct8Simd(static_cast<signed char*>(buffer), count);
+	else
+		decodeOct16Simd(static_cast<short*>(buffer), count);
+#else
+	if (stride == 4)
+		decodeOct(static_cast<signed char*>(buffer), count);
+	else
+		decodeOct(static_cast<short*>(buffer), count);
+#endif
+}
+
+void meshopt_decodeFilterQuat(void* buffer, size_t count, size_t stride)
+{
+	using namespace meshopt;
+
+	assert(stride == 8);
+	(void)stride;
+
+#ifdef SIMD_SSE
+	decodeQuatSimd(static_cast<short*>(buffer), count);
+#else
+	decodeQuat(static_cast<short*>(buffer), count);
+#endif
+}
+
+void meshopt_decodeFilterExp(void* buffer, size_t count, size_t stride)
+{
+	using namespace meshopt;
+
+	assert(stride > 0 && stride % 4 == 0);
+
+	// each 32-bit value is decoded independently so the data can be processed as a flat array
+#ifdef SIMD_SSE
+	decodeExpSimd(static_cast<unsigned int*>(buffer), count * (stride / 4));
+#else
+	decodeExp(static_cast<unsigned int*>(buffer), count * (stride / 4));
+#endif
+}
+
+void meshopt_encodeFilterOct(void* destination, size_t count, size_t stride, int bits, const float* data)
+{
+	using namespace meshopt;
+
+	assert(stride == 4 || stride == 8);
+	assert(bits >= 2 && bits <= int(stride * 2));
+
+	signed char* d8 = static_cast<signed char*>(destination);
+	short* d16 = static_cast<short*>(destination);
+
+	int bytebits = int(stride * 2);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float* n = &data[i * 4];
+
+		// octahedral encoding of a unit vector
+		float nx = n[0], ny = n[1], nz = n[2], nw = n[3];
+		float nl = fabsf(nx) + fabsf(ny) + fabsf(nz);
+		float ns = nl == 0.f ? 0.f : 1.f / nl;
+
+		nx *= ns;
+		ny *= ns;
+
+		float u = (nz >= 0.f) ? nx : (1 - fabsf(ny)) * copysign1(1.f, nx);
+		float v = (nz >= 0.f) ? ny : (1 - fabsf(nx)) * copysign1(1.f, ny);
+
+		int fu = meshopt_quantizeSnorm(u, bits);
+		int fv = meshopt_quantizeSnorm(v, bits);
+		int fo = meshopt_quantizeSnorm(1.f, bits);
+		int fw = meshopt_quantizeSnorm(nw, bytebits);
+
+		if (stride == 4)
+		{
+			d8[i * 4 + 0] = (signed char)(fu);
+			d8[i * 4 + 1] = (signed char)(fv);
+			d8[i * 4 + 2] = (signed char)(fo);
+			d8[i * 4 + 3] = (signed char)(fw);
+		}
+		else
+		{
+			d16[i * 4 + 0] = short(fu);
+			d16[i * 4 + 1] = short(fv);
+			d16[i * 4 + 2] = short(fo);
+			d16[i * 4 + 3] = short(fw);
+		}
+	}
+}
+
+void meshopt_encodeFilterQuat(void* destination, size_t count, size_t stride, int bits, const float* data)
+{
+	using namespace meshopt;
+
+	assert(stride == 8);
+	assert(bits >= 4 && bits <= 16);
+	(void)stride;
+
+	short* d = static_cast<short*>(destination);
+
+	const float scaler = sqrtf(2.f);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float* q = &data[i * 4];
+
+		// smallest three: the largest component is dropped and reconstructed from the unit length constraint
+		int qc = 0;
+		qc = fabsf(q[1]) > fabsf(q[qc]) ? 1 : qc;
+		qc = fabsf(q[2]) > fabsf(q[qc]) ? 2 : qc;
+		qc = fabsf(q[3]) > fabsf(q[qc]) ? 3 : qc;
+
+		// q and -q represent the same rotation, so flip the sign to make sure the largest component is positive
+		float sign = q[qc] < 0.f ? -1.f : 1.f;
+
+		// remaining components are in [-1/sqrt(2), 1/sqrt(2)] range
+		int qa = meshopt_quantizeSnorm(q[(qc + 1) & 3] * scaler * sign, bits);
+		int qb = meshopt_quantizeSnorm(q[(qc + 2) & 3] * scaler * sign, bits);
+		int qd = meshopt_quantizeSnorm(q[(qc + 3) & 3] * scaler * sign, bits);
+
+		// scale of the encoding always has the low 2 bits set, which leaves room for the component index
+		int qs = meshopt_quantizeSnorm(1.f, bits);
+		assert((qs & 3) == 3);
+
+		d[i * 4 + 0] = short(qa);
+		d[i * 4 + 1] = short(qb);
+		d[i * 4 + 2] = short(qd);
+		d[i * 4 + 3] = short((qs & ~3) | qc);
+	}
+}
+
+void meshopt_encodeFilterExp(void* destination, size_t count, size_t stride, int bits, const float* data)
+{
+	using namespace meshopt;
+
+	assert(stride > 0 && stride % 4 == 0);
+	assert(bits >= 1 && bits <= 24);
+
+	unsigned int* d = static_cast<unsigned int*>(destination);
+	size_t stride_float = stride / sizeof(float);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float* v = &data[i * stride_float];
+		unsigned int* r = &d[i * stride_float];
+
+		// all components of a vector share the exponent of the largest component, so the mantissa precision is relative to the vector magnitude
+		int exp = -100;
+
+		for (size_t j = 0; j < stride_float; ++j)
+		{
+			int e = 0;
+			frexpf(v[j], &e);
+
+			exp = (v[j] != 0.f && e > exp) ? e : exp;
+		}
+
+		// mantissas have bits-1 magnitude bits; the exponent range keeps 2^exp representable as a normal float
+		exp -= bits - 1;
+		exp = exp < -100 ? -100 : exp > 100 ? 100 : exp;
+
+		const float mmax = float((1 << 23) - 1);
+
+		for (size_t j = 0; j < stride_float; ++j)
+		{
+			float m = v[j] * exp2i(-exp);
+
+			// rounding can push the largest component to 2^(bits-1), which only overflows the 24-bit mantissa field for bits=24; clamping also handles exponent range overflow
+			m = m < -mmax ? -mmax : m > mmax ? mmax : m;
+
+			r[j] = (unsigned(exp) << 24) | (unsigned(roundSigned(m)) & 0xffffff);
+		}
+	}
+}